@@ -0,0 +1,192 @@
+/* clock_gettime */
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "../../src/BinaryTree.h"
+#include "../../src/IntegerTree.h"
+#include "../../src/TypedBinaryTree.h"
+
+
+
+
+/**
+ * Number of lookups timed for each tree, the same whatever the size so that runs compare
+ */
+#define QUERIES 1000000
+
+
+DECLARE_BINARY_TREE(IntegerBinaryTree, int);
+DEFINE_BINARY_TREE(IntegerBinaryTree, int, COMPARE_NUMBERS);
+
+
+
+
+static unsigned long randomState = 88172645;
+
+
+/**
+ * @return - a pseudo-random number on 32 bits, the same sequence on every run
+ */
+static unsigned long nextRandom(void)
+{
+    randomState ^= (randomState << 13) & 0xFFFFFFFFUL;
+    randomState ^= randomState >> 17;
+    randomState ^= (randomState << 5) & 0xFFFFFFFFUL;
+    return randomState;
+}
+
+
+static double now(void)
+{
+    struct timespec instant;
+
+    clock_gettime(CLOCK_MONOTONIC, & instant);
+    return instant.tv_sec + instant.tv_nsec / 1e9;
+}
+
+
+static int compareKeys(void const * const current, void const * const other)
+{
+    int currentKey = * (int const *) current, otherKey = * (int const *) other;
+
+    return (currentKey > otherKey) - (currentKey < otherKey);
+}
+
+
+
+
+/**
+ * Prints the measure as a JSON line
+ */
+static void report(char const * const tree, unsigned long size, double seconds, unsigned long found)
+{
+    printf(
+        "{\"tree\": \"%s\", \"size\": %lu, \"queries\": %d, \"found\": %lu, \"opsPerSecond\": %.0f, \"nanosecondsPerFind\": %.1f}\n",
+        tree,
+        size,
+        QUERIES,
+        found,
+        QUERIES / seconds,
+        seconds * 1e9 / QUERIES
+    );
+    fflush(stdout);
+}
+
+
+/**
+ * Times the lookups of the queries in a tree of integer keys, comparing them the given way
+ */
+static int measureIntegerTree(
+    char const * const name,
+    int useVectorInstructions,
+    int const * const keys,
+    unsigned long size,
+    int const * const queries
+)
+{
+    _IntegerTree * tree;
+    unsigned long i, found = 0;
+    double start;
+
+    IntegerTree->useVectorInstructions(useVectorInstructions);
+    tree = IntegerTree->constructor();
+    if (tree == NULL)
+        return 0;
+
+    for (i = 0; i < size; i++)
+        if (! IntegerTree->add(tree, keys[i], & keys[i]))
+        {
+            IntegerTree->destructor(& tree);
+            return 0;
+        }
+
+    start = now();
+    for (i = 0; i < QUERIES; i++)
+        found += IntegerTree->find(tree, queries[i]) != NULL;
+    report(name, size, now() - start, found);
+
+    IntegerTree->destructor(& tree);
+
+    return 1;
+}
+
+
+
+
+/**
+ * Times the same random lookups, about half of them missing, in a binary tree comparing integers through a callback,
+ * then in one holding them inline and comparing them with a macro, then in trees of integer keys compared one by one and with vector instructions
+ *
+ * Usage: Integers <size>
+ */
+int main(int argc, char ** argv)
+{
+    _BinaryTree * tree;
+    _IntegerBinaryTree * typedTree;
+    int * keys, * queries;
+    unsigned long i, size, found = 0;
+    double start;
+
+    size = (argc == 2) ? strtoul(argv[1], NULL, 10) : 0;
+    if (size == 0)
+    {
+        fprintf(stderr, "Usage: %s <size>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    /* random keys, added in random order so that the binary tree stays shallow */
+    keys = malloc(size * sizeof(* keys));
+    queries = malloc(QUERIES * sizeof(* queries));
+    if ((keys == NULL) || (queries == NULL))
+    {
+        fprintf(stderr, "Allocation failed for %lu keys\n", size);
+        free(keys);
+        free(queries);
+        return EXIT_FAILURE;
+    }
+    for (i = 0; i < size; i++)
+        keys[i] = (int) (nextRandom() & 0x7FFFFFFFUL);
+    for (i = 0; i < QUERIES; i++)
+        queries[i] = (i % 2) ? (int) (nextRandom() & 0x7FFFFFFFUL) : keys[nextRandom() % size];
+
+    tree = BinaryTree->constructor(compareKeys);
+    if (tree != NULL)
+    {
+        for (i = 0; i < size; i++)
+            BinaryTree->add(tree, & keys[i]);
+
+        start = now();
+        for (i = 0; i < QUERIES; i++)
+            found += BinaryTree->find(tree, & queries[i]) != NULL;
+        report("BinaryTree", size, now() - start, found);
+
+        BinaryTree->destructor(& tree);
+    }
+
+    typedTree = IntegerBinaryTree->constructor();
+    if (typedTree != NULL)
+    {
+        for (i = 0; i < size; i++)
+            IntegerBinaryTree->add(typedTree, keys[i]);
+
+        found = 0;
+        start = now();
+        for (i = 0; i < QUERIES; i++)
+            found += IntegerBinaryTree->contains(typedTree, queries[i]);
+        report("IntegerBinaryTree", size, now() - start, found);
+
+        IntegerBinaryTree->destructor(& typedTree);
+    }
+
+    if (! measureIntegerTree("IntegerTreeOneByOne", 0, keys, size, queries)
+        || ! measureIntegerTree("IntegerTreeVector", 1, keys, size, queries))
+        fprintf(stderr, "Allocation failed for a tree of %lu keys\n", size);
+
+    free(keys);
+    free(queries);
+
+    return EXIT_SUCCESS;
+}
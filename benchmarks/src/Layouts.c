@@ -0,0 +1,167 @@
+/* clock_gettime */
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "../../src/BinaryTree.h"
+#include "../../src/BalancedBinaryTree.h"
+#include "../../src/FrozenTree.h"
+
+
+
+
+/**
+ * Number of lookups timed for each layout, the same whatever the size so that runs compare
+ */
+#define QUERIES 1000000
+
+
+
+
+static unsigned long randomState = 88172645;
+
+
+/**
+ * @return - a pseudo-random number on 32 bits, the same sequence on every run
+ */
+static unsigned long nextRandom(void)
+{
+    randomState ^= (randomState << 13) & 0xFFFFFFFFUL;
+    randomState ^= randomState >> 17;
+    randomState ^= (randomState << 5) & 0xFFFFFFFFUL;
+    return randomState;
+}
+
+
+static double now(void)
+{
+    struct timespec instant;
+
+    clock_gettime(CLOCK_MONOTONIC, & instant);
+    return instant.tv_sec + instant.tv_nsec / 1e9;
+}
+
+
+static int compareKeys(void const * const current, void const * const other)
+{
+    long currentKey = * (long const *) current, otherKey = * (long const *) other;
+
+    return (currentKey > otherKey) - (currentKey < otherKey);
+}
+
+
+
+
+/**
+ * Prints the measure as a JSON line
+ */
+static void report(char const * const layout, unsigned long size, double seconds, unsigned long found)
+{
+    printf(
+        "{\"layout\": \"%s\", \"size\": %lu, \"queries\": %d, \"found\": %lu, \"opsPerSecond\": %.0f, \"nanosecondsPerFind\": %.1f}\n",
+        layout,
+        size,
+        QUERIES,
+        found,
+        QUERIES / seconds,
+        seconds * 1e9 / QUERIES
+    );
+    fflush(stdout);
+}
+
+
+/**
+ * Times the lookups of the queries in a snapshot laid out the given way
+ */
+static int measureFrozenTree(
+    char const * const name,
+    FrozenTreeLayout layout,
+    void const * const * const values,
+    unsigned long size,
+    long const * const queries
+)
+{
+    _FrozenTree * tree = FrozenTree->constructor(compareKeys, values, size, layout);
+    unsigned long i, found = 0;
+    double start;
+
+    if (tree == NULL)
+        return 0;
+
+    start = now();
+    for (i = 0; i < QUERIES; i++)
+        found += FrozenTree->find(tree, & queries[i]) != NULL;
+    report(name, size, now() - start, found);
+
+    FrozenTree->destructor(& tree);
+
+    return 1;
+}
+
+
+
+
+/**
+ * Times the same random lookups, half of them missing, in a balanced tree of nodes,
+ * then in snapshots laid out breadth-first and in van Emde Boas order, built one after the other
+ *
+ * Usage: Layouts <size>
+ */
+int main(int argc, char ** argv)
+{
+    _BalancedBinaryTree * tree;
+    void const ** values;
+    long * keys, * queries;
+    unsigned long i, size, found = 0;
+    double start;
+
+    size = (argc == 2) ? strtoul(argv[1], NULL, 10) : 0;
+    if (size == 0)
+    {
+        fprintf(stderr, "Usage: %s <size>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    /* even keys, so that odd queries miss */
+    keys = malloc(size * sizeof(* keys));
+    values = malloc(size * sizeof(* values));
+    queries = malloc(QUERIES * sizeof(* queries));
+    if ((keys == NULL) || (values == NULL) || (queries == NULL))
+    {
+        fprintf(stderr, "Allocation failed for %lu keys\n", size);
+        free(keys);
+        free(values);
+        free(queries);
+        return EXIT_FAILURE;
+    }
+    for (i = 0; i < size; i++)
+    {
+        keys[i] = 2 * i;
+        values[i] = & keys[i];
+    }
+    for (i = 0; i < QUERIES; i++)
+        queries[i] = (long) (((nextRandom() << 16) ^ nextRandom()) % (2 * size));
+
+    tree = BalancedBinaryTree->sortedConstructor(compareKeys, values, size);
+    if (tree != NULL)
+    {
+        start = now();
+        for (i = 0; i < QUERIES; i++)
+            found += BalancedBinaryTree->find(tree, & queries[i]) != NULL;
+        report("pointers", size, now() - start, found);
+
+        BalancedBinaryTree->destructor(& tree);
+    }
+
+    if (! measureFrozenTree("breadthFirst", BreadthFirstLayout, values, size, queries)
+        || ! measureFrozenTree("vanEmdeBoas", VanEmdeBoasLayout, values, size, queries))
+        fprintf(stderr, "Allocation failed for a snapshot of %lu keys\n", size);
+
+    free(keys);
+    free(values);
+    free(queries);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,649 @@
+/* clock_gettime and getrusage */
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <sys/resource.h>
+
+#include "../../src/BinaryTree.h"
+#include "../../src/BalancedBinaryTree.h"
+#include "../../src/BTree.h"
+#include "../../src/CompactTree.h"
+
+
+
+
+/**
+ * Greatest number of operations timed one by one, to compute percentiles
+ */
+#define LATENCY_SAMPLES 10000
+
+
+/**
+ * Sorted streams turn a binary tree into a chain, past this size it would take hours
+ */
+#define SORTED_SIZE_LIMIT 20000
+
+
+/**
+ * Zipf streams repeat the most frequent keys, which chain in a binary tree as equal values go right
+ */
+#define ZIPF_SIZE_LIMIT 100000
+
+
+/**
+ * Exponent of the Zipf distribution, the probability of the k-th key is proportional to 1 / k^s
+ */
+#define ZIPF_EXPONENT 1.0
+
+
+/**
+ * Number of keys looked up by each call to findMany
+ */
+#define FIND_MANY_BATCH 1024
+
+
+/**
+ * The operations of a tree, hiding its type, findMany and freeze being NULL for trees lacking them
+ */
+typedef struct
+{
+    char const * name;
+    void * (* constructor)(int (* compare)(void const * const, void const * const));
+    void (* destructor)(void ** tree);
+    void const * (* add)(void * const tree, void const * const value);
+    void const * (* find)(void * const tree, void const * const value);
+    unsigned int (* findMany)(void * const tree, void const * const * const values, unsigned int count, void ** const results);
+    void const * (* pop)(void * const tree, void const * const value);
+    void (* map)(void const * const tree, void (* callback)(void const * const value));
+    _FrozenTree * (* freeze)(void const * const tree, FrozenTreeLayout layout);
+} TreeOperations;
+
+
+/**
+ * Measures of one operation repeated over the whole stream
+ */
+typedef struct
+{
+    unsigned long operations;
+    double seconds;
+    unsigned long samples;
+    double sampledNanoseconds[LATENCY_SAMPLES];
+} Measure;
+
+
+
+
+static void * binaryTreeConstructor(int (* compare)(void const * const, void const * const))
+{
+    return BinaryTree->constructor(compare);
+}
+
+
+static void binaryTreeDestructor(void ** tree)
+{
+    BinaryTree->destructor((_BinaryTree **) tree);
+}
+
+
+static void const * binaryTreeAdd(void * const tree, void const * const value)
+{
+    return BinaryTree->add(tree, value);
+}
+
+
+static void const * binaryTreeFind(void * const tree, void const * const value)
+{
+    return BinaryTree->find(tree, value);
+}
+
+
+static unsigned int binaryTreeFindMany(
+    void * const tree,
+    void const * const * const values,
+    unsigned int count,
+    void ** const results
+)
+{
+    return BinaryTree->findMany(tree, values, count, (_BinaryTreeNode **) results);
+}
+
+
+static void const * binaryTreePop(void * const tree, void const * const value)
+{
+    return BinaryTree->pop(tree, value);
+}
+
+
+static void binaryTreeMap(void const * const tree, void (* callback)(void const * const value))
+{
+    BinaryTree->map(tree, callback, InOrder);
+}
+
+
+static _FrozenTree * binaryTreeFreeze(void const * const tree, FrozenTreeLayout layout)
+{
+    return BinaryTree->freeze(tree, layout);
+}
+
+
+static void * balancedBinaryTreeConstructor(int (* compare)(void const * const, void const * const))
+{
+    return BalancedBinaryTree->constructor(compare);
+}
+
+
+static void balancedBinaryTreeDestructor(void ** tree)
+{
+    BalancedBinaryTree->destructor((_BalancedBinaryTree **) tree);
+}
+
+
+static void const * balancedBinaryTreeAdd(void * const tree, void const * const value)
+{
+    return BalancedBinaryTree->add(tree, value);
+}
+
+
+static void const * balancedBinaryTreeFind(void * const tree, void const * const value)
+{
+    return BalancedBinaryTree->find(tree, value);
+}
+
+
+static unsigned int balancedBinaryTreeFindMany(
+    void * const tree,
+    void const * const * const values,
+    unsigned int count,
+    void ** const results
+)
+{
+    return BalancedBinaryTree->findMany(tree, values, count, (_BalancedBinaryTreeNode **) results);
+}
+
+
+static void const * balancedBinaryTreePop(void * const tree, void const * const value)
+{
+    return BalancedBinaryTree->pop(tree, value);
+}
+
+
+static void balancedBinaryTreeMap(void const * const tree, void (* callback)(void const * const value))
+{
+    BalancedBinaryTree->map(tree, callback, InOrder);
+}
+
+
+static _FrozenTree * balancedBinaryTreeFreeze(void const * const tree, FrozenTreeLayout layout)
+{
+    return BalancedBinaryTree->freeze(tree, layout);
+}
+
+
+static void * bTreeConstructor(int (* compare)(void const * const, void const * const))
+{
+    return BTree->constructor(compare);
+}
+
+
+static void bTreeDestructor(void ** tree)
+{
+    BTree->destructor((_BTree **) tree);
+}
+
+
+static void const * bTreeAdd(void * const tree, void const * const value)
+{
+    return BTree->add(tree, value);
+}
+
+
+static void const * bTreeFind(void * const tree, void const * const value)
+{
+    return BTree->find(tree, value);
+}
+
+
+static void const * bTreePop(void * const tree, void const * const value)
+{
+    return BTree->pop(tree, value);
+}
+
+
+static void bTreeMap(void const * const tree, void (* callback)(void const * const value))
+{
+    BTree->map(tree, callback);
+}
+
+
+static void * compactTreeConstructor(int (* compare)(void const * const, void const * const))
+{
+    return CompactTree->constructor(compare);
+}
+
+
+static void compactTreeDestructor(void ** tree)
+{
+    CompactTree->destructor((_CompactTree **) tree);
+}
+
+
+static void const * compactTreeAdd(void * const tree, void const * const value)
+{
+    return (CompactTree->add(tree, value) != 0) ? value : NULL;
+}
+
+
+static void const * compactTreeFind(void * const tree, void const * const value)
+{
+    return CompactTree->value(tree, CompactTree->find(tree, value));
+}
+
+
+static void const * compactTreePop(void * const tree, void const * const value)
+{
+    return CompactTree->pop(tree, value);
+}
+
+
+static void compactTreeMap(void const * const tree, void (* callback)(void const * const value))
+{
+    CompactTree->map(tree, callback);
+}
+
+
+static void const * frozenTreeFind(void * const tree, void const * const value)
+{
+    return FrozenTree->find(tree, value);
+}
+
+
+static TreeOperations const trees[] = {
+    {
+        "BinaryTree",
+        binaryTreeConstructor,
+        binaryTreeDestructor,
+        binaryTreeAdd,
+        binaryTreeFind,
+        binaryTreeFindMany,
+        binaryTreePop,
+        binaryTreeMap,
+        binaryTreeFreeze
+    },
+    {
+        "BalancedBinaryTree",
+        balancedBinaryTreeConstructor,
+        balancedBinaryTreeDestructor,
+        balancedBinaryTreeAdd,
+        balancedBinaryTreeFind,
+        balancedBinaryTreeFindMany,
+        balancedBinaryTreePop,
+        balancedBinaryTreeMap,
+        balancedBinaryTreeFreeze
+    },
+    {
+        "BTree",
+        bTreeConstructor,
+        bTreeDestructor,
+        bTreeAdd,
+        bTreeFind,
+        NULL,
+        bTreePop,
+        bTreeMap,
+        NULL
+    },
+    {
+        "CompactTree",
+        compactTreeConstructor,
+        compactTreeDestructor,
+        compactTreeAdd,
+        compactTreeFind,
+        NULL,
+        compactTreePop,
+        compactTreeMap,
+        NULL
+    }
+};
+
+
+
+
+static unsigned long randomState = 88172645;
+
+
+/**
+ * @return - a pseudo-random number on 32 bits, the same sequence on every run
+ */
+static unsigned long nextRandom(void)
+{
+    randomState ^= (randomState << 13) & 0xFFFFFFFFUL;
+    randomState ^= randomState >> 17;
+    randomState ^= (randomState << 5) & 0xFFFFFFFFUL;
+    return randomState;
+}
+
+
+static double now(void)
+{
+    struct timespec instant;
+
+    clock_gettime(CLOCK_MONOTONIC, & instant);
+    return instant.tv_sec + instant.tv_nsec / 1e9;
+}
+
+
+static long peakResidentKilobytes(void)
+{
+    struct rusage usage;
+
+    getrusage(RUSAGE_SELF, & usage);
+    return usage.ru_maxrss;
+}
+
+
+static int compareKeys(void const * const current, void const * const other)
+{
+    long currentKey = * (long const *) current, otherKey = * (long const *) other;
+
+    return (currentKey > otherKey) - (currentKey < otherKey);
+}
+
+
+static int compareNanoseconds(void const * const current, void const * const other)
+{
+    double currentTime = * (double const *) current, otherTime = * (double const *) other;
+
+    return (currentTime > otherTime) - (currentTime < otherTime);
+}
+
+
+static unsigned long mappedValues;
+
+
+static void countMappedValue(void const * const value)
+{
+    (void) value;
+    mappedValues++;
+}
+
+
+
+
+/**
+ * Fills the keys, in the order they will be added
+ *
+ * @return - 1 if the stream exists, 0 otherwise
+ */
+static int fillStream(char const * const stream, long * const keys, unsigned long size)
+{
+    double * cumulated, total = 0;
+    unsigned long i, lowest, highest, middle;
+    double drawn;
+
+    if (strcmp(stream, "sorted") == 0)
+        for (i = 0; i < size; i++)
+            keys[i] = i;
+    else if (strcmp(stream, "reverse") == 0)
+        for (i = 0; i < size; i++)
+            keys[i] = size - i;
+    else if (strcmp(stream, "uniform") == 0)
+        for (i = 0; i < size; i++)
+            keys[i] = nextRandom();
+    else if (strcmp(stream, "zipf") == 0)
+    {
+        /* draws ranks by bisecting the cumulated distribution, rank 0 being the most frequent */
+        cumulated = malloc(size * sizeof(* cumulated));
+        if (cumulated == NULL)
+            return 0;
+        for (i = 0; i < size; i++)
+        {
+            total += 1 / pow(i + 1, ZIPF_EXPONENT);
+            cumulated[i] = total;
+        }
+
+        for (i = 0; i < size; i++)
+        {
+            drawn = total * nextRandom() / 4294967296.0;
+            lowest = 0;
+            highest = size - 1;
+            while (lowest < highest)
+            {
+                middle = lowest + (highest - lowest) / 2;
+                if (cumulated[middle] <= drawn)
+                    lowest = middle + 1;
+                else
+                    highest = middle;
+            }
+            keys[i] = lowest;
+        }
+
+        free(cumulated);
+    }
+    else
+        return 0;
+
+    return 1;
+}
+
+
+/**
+ * @return - the greatest size a binary tree fed with the stream is measured at
+ */
+static unsigned long binaryTreeSizeLimit(char const * const stream)
+{
+    if ((strcmp(stream, "sorted") == 0) || (strcmp(stream, "reverse") == 0))
+        return SORTED_SIZE_LIMIT;
+    if (strcmp(stream, "zipf") == 0)
+        return ZIPF_SIZE_LIMIT;
+    return (unsigned long) -1;
+}
+
+
+/**
+ * Applies the operation on every key, timing one operation out of each stride
+ */
+static void measureOperation(
+    Measure * const this,
+    void const * (* operation)(void * const tree, void const * const value),
+    void * const tree,
+    long const * const keys,
+    unsigned long size
+)
+{
+    unsigned long i, stride = 1 + size / LATENCY_SAMPLES;
+    double start, operationStart;
+
+    this->operations = size;
+    this->samples = 0;
+
+    start = now();
+    for (i = 0; i < size; i++)
+    {
+        if (i % stride != 0)
+        {
+            operation(tree, & keys[i]);
+            continue;
+        }
+
+        operationStart = now();
+        operation(tree, & keys[i]);
+        this->sampledNanoseconds[this->samples++] = (now() - operationStart) * 1e9;
+    }
+    this->seconds = now() - start;
+}
+
+
+/**
+ * Looks up every key through findMany, by batches, timing one batch out of each stride
+ * and sharing its time between its keys
+ */
+static void measureFindMany(
+    Measure * const this,
+    TreeOperations const * const operations,
+    void * const tree,
+    long const * const keys,
+    unsigned long size
+)
+{
+    static void const * values[FIND_MANY_BATCH];
+    static void * results[FIND_MANY_BATCH];
+    unsigned long first, i, batches = 0, stride = 1 + size / FIND_MANY_BATCH / LATENCY_SAMPLES;
+    unsigned int count;
+    double start, batchStart;
+
+    this->operations = size;
+    this->samples = 0;
+
+    start = now();
+    for (first = 0; first < size; first += count, batches++)
+    {
+        count = (size - first < FIND_MANY_BATCH) ? size - first : FIND_MANY_BATCH;
+        for (i = 0; i < count; i++)
+            values[i] = & keys[first + i];
+
+        if (batches % stride != 0)
+        {
+            operations->findMany(tree, values, count, results);
+            continue;
+        }
+
+        batchStart = now();
+        operations->findMany(tree, values, count, results);
+        this->sampledNanoseconds[this->samples++] = (now() - batchStart) * 1e9 / count;
+    }
+    this->seconds = now() - start;
+}
+
+
+/**
+ * Prints the measure as a JSON line
+ */
+static void report(
+    char const * const tree,
+    char const * const stream,
+    unsigned long size,
+    char const * const operation,
+    Measure * const measured
+)
+{
+    printf(
+        "{\"tree\": \"%s\", \"stream\": \"%s\", \"size\": %lu, \"operation\": \"%s\", \"opsPerSecond\": %.0f",
+        tree,
+        stream,
+        size,
+        operation,
+        measured->operations / measured->seconds
+    );
+
+    if (measured->samples == 0)
+        printf(", \"p50Nanoseconds\": null, \"p99Nanoseconds\": null");
+    else
+    {
+        qsort(measured->sampledNanoseconds, measured->samples, sizeof(double), compareNanoseconds);
+        printf(
+            ", \"p50Nanoseconds\": %.0f, \"p99Nanoseconds\": %.0f",
+            measured->sampledNanoseconds[measured->samples / 2],
+            measured->sampledNanoseconds[measured->samples * 99 / 100]
+        );
+    }
+
+    printf(", \"peakRssKilobytes\": %ld}\n", peakResidentKilobytes());
+    fflush(stdout);
+}
+
+
+
+
+/**
+ * Runs add, find, findMany, find on a frozen snapshot, map and pop on one kind of tree, fed with one stream of keys,
+ * and prints a JSON line for each operation
+ *
+ * Usage: Trees <BinaryTree|BalancedBinaryTree|BTree|CompactTree> <sorted|reverse|uniform|zipf> <size>
+ */
+int main(int argc, char ** argv)
+{
+    TreeOperations const * operations = NULL;
+    static Measure measured;
+    void * tree;
+    _FrozenTree * frozen;
+    long * keys;
+    unsigned long i, size;
+    double start;
+
+    if (argc != 4)
+    {
+        fprintf(stderr, "Usage: %s <BinaryTree|BalancedBinaryTree|BTree|CompactTree> <sorted|reverse|uniform|zipf> <size>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    for (i = 0; i < sizeof(trees) / sizeof(* trees); i++)
+        if (strcmp(trees[i].name, argv[1]) == 0)
+            operations = & trees[i];
+    size = strtoul(argv[3], NULL, 10);
+
+    if ((operations == NULL) || (size == 0))
+    {
+        fprintf(stderr, "Unknown tree %s, or empty size %s\n", argv[1], argv[3]);
+        return EXIT_FAILURE;
+    }
+
+    if ((operations->add == binaryTreeAdd) && (size > binaryTreeSizeLimit(argv[2])))
+    {
+        fprintf(stderr, "Skipping %s with %s stream of %lu keys, it would degenerate into a chain\n", argv[1], argv[2], size);
+        return EXIT_SUCCESS;
+    }
+
+    keys = malloc(size * sizeof(* keys));
+    if ((keys == NULL) || ! fillStream(argv[2], keys, size))
+    {
+        fprintf(stderr, "Unknown stream %s, or allocation failed\n", argv[2]);
+        free(keys);
+        return EXIT_FAILURE;
+    }
+
+    tree = operations->constructor(compareKeys);
+    if (tree == NULL)
+    {
+        free(keys);
+        return EXIT_FAILURE;
+    }
+
+    measureOperation(& measured, operations->add, tree, keys, size);
+    report(argv[1], argv[2], size, "add", & measured);
+
+    measureOperation(& measured, operations->find, tree, keys, size);
+    report(argv[1], argv[2], size, "find", & measured);
+
+    if (operations->findMany != NULL)
+    {
+        measureFindMany(& measured, operations, tree, keys, size);
+        report(argv[1], argv[2], size, "findMany", & measured);
+    }
+
+    frozen = (operations->freeze == NULL) ? NULL : operations->freeze(tree, BreadthFirstLayout);
+    if (frozen != NULL)
+    {
+        measureOperation(& measured, frozenTreeFind, frozen, keys, size);
+        report(argv[1], argv[2], size, "frozenFind", & measured);
+        FrozenTree->destructor(& frozen);
+    }
+
+    mappedValues = 0;
+    start = now();
+    operations->map(tree, countMappedValue);
+    measured.seconds = now() - start;
+    measured.operations = mappedValues;
+    measured.samples = 0;
+    report(argv[1], argv[2], size, "map", & measured);
+
+    measureOperation(& measured, operations->pop, tree, keys, size);
+    report(argv[1], argv[2], size, "pop", & measured);
+
+    operations->destructor(& tree);
+    free(keys);
+
+    return EXIT_SUCCESS;
+}
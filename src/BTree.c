@@ -0,0 +1,607 @@
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "Class.h"
+#include "BTree.h"
+
+
+
+
+/**
+ * Least number of sons of a node other than the top-most one, which holds one value less
+ */
+#define B_TREE_MINIMUM_SONS 8
+
+
+/**
+ * Greatest number of values of a node
+ */
+#define B_TREE_VALUES (2 * B_TREE_MINIMUM_SONS - 1)
+
+
+typedef struct _BTreeNode _BTreeNode;
+
+
+struct _BTree
+{
+    _BTreeNode * root;
+    int (* compare)(void const * const currentValue, void const * const otherValue);
+    unsigned int size;
+};
+
+
+/**
+ * Values come first, so that along with the count they fill exactly two cache lines,
+ * bottom-most nodes have no sons and are allocated without them
+ */
+struct _BTreeNode
+{
+    void const * values[B_TREE_VALUES];
+    unsigned int count;
+    int isLeaf;
+    _BTreeNode * sons[B_TREE_VALUES + 1];
+};
+
+
+
+
+/**
+ * @param isLeaf - 1 for a bottom-most node, allocated without sons, 0 otherwise
+ *
+ * @return - a node without values, or NULL if allocation failed
+ */
+static _BTreeNode * constructNode(int isLeaf);
+
+
+static void deleteNode(_BTreeNode ** node);
+
+
+/**
+ * Deletes the node along with the nodes below it,
+ * recursion goes as deep as the tree is high, which is logarithmic
+ */
+static void destroyBranch(_BTreeNode ** node);
+
+
+/**
+ * @return - the index of the first value of the node which isn't lesser than the given one
+ */
+static unsigned int lowerBound(_BTree const * const this, _BTreeNode const * const node, void const * const value);
+
+
+/**
+ * @return - the index of the first value of the node which is greater than the given one
+ */
+static unsigned int upperBound(_BTree const * const this, _BTreeNode const * const node, void const * const value);
+
+
+/**
+ * Splits the full son in two halves, its middle value going up into the node
+ *
+ * @param index - the index of the son to split
+ *
+ * @return - 1 if the son was split, 0 if allocation failed
+ */
+static int splitSon(_BTreeNode * const node, unsigned int index);
+
+
+/**
+ * Merges the son with its right brother, and the value between them
+ *
+ * @param index - the index of the left son
+ */
+static void mergeSons(_BTreeNode * const node, unsigned int index);
+
+
+/**
+ * Makes sure the son holds more than the least number of values, so that one can be popped below it,
+ * by taking one from a brother, or by merging with one
+ *
+ * @param index - the index of the son to fill
+ *
+ * @return - the index of the son holding the values which were below the given one
+ */
+static unsigned int fillSon(_BTreeNode * const node, unsigned int index);
+
+
+/**
+ * Removes the greatest value below the node, which holds more than the least number of values
+ *
+ * @return - the removed value
+ */
+static void const * popGreatest(_BTreeNode * node);
+
+
+/**
+ * Removes the smallest value below the node, which holds more than the least number of values
+ *
+ * @return - the removed value
+ */
+static void const * popSmallest(_BTreeNode * node);
+
+
+/**
+ * Applies the callback on every value below the node, in order,
+ * recursion goes as deep as the tree is high, which is logarithmic
+ */
+static void mapBranch(_BTreeNode const * const node, void (* callback)(void const * const value));
+
+
+
+
+static _BTree * constructor(int (* compareValuesCallback)(void const * const currentValue, void const * const otherValue))
+{
+    _BTree * this = Class->constructor("BTree", sizeof(* this));
+
+    if (this == NULL)
+        return NULL;
+
+    this->root = NULL;
+    this->compare = compareValuesCallback;
+    this->size = 0;
+
+    return this;
+}
+
+
+static void destructor(_BTree ** this)
+{
+    if ((this == NULL) || (* this == NULL))
+        return;
+
+    destroyBranch(& (* this)->root);
+    Class->destructor("BTree", (void **) this);
+}
+
+
+static void const * find(_BTree const * const this, void const * const value)
+{
+    _BTreeNode const * node;
+    unsigned int index;
+
+    if (this == NULL)
+        return NULL;
+
+    for (node = this->root; node != NULL; node = node->sons[index])
+    {
+        index = lowerBound(this, node, value);
+        if ((index < node->count) && (this->compare(node->values[index], value) == 0))
+            return node->values[index];
+        if (node->isLeaf)
+            return NULL;
+    }
+
+    return NULL;
+}
+
+
+static int contains(_BTree const * const this, void const * const value)
+{
+    return find(this, value) != NULL;
+}
+
+
+static void const * add(_BTree * const this, void const * const value)
+{
+    _BTreeNode * node, * root;
+    unsigned int index;
+
+    if (this == NULL)
+        return NULL;
+
+    if (this->root == NULL)
+    {
+        this->root = constructNode(1);
+        if (this->root == NULL)
+            return NULL;
+    }
+
+    /* the tree grows from the top, full nodes are split on the way down so that there is room left below */
+    if (this->root->count == B_TREE_VALUES)
+    {
+        root = constructNode(0);
+        if (root == NULL)
+            return NULL;
+
+        root->sons[0] = this->root;
+        if (! splitSon(root, 0))
+        {
+            deleteNode(& root);
+            return NULL;
+        }
+        this->root = root;
+    }
+
+    node = this->root;
+    for (;;)
+    {
+        index = upperBound(this, node, value);
+        if (node->isLeaf)
+            break;
+
+        if (node->sons[index]->count == B_TREE_VALUES)
+        {
+            if (! splitSon(node, index))
+                return NULL;
+            if (this->compare(node->values[index], value) <= 0)
+                index++;
+        }
+        node = node->sons[index];
+    }
+
+    memmove(node->values + index + 1, node->values + index, (node->count - index) * sizeof(* node->values));
+    node->values[index] = value;
+    node->count++;
+    this->size++;
+
+    return value;
+}
+
+
+static unsigned int size(_BTree const * const this)
+{
+    if (this == NULL)
+        return 0;
+
+    return this->size;
+}
+
+
+static void const * min(_BTree const * const this)
+{
+    _BTreeNode const * node;
+
+    if ((this == NULL) || (this->root == NULL) || (this->root->count == 0))
+        return NULL;
+
+    for (node = this->root; ! node->isLeaf; node = node->sons[0])
+        ;
+
+    return node->values[0];
+}
+
+
+static void const * max(_BTree const * const this)
+{
+    _BTreeNode const * node;
+
+    if ((this == NULL) || (this->root == NULL) || (this->root->count == 0))
+        return NULL;
+
+    for (node = this->root; ! node->isLeaf; node = node->sons[node->count])
+        ;
+
+    return node->values[node->count - 1];
+}
+
+
+static unsigned int height(_BTree const * const this)
+{
+    _BTreeNode const * node;
+    unsigned int height = 0;
+
+    if (this == NULL)
+        return 0;
+
+    for (node = this->root; node != NULL; node = node->isLeaf ? NULL : node->sons[0])
+        height++;
+
+    return height;
+}
+
+
+static void const * pop(_BTree * const this, void const * const value)
+{
+    _BTreeNode * node, * emptyRoot;
+    void const * popped = NULL;
+    int found = 0;
+    unsigned int index;
+
+    if ((this == NULL) || (this->root == NULL))
+        return NULL;
+
+    /* sons are filled on the way down, so that removing a value below them never leaves them too small */
+    node = this->root;
+    for (;;)
+    {
+        index = lowerBound(this, node, value);
+
+        if ((index < node->count) && (this->compare(node->values[index], value) == 0))
+        {
+            found = 1;
+            popped = node->values[index];
+
+            if (node->isLeaf)
+            {
+                node->count--;
+                memmove(node->values + index, node->values + index + 1, (node->count - index) * sizeof(* node->values));
+                break;
+            }
+
+            /* the value is replaced by its closest one below, or both sons are merged around it */
+            if (node->sons[index]->count >= B_TREE_MINIMUM_SONS)
+            {
+                node->values[index] = popGreatest(node->sons[index]);
+                break;
+            }
+            if (node->sons[index + 1]->count >= B_TREE_MINIMUM_SONS)
+            {
+                node->values[index] = popSmallest(node->sons[index + 1]);
+                break;
+            }
+
+            mergeSons(node, index);
+            node = node->sons[index];
+            continue;
+        }
+
+        if (node->isLeaf)
+            break;
+
+        node = node->sons[fillSon(node, index)];
+    }
+
+    if (this->root->count == 0)
+    {
+        emptyRoot = this->root;
+        this->root = emptyRoot->isLeaf ? NULL : emptyRoot->sons[0];
+        deleteNode(& emptyRoot);
+    }
+
+    if (found)
+        this->size--;
+
+    return popped;
+}
+
+
+static void map(_BTree const * const this, void (* callback)(void const * const value))
+{
+    if ((this == NULL) || (this->root == NULL))
+        return;
+
+    mapBranch(this->root, callback);
+}
+
+
+
+
+static _BTreeNode * constructNode(int isLeaf)
+{
+    _BTreeNode * node;
+
+    if (isLeaf)
+        node = Class->constructor("BTreeLeaf", offsetof(_BTreeNode, sons));
+    else
+        node = Class->constructor("BTreeNode", sizeof(* node));
+
+    if (node == NULL)
+        return NULL;
+
+    node->count = 0;
+    node->isLeaf = isLeaf;
+
+    return node;
+}
+
+
+static void deleteNode(_BTreeNode ** node)
+{
+    if ((node == NULL) || (* node == NULL))
+        return;
+
+    Class->destructor((* node)->isLeaf ? "BTreeLeaf" : "BTreeNode", (void **) node);
+}
+
+
+static void destroyBranch(_BTreeNode ** node)
+{
+    unsigned int i;
+
+    if ((node == NULL) || (* node == NULL))
+        return;
+
+    if (! (* node)->isLeaf)
+        for (i = 0; i <= (* node)->count; i++)
+            destroyBranch(& (* node)->sons[i]);
+
+    deleteNode(node);
+}
+
+
+static unsigned int lowerBound(_BTree const * const this, _BTreeNode const * const node, void const * const value)
+{
+    unsigned int lowest = 0, highest = node->count, middle;
+
+    while (lowest < highest)
+    {
+        middle = (lowest + highest) / 2;
+        if (this->compare(node->values[middle], value) < 0)
+            lowest = middle + 1;
+        else
+            highest = middle;
+    }
+
+    return lowest;
+}
+
+
+static unsigned int upperBound(_BTree const * const this, _BTreeNode const * const node, void const * const value)
+{
+    unsigned int lowest = 0, highest = node->count, middle;
+
+    while (lowest < highest)
+    {
+        middle = (lowest + highest) / 2;
+        if (this->compare(node->values[middle], value) <= 0)
+            lowest = middle + 1;
+        else
+            highest = middle;
+    }
+
+    return lowest;
+}
+
+
+static int splitSon(_BTreeNode * const node, unsigned int index)
+{
+    _BTreeNode * son = node->sons[index];
+    _BTreeNode * brother = constructNode(son->isLeaf);
+
+    if (brother == NULL)
+        return 0;
+
+    /* the son keeps the lesser half, its brother takes the greater one */
+    brother->count = B_TREE_MINIMUM_SONS - 1;
+    memcpy(brother->values, son->values + B_TREE_MINIMUM_SONS, brother->count * sizeof(* son->values));
+    if (! son->isLeaf)
+        memcpy(brother->sons, son->sons + B_TREE_MINIMUM_SONS, B_TREE_MINIMUM_SONS * sizeof(* son->sons));
+    son->count = B_TREE_MINIMUM_SONS - 1;
+
+    memmove(node->values + index + 1, node->values + index, (node->count - index) * sizeof(* node->values));
+    memmove(node->sons + index + 2, node->sons + index + 1, (node->count - index) * sizeof(* node->sons));
+    node->values[index] = son->values[B_TREE_MINIMUM_SONS - 1];
+    node->sons[index + 1] = brother;
+    node->count++;
+
+    return 1;
+}
+
+
+static void mergeSons(_BTreeNode * const node, unsigned int index)
+{
+    _BTreeNode * son = node->sons[index];
+    _BTreeNode * brother = node->sons[index + 1];
+
+    son->values[son->count] = node->values[index];
+    memcpy(son->values + son->count + 1, brother->values, brother->count * sizeof(* brother->values));
+    if (! son->isLeaf)
+        memcpy(son->sons + son->count + 1, brother->sons, (brother->count + 1) * sizeof(* brother->sons));
+    son->count += brother->count + 1;
+
+    node->count--;
+    memmove(node->values + index, node->values + index + 1, (node->count - index) * sizeof(* node->values));
+    memmove(node->sons + index + 1, node->sons + index + 2, (node->count - index) * sizeof(* node->sons));
+
+    deleteNode(& brother);
+}
+
+
+static unsigned int fillSon(_BTreeNode * const node, unsigned int index)
+{
+    _BTreeNode * son = node->sons[index], * brother;
+
+    if (son->count >= B_TREE_MINIMUM_SONS)
+        return index;
+
+    if ((index > 0) && (node->sons[index - 1]->count >= B_TREE_MINIMUM_SONS))
+    {
+        /* the value between them goes down at the front of the son, the last one of the left brother goes up */
+        brother = node->sons[index - 1];
+        memmove(son->values + 1, son->values, son->count * sizeof(* son->values));
+        son->values[0] = node->values[index - 1];
+        if (! son->isLeaf)
+        {
+            memmove(son->sons + 1, son->sons, (son->count + 1) * sizeof(* son->sons));
+            son->sons[0] = brother->sons[brother->count];
+        }
+        son->count++;
+
+        node->values[index - 1] = brother->values[brother->count - 1];
+        brother->count--;
+
+        return index;
+    }
+
+    if ((index < node->count) && (node->sons[index + 1]->count >= B_TREE_MINIMUM_SONS))
+    {
+        /* the value between them goes down at the back of the son, the first one of the right brother goes up */
+        brother = node->sons[index + 1];
+        son->values[son->count] = node->values[index];
+        if (! son->isLeaf)
+            son->sons[son->count + 1] = brother->sons[0];
+        son->count++;
+
+        node->values[index] = brother->values[0];
+        brother->count--;
+        memmove(brother->values, brother->values + 1, brother->count * sizeof(* brother->values));
+        if (! brother->isLeaf)
+            memmove(brother->sons, brother->sons + 1, (brother->count + 1) * sizeof(* brother->sons));
+
+        return index;
+    }
+
+    if (index < node->count)
+    {
+        mergeSons(node, index);
+        return index;
+    }
+
+    mergeSons(node, index - 1);
+    return index - 1;
+}
+
+
+static void const * popGreatest(_BTreeNode * node)
+{
+    while (! node->isLeaf)
+        node = node->sons[fillSon(node, node->count)];
+
+    node->count--;
+    return node->values[node->count];
+}
+
+
+static void const * popSmallest(_BTreeNode * node)
+{
+    void const * smallest;
+
+    while (! node->isLeaf)
+        node = node->sons[fillSon(node, 0)];
+
+    smallest = node->values[0];
+    node->count--;
+    memmove(node->values, node->values + 1, node->count * sizeof(* node->values));
+
+    return smallest;
+}
+
+
+static void mapBranch(_BTreeNode const * const node, void (* callback)(void const * const value))
+{
+    unsigned int i;
+
+    for (i = 0; i < node->count; i++)
+    {
+        if (! node->isLeaf)
+            mapBranch(node->sons[i], callback);
+        callback(node->values[i]);
+    }
+
+    if (! node->isLeaf)
+        mapBranch(node->sons[node->count], callback);
+}
+
+
+
+
+/**
+ * Init BTree methods table
+ */
+static BTreeMethods methods = {
+    constructor,
+    destructor,
+    find,
+    contains,
+    add,
+    size,
+    min,
+    max,
+    height,
+    pop,
+    map
+};
+BTreeMethods const * const BTree = & methods;
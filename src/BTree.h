@@ -0,0 +1,108 @@
+#ifndef B_TREE_CLASS_HEADER
+#define B_TREE_CLASS_HEADER
+
+
+
+
+/**
+ * A tree whose nodes hold up to 15 sorted values, so that a lookup loads a few wide nodes
+ * instead of one narrow node per level, AKA B-tree
+ *
+ * Values of a node fill two cache lines, which they start on when nodes are allocated from pools
+ */
+typedef struct _BTree _BTree;
+
+
+
+
+typedef struct
+{
+    /**
+     * @param compareCallback - the callback to compare elements with, should return :
+     *  < 0 if current value is smaller,
+     *  > 0 if other value is smaller,
+     *  = 0 if both are equal
+     *
+     * @return - an empty tree, or NULL if allocation failed
+     */
+    _BTree * (* constructor)(
+        int (* compareValuesCallback)(void const * const currentValue, void const * const otherValue)
+    );
+
+    /**
+     * Destroys the tree and all its nodes, and sets it to NULL
+     */
+    void (* destructor)(_BTree ** this);
+
+    /**
+     * @param value - the value to find in the tree
+     *
+     * @return - a value of the tree equal to the given one, or NULL if not found
+     */
+    void const * (* find)(_BTree const * const this, void const * const value);
+
+    /**
+     * @param value - the value to find in the tree
+     *
+     * @return - 1 if the value was found in the tree, 0 otherwise
+     */
+    int (* contains)(_BTree const * const this, void const * const value);
+
+    /**
+     * Adds the value after the equal ones already in the tree
+     *
+     * @param value - the value to add in the tree
+     *
+     * @return - the added value, or NULL if tree is NULL or allocation failed
+     */
+    void const * (* add)(_BTree * const this, void const * const value);
+
+    /**
+     * @return - the number of values in the tree
+     */
+    unsigned int (* size)(_BTree const * const this);
+
+    /**
+     * @return - the smallest value, or NULL if tree is empty
+     */
+    void const * (* min)(_BTree const * const this);
+
+    /**
+     * @return - the greatest value, or NULL if tree is empty
+     */
+    void const * (* max)(_BTree const * const this);
+
+    /**
+     * @return - the number of nodes from the top-most one to any of the bottom-most ones
+     */
+    unsigned int (* height)(_BTree const * const this);
+
+    /**
+     * Removes a value equal to the given one from the tree
+     *
+     * @param value - the value to pop from the tree
+     *
+     * @return - the value which was stored in the tree, or NULL if it was not found
+     */
+    void const * (* pop)(_BTree * const this, void const * const value);
+
+    /**
+     * Applies the callback on every value in the tree, in order
+     *
+     * @param callback - the callback to apply on each value
+     */
+    void (* map)(_BTree const * const this, void (* callback)(void const * const value));
+} BTreeMethods;
+
+
+
+
+/**
+ * BTree methods table
+ */
+extern BTreeMethods const * const BTree;
+
+
+
+
+#endif /* B_TREE_CLASS_HEADER */
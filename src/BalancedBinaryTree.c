@@ -1,8 +1,11 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "Class.h"
+#include "Pool.h"
+#include "Sort.h"
 #include "BinaryTree.h"
 #include "BalancedBinaryTree.h"
 
@@ -13,6 +16,9 @@
  * Colors that nodes can have
  * Magic number as values are to avoid false positives when casting
  * from a simple binary tree
+ *
+ * With packed colors, red nodes have the lowest bit of their parent pointer set instead,
+ * nodes being aligned on more than one byte, and take as much memory as simple binary tree nodes
  */
 typedef enum
 {
@@ -21,48 +27,297 @@ typedef enum
 } BalancedBinaryTreeNodeColor;
 
 
+#ifdef TREE_PACKED_COLORS
+/**
+ * Bit of the parent pointer set on red nodes
+ */
+#define RED_PARENT_BIT ((size_t) 1)
+#endif
+
+
 struct _BalancedBinaryTree
 {
-    void const * value;
+    _BalancedBinaryTreeNode * root;
     int (* compare)(void const * const currentValue, void const * const otherValue);
-    _BalancedBinaryTree * parent;
-    _BalancedBinaryTree * leftNode;
-    _BalancedBinaryTree * rightNode;
+    unsigned int size;
+    _BalancedBinaryTreeNode * min;
+    _BalancedBinaryTreeNode * max;
+    char const * nodeClassName;
+    _Pool * arena;
+    int ownsArena;
+};
+
+
+struct _BalancedBinaryTreeNode
+{
+    void const * value;
+    _BalancedBinaryTreeNode * parent;
+    _BalancedBinaryTreeNode * leftNode;
+    _BalancedBinaryTreeNode * rightNode;
+#ifdef TREE_ORDER_STATISTICS
+    unsigned int weight;
+#endif
+#ifndef TREE_PACKED_COLORS
     BalancedBinaryTreeNodeColor color;
+#endif
 };
 
 
 
 
+/**
+ * @param value - the value the node will hold
+ *
+ * @return - a black node without parent nor sons, or NULL if allocation failed
+ */
+static _BalancedBinaryTreeNode * constructNode(_BalancedBinaryTree const * const this, void const * value);
+
+
+/**
+ * Links nodes into a branch whose top-most node holds the middle value, and whose halves hold the others,
+ * recursion goes as deep as the branch is high, which is logarithmic
+ *
+ * @param values - the sorted values to create nodes for, which must be reserved in the arena
+ * @param nodes - the nodes to link instead, holding sorted values, or NULL to create them
+ * @param first - the index of the first value or node of the branch
+ * @param count - the number of values or nodes of the branch
+ * @param parent - the node the branch hangs from
+ * @param depth - the depth of the top-most node of the branch
+ * @param redDepth - the depth of the nodes to color in red, the others are black
+ *
+ * @return - the top-most node of the branch, or NULL if there is no value
+ */
+static _BalancedBinaryTreeNode * buildBranch(
+    _BalancedBinaryTree const * const this,
+    void const * const * const values,
+    _BalancedBinaryTreeNode * const * const nodes,
+    unsigned int first,
+    unsigned int count,
+    _BalancedBinaryTreeNode * const parent,
+    unsigned int depth,
+    unsigned int redDepth
+);
+
+
+/**
+ * Halves of built branches differ by one node at most, so only their last level can be incomplete,
+ * coloring it in red gives the same black height to every path
+ *
+ * @param count - the number of nodes of the tree to build
+ *
+ * @return - the depth of the nodes to color in red, deeper than the tree if it is complete
+ */
+static unsigned int redDepthOfBuiltTree(unsigned int count);
+
+
+/**
+ * @param last - the node holding the last value added from the batch, or NULL
+ * @param value - the value to add, not lesser than the last one
+ *
+ * @return - the top-most node of the smallest branch above the last node the value belongs to
+ */
+static _BalancedBinaryTreeNode * closestBranch(
+    _BalancedBinaryTree const * const this,
+    _BalancedBinaryTreeNode * last,
+    void const * const value
+);
+
+
+/**
+ * Adds the sorted values one after the other, each descent starting from the branch of the previous one
+ *
+ * @return - the number of values added, less than count if allocation failed
+ */
+static unsigned int addSortedValues(_BalancedBinaryTree * const this, void const * const * const values, unsigned int count);
+
+
+/**
+ * Merges the sorted values with the ones of the tree, and relinks all of them into a tree of the least height
+ *
+ * @return - 1 if the tree was rebuilt, 0 if allocation failed and the tree is left as is
+ */
+static int rebuildWithSortedValues(_BalancedBinaryTree * const this, void const * const * const values, unsigned int count);
+
+
+/**
+ * Relinks the nodes of the tree into a tree of the least height, in linear time
+ *
+ * @param nodes - room for as many nodes as the tree holds
+ */
+static void relinkNodes(_BalancedBinaryTree * const this, _BalancedBinaryTreeNode ** const nodes);
+
+
 /**
  * @param value - the value to compare with
  *
  * @return - 1 if the value of the node is greater than the other one, 0 otherwise
  */
-static int nodeHasGreaterValue(_BalancedBinaryTree const * const this, void const * const value);
+static int nodeHasGreaterValue(_BalancedBinaryTree const * const this, _BalancedBinaryTreeNode const * const node, void const * const value);
+
+
+static int isRedNode(_BalancedBinaryTreeNode const * const this);
+
+
+static BalancedBinaryTreeNodeColor colorOf(_BalancedBinaryTreeNode const * const this);
+
+
+static void setColor(_BalancedBinaryTreeNode * const this, BalancedBinaryTreeNodeColor color);
+
+
+static _BalancedBinaryTreeNode * parentOf(_BalancedBinaryTreeNode const * const this);
+
+
+/**
+ * Links the node to its parent, keeping its color
+ */
+static void setParent(_BalancedBinaryTreeNode * const this, _BalancedBinaryTreeNode * const parent);
+
+
+/**
+ * @return - the node having the smallest value in the branch
+ */
+static _BalancedBinaryTreeNode * leftMostNode(_BalancedBinaryTreeNode * this);
+
+
+/**
+ * @return - the node having the greatest value in the branch
+ */
+static _BalancedBinaryTreeNode * rightMostNode(_BalancedBinaryTreeNode * this);
+
+
+/**
+ * Adds the value as a new red leaf, without repairing the tree
+ *
+ * @return - the newly created leaf
+ */
+static _BalancedBinaryTreeNode * addLeaf(_BalancedBinaryTree * const this, _BalancedBinaryTreeNode * node, void const * const value);
+
+
+/**
+ * Counts the newly added leaf in the tree, and updates the bounds if needed
+ */
+static void registerLeaf(_BalancedBinaryTree * const this, _BalancedBinaryTreeNode * const leaf);
+
+
+/**
+ * Recolors and rotates nodes above the newly added one until no red node has a red son
+ */
+static void repairAfterInsertion(_BalancedBinaryTree * const this, _BalancedBinaryTreeNode * node);
+
+
+/**
+ * Makes the right son of the node take its place, the node becomes its left son
+ */
+static void rotateLeft(_BalancedBinaryTree * const this, _BalancedBinaryTreeNode * const node);
+
+
+/**
+ * Makes the left son of the node take its place, the node becomes its right son
+ */
+static void rotateRight(_BalancedBinaryTree * const this, _BalancedBinaryTreeNode * const node);
+
+
+/**
+ * Adds the difference to the weight of the node and of all the nodes above it,
+ * does nothing unless order statistics are enabled
+ */
+static void addToWeights(_BalancedBinaryTreeNode * this, int difference);
 
 
-static _BalancedBinaryTree * addValueToTheLeft(_BalancedBinaryTree * const this, void const * const value);
+/**
+ * Gives the weight of the node to the pivot which took its place in a rotation,
+ * and recomputes the weight of the node from its new sons
+ */
+static void passWeight(_BalancedBinaryTreeNode * const node, _BalancedBinaryTreeNode * const pivot);
+
+
+/**
+ * Links the replacement to the parent of the node, or makes it the root
+ *
+ * @param replacement - the node taking the place, can be NULL
+ */
+static void replaceInParent(
+    _BalancedBinaryTree * const this,
+    _BalancedBinaryTreeNode const * const node,
+    _BalancedBinaryTreeNode * const replacement
+);
+
+
+/**
+ * Unlinks the node from the tree, rebalancing it if a black node was removed
+ */
+static void unlinkNode(_BalancedBinaryTree * const this, _BalancedBinaryTreeNode * const node);
 
 
-static _BalancedBinaryTree * addValueToTheRight(_BalancedBinaryTree * const this, void const * const value);
+/**
+ * Recolors and rotates nodes around the branch missing a black node,
+ * until every path from the root has the same number of black nodes again
+ *
+ * @param node - the node which took the place of the removed one, can be NULL
+ * @param parent - the parent of that node
+ */
+static void repairAfterRemoval(
+    _BalancedBinaryTree * const this,
+    _BalancedBinaryTreeNode * node,
+    _BalancedBinaryTreeNode * parent
+);
 
 
 
 
-static _BalancedBinaryTree * constructor(void const * value, int (* compareValuesCallback)(void const * const currentValue, void const * const otherValue))
+static _BalancedBinaryTree * constructor(int (* compareValuesCallback)(void const * const currentValue, void const * const otherValue))
 {
-    _BalancedBinaryTree * this = Class->constructor("BinaryTree", sizeof(* this));
+    _BalancedBinaryTree * this = (_BalancedBinaryTree *) BinaryTree->constructor(compareValuesCallback);
 
     if (this == NULL)
         return NULL;
 
-    this->value = value;
-    this->compare = compareValuesCallback;
-    this->parent = NULL;
-    this->leftNode = NULL;
-    this->rightNode = NULL;
-    this->color = BLACK;
+    this->nodeClassName = "BalancedBinaryTreeNode";
+
+    return this;
+}
+
+
+static _BalancedBinaryTree * arenaConstructor(int (* compareValuesCallback)(void const * const currentValue, void const * const otherValue))
+{
+    _BalancedBinaryTree * this = constructor(compareValuesCallback);
+
+    if (this == NULL)
+        return NULL;
+
+    this->arena = Pool->constructor(sizeof(_BalancedBinaryTreeNode));
+    if (this->arena == NULL)
+    {
+        BinaryTree->destructor((_BinaryTree **) & this);
+        return NULL;
+    }
+    this->ownsArena = 1;
+
+    return this;
+}
+
+
+static _BalancedBinaryTree * sortedConstructor(
+    int (* compareValuesCallback)(void const * const currentValue, void const * const otherValue),
+    void const * const * const values,
+    unsigned int count
+)
+{
+    _BalancedBinaryTree * this = arenaConstructor(compareValuesCallback);
+
+    if ((this == NULL) || (count == 0))
+        return this;
+
+    if (! Pool->reserve(this->arena, count))
+    {
+        BinaryTree->destructor((_BinaryTree **) & this);
+        return NULL;
+    }
+
+    this->root = buildBranch(this, values, NULL, 0, count, NULL, 0, redDepthOfBuiltTree(count));
+    this->size = count;
+    this->min = leftMostNode(this->root);
+    this->max = rightMostNode(this->root);
 
     return this;
 }
@@ -74,15 +329,15 @@ static void destructor(_BalancedBinaryTree ** this)
 }
 
 
-static void const * value(_BalancedBinaryTree const * const this)
+static void const * value(_BalancedBinaryTreeNode const * const node)
 {
-    return BinaryTree->value((_BinaryTree *) this);
+    return BinaryTree->value((_BinaryTreeNode *) node);
 }
 
 
-static _BalancedBinaryTree * findValue(_BalancedBinaryTree * const this, void const * const value)
+static _BalancedBinaryTreeNode * findValue(_BalancedBinaryTree * const this, void const * const value)
 {
-    return (_BalancedBinaryTree *) BinaryTree->find((_BinaryTree *) this, value);
+    return (_BalancedBinaryTreeNode *) BinaryTree->find((_BinaryTree *) this, value);
 }
 
 
@@ -92,11 +347,143 @@ static int containsValue(_BalancedBinaryTree * const this, void const * const va
 }
 
 
-static _BalancedBinaryTree * addValue(_BalancedBinaryTree * const this, void const * const value)
+static unsigned int findMany(
+    _BalancedBinaryTree * const this,
+    void const * const * const values,
+    unsigned int count,
+    _BalancedBinaryTreeNode ** const results
+)
 {
-    if (nodeHasGreaterValue(this, value))
-        return addValueToTheLeft(this, value);
-    return addValueToTheRight(this, value);
+    return BinaryTree->findMany((_BinaryTree *) this, values, count, (_BinaryTreeNode **) results);
+}
+
+
+static _BalancedBinaryTreeNode * addValue(_BalancedBinaryTree * const this, void const * const value)
+{
+    _BalancedBinaryTreeNode * node;
+
+    if (this == NULL)
+        return NULL;
+
+    if (this->root == NULL)
+    {
+        this->root = constructNode(this, value);
+        if (this->root == NULL)
+            return NULL;
+
+        this->size = 1;
+        this->min = this->root;
+        this->max = this->root;
+
+        return this->root;
+    }
+
+    node = addLeaf(this, this->root, value);
+    if (node == NULL)
+        return NULL;
+
+    repairAfterInsertion(this, node);
+
+    return node;
+}
+
+
+static _BalancedBinaryTreeNode * insertOrGet(_BalancedBinaryTree * const this, void const * const value, int * const inserted)
+{
+    _BalancedBinaryTreeNode ** place;
+    _BalancedBinaryTreeNode * node = NULL;
+    _BalancedBinaryTreeNode * leaf;
+    int comparison = 0;
+
+    if (inserted != NULL)
+        * inserted = 0;
+    if (this == NULL)
+        return NULL;
+
+    for (place = & this->root; * place != NULL; place = (comparison > 0) ? & node->leftNode : & node->rightNode)
+    {
+        node = * place;
+        comparison = this->compare(node->value, value);
+        if (comparison == 0)
+            return node;
+    }
+
+    leaf = constructNode(this, value);
+    if (leaf == NULL)
+        return NULL;
+
+    * place = leaf;
+    if (node == NULL)
+    {
+        this->size = 1;
+        this->min = leaf;
+        this->max = leaf;
+    }
+    else
+    {
+        setParent(leaf, node);
+        setColor(leaf, RED);
+        registerLeaf(this, leaf);
+        addToWeights(node, 1);
+        repairAfterInsertion(this, leaf);
+    }
+
+    if (inserted != NULL)
+        * inserted = 1;
+
+    return leaf;
+}
+
+
+static unsigned int addMany(_BalancedBinaryTree * const this, void const * const * const values, unsigned int count)
+{
+    void const ** sortedValues;
+    unsigned int added;
+
+    if ((this == NULL) || (count == 0))
+        return 0;
+
+    sortedValues = malloc(count * sizeof(* sortedValues));
+    if (sortedValues == NULL)
+    {
+        fprintf(stderr, "Memory allocation failed for class %s\n", "BalancedBinaryTree");
+        return 0;
+    }
+
+    memcpy(sortedValues, values, count * sizeof(* sortedValues));
+    if (! Sort->values(sortedValues, count, this->compare))
+    {
+        free(sortedValues);
+        return 0;
+    }
+
+    /* relinking every node costs less than descending and repairing for each value once the batch outnumbers the tree */
+    if ((count >= this->size) && rebuildWithSortedValues(this, sortedValues, count))
+        added = count;
+    else
+        added = addSortedValues(this, sortedValues, count);
+
+    free(sortedValues);
+
+    return added;
+}
+
+
+static unsigned int size(_BalancedBinaryTree const * const this)
+{
+    return BinaryTree->size((_BinaryTree *) this);
+}
+
+
+static _BalancedBinaryTreeNode * min(_BalancedBinaryTree const * const this)
+{
+    return (_BalancedBinaryTreeNode *) BinaryTree->min((_BinaryTree *) this);
+}
+
+
+static _BalancedBinaryTreeNode * max(_BalancedBinaryTree const * const this)
+{
+    return (_BalancedBinaryTreeNode *) BinaryTree->max((_BinaryTree *) this);
 }
 
 
@@ -106,21 +493,66 @@ static unsigned int height(_BalancedBinaryTree const * const this)
 }
 
 
-static _BalancedBinaryTree * detachNode(_BalancedBinaryTree * const this)
+static _BalancedBinaryTree * detachNode(_BalancedBinaryTree * const this, _BalancedBinaryTreeNode * const node)
 {
-    return (_BalancedBinaryTree *) BinaryTree->detach((_BinaryTree *) this);
+    _BalancedBinaryTreeNode ** nodes;
+    _BalancedBinaryTree * branch;
+
+    if ((this == NULL) || (node == NULL))
+        return NULL;
+
+    /* cutting a branch leaves paths of unequal black heights on both sides, neither tree outnumbers this one */
+    nodes = malloc(this->size * sizeof(* nodes));
+    if (nodes == NULL)
+    {
+        fprintf(stderr, "Memory allocation failed for class %s\n", "BalancedBinaryTree");
+        return NULL;
+    }
+
+    branch = (_BalancedBinaryTree *) BinaryTree->detach((_BinaryTree *) this, (_BinaryTreeNode *) node);
+    if (branch != NULL)
+    {
+        relinkNodes(this, nodes);
+        relinkNodes(branch, nodes);
+    }
+
+    free(nodes);
+
+    return branch;
 }
 
 
-static _BalancedBinaryTree * root(_BalancedBinaryTree * const this)
+static _BalancedBinaryTreeNode * root(_BalancedBinaryTree const * const this)
 {
-    return (_BalancedBinaryTree *) BinaryTree->root((_BinaryTree *) this);
+    return (_BalancedBinaryTreeNode *) BinaryTree->root((_BinaryTree *) this);
 }
 
 
-static _BalancedBinaryTree * pop(_BalancedBinaryTree * const this, void const * const value)
+static void const * pop(_BalancedBinaryTree * const this, void const * const value)
 {
-    return (_BalancedBinaryTree *) BinaryTree->pop((_BinaryTree *) this, value);
+    _BalancedBinaryTreeNode * node;
+    void const * poppedValue;
+
+    node = findValue(this, value);
+    if (node == NULL)
+        return NULL;
+
+    /* the smallest node has no left son, and the greatest one no right son */
+    if (node == this->min)
+        this->min = (node->rightNode != NULL) ? leftMostNode(node->rightNode) : parentOf(node);
+    if (node == this->max)
+        this->max = (node->leftNode != NULL) ? rightMostNode(node->leftNode) : parentOf(node);
+
+    unlinkNode(this, node);
+    this->size--;
+
+    poppedValue = node->value;
+    if (this->arena != NULL)
+        Pool->release(this->arena, node);
+    else
+        Class->destructor(this->nodeClassName, (void **) & node);
+
+    return poppedValue;
 }
 
 
@@ -130,35 +562,616 @@ static void map(_BalancedBinaryTree const * const this, void (* callback)(void c
 }
 
 
+static _BalancedBinaryTreeNode * next(_BalancedBinaryTreeNode * const node)
+{
+    return (_BalancedBinaryTreeNode *) BinaryTree->next((_BinaryTreeNode *) node);
+}
+
+
+static _BalancedBinaryTreeNode * previous(_BalancedBinaryTreeNode * const node)
+{
+    return (_BalancedBinaryTreeNode *) BinaryTree->previous((_BinaryTreeNode *) node);
+}
+
+
+static _BalancedBinaryTreeNode * seek(_BalancedBinaryTree const * const this, void const * const value)
+{
+    return (_BalancedBinaryTreeNode *) BinaryTree->seek((_BinaryTree *) this, value);
+}
+
+
+static _BalancedBinaryTreeNode * upperBound(_BalancedBinaryTree const * const this, void const * const value)
+{
+    return (_BalancedBinaryTreeNode *) BinaryTree->upperBound((_BinaryTree *) this, value);
+}
 
 
-static int nodeHasGreaterValue(_BalancedBinaryTree const * const this, void const * const value)
+static _BalancedBinaryTreeNode * floorNode(_BalancedBinaryTree const * const this, void const * const value)
 {
-    return this->compare(this->value, value) > 0;
+    return (_BalancedBinaryTreeNode *) BinaryTree->floor((_BinaryTree *) this, value);
 }
 
 
-static _BalancedBinaryTree * addValueToTheLeft(_BalancedBinaryTree * const this, void const * const value)
+static void mapRange(
+    _BalancedBinaryTree const * const this,
+    void const * const lowest,
+    void const * const greatest,
+    void (* callback)(void const * const value)
+)
 {
-    if (this->leftNode != NULL)
-        return addValue(this->leftNode, value);
+    BinaryTree->mapRange((_BinaryTree *) this, lowest, greatest, callback);
+}
+
+
+static unsigned int rankOfValue(_BalancedBinaryTree const * const this, void const * const value)
+{
+    return BinaryTree->rank((_BinaryTree *) this, value);
+}
+
+
+static _BalancedBinaryTreeNode * selectNode(_BalancedBinaryTree const * const this, unsigned int index)
+{
+    return (_BalancedBinaryTreeNode *) BinaryTree->select((_BinaryTree *) this, index);
+}
+
+
+static _FrozenTree * freeze(_BalancedBinaryTree const * const this, FrozenTreeLayout layout)
+{
+    return BinaryTree->freeze((_BinaryTree *) this, layout);
+}
+
+
+
+
+static _BalancedBinaryTreeNode * constructNode(_BalancedBinaryTree const * const this, void const * value)
+{
+    _BalancedBinaryTreeNode * node;
+
+    if (this->arena != NULL)
+        node = Pool->allocate(this->arena);
+    else
+        node = Class->constructor(this->nodeClassName, sizeof(* node));
+
+    if (node == NULL)
+        return NULL;
+
+    node->value = value;
+    node->parent = NULL;
+    node->leftNode = NULL;
+    node->rightNode = NULL;
+#ifdef TREE_ORDER_STATISTICS
+    node->weight = 1;
+#endif
+    setColor(node, BLACK);
+
+    return node;
+}
+
+
+static _BalancedBinaryTreeNode * buildBranch(
+    _BalancedBinaryTree const * const this,
+    void const * const * const values,
+    _BalancedBinaryTreeNode * const * const nodes,
+    unsigned int first,
+    unsigned int count,
+    _BalancedBinaryTreeNode * const parent,
+    unsigned int depth,
+    unsigned int redDepth
+)
+{
+    unsigned int middle = first + count / 2;
+    _BalancedBinaryTreeNode * node;
+
+    if (count == 0)
+        return NULL;
 
-    this->leftNode = constructor(value, this->compare);
-    this->leftNode->parent = this;
+    node = (nodes != NULL) ? nodes[middle] : constructNode(this, values[middle]);
+    node->parent = parent;
+    node->leftNode = buildBranch(this, values, nodes, first, middle - first, node, depth + 1, redDepth);
+    node->rightNode = buildBranch(this, values, nodes, middle + 1, first + count - middle - 1, node, depth + 1, redDepth);
+#ifdef TREE_ORDER_STATISTICS
+    node->weight = count;
+#endif
+    setColor(node, (depth == redDepth) ? RED : BLACK);
 
-    return this->leftNode;
+    return node;
 }
 
 
-static _BalancedBinaryTree * addValueToTheRight(_BalancedBinaryTree * const this, void const * const value)
+static unsigned int redDepthOfBuiltTree(unsigned int count)
 {
-    if (this->rightNode != NULL)
-        return addValue(this->rightNode, value);
+    unsigned int levels = 0, fullCount = 0;
+
+    while (fullCount < count)
+    {
+        fullCount = 2 * fullCount + 1;
+        levels++;
+    }
+
+    return (fullCount == count) ? levels : levels - 1;
+}
+
+
+static _BalancedBinaryTreeNode * closestBranch(
+    _BalancedBinaryTree const * const this,
+    _BalancedBinaryTreeNode * last,
+    void const * const value
+)
+{
+    if (last == NULL)
+        return this->root;
+
+    /* the branch of a left son only holds values lesser than its parent */
+    while (parentOf(last) != NULL)
+    {
+        if ((last == parentOf(last)->leftNode) && nodeHasGreaterValue(this, parentOf(last), value))
+            return last;
+        last = parentOf(last);
+    }
+
+    return last;
+}
+
+
+static unsigned int addSortedValues(_BalancedBinaryTree * const this, void const * const * const values, unsigned int count)
+{
+    _BalancedBinaryTreeNode * last = NULL;
+    unsigned int i;
+
+    for (i = 0; i < count; i++)
+    {
+        if (this->root == NULL)
+            last = addValue(this, values[i]);
+        else
+        {
+            last = addLeaf(this, closestBranch(this, last, values[i]), values[i]);
+            if (last != NULL)
+                repairAfterInsertion(this, last);
+        }
+
+        if (last == NULL)
+            break;
+    }
+
+    return i;
+}
+
+
+static int rebuildWithSortedValues(_BalancedBinaryTree * const this, void const * const * const values, unsigned int count)
+{
+    unsigned int total = this->size + count, i, added = 0;
+    _BalancedBinaryTreeNode ** nodes, * node;
+
+    nodes = malloc(total * sizeof(* nodes));
+    if (nodes == NULL)
+    {
+        fprintf(stderr, "Memory allocation failed for class %s\n", "BalancedBinaryTree");
+        return 0;
+    }
+
+    /* equal values go after the ones already in the tree, as they would when added one by one */
+    node = this->min;
+    for (i = 0; i < total; i++)
+    {
+        if ((added == count) || ((node != NULL) && ! nodeHasGreaterValue(this, node, values[added])))
+        {
+            nodes[i] = node;
+            node = next(node);
+            continue;
+        }
+
+        nodes[i] = constructNode(this, values[added]);
+        if (nodes[i] == NULL)
+        {
+            while (i-- > 0)
+            {
+                if ((parentOf(nodes[i]) != NULL) || (nodes[i] == this->root))
+                    continue;
+                if (this->arena != NULL)
+                    Pool->release(this->arena, nodes[i]);
+                else
+                    Class->destructor(this->nodeClassName, (void **) & nodes[i]);
+            }
+            free(nodes);
+            return 0;
+        }
+        added++;
+    }
+
+    this->root = buildBranch(this, NULL, nodes, 0, total, NULL, 0, redDepthOfBuiltTree(total));
+    this->size = total;
+    this->min = nodes[0];
+    this->max = nodes[total - 1];
+
+    free(nodes);
+
+    return 1;
+}
+
+
+static void relinkNodes(_BalancedBinaryTree * const this, _BalancedBinaryTreeNode ** const nodes)
+{
+    _BalancedBinaryTreeNode * node;
+    unsigned int i = 0;
+
+    for (node = this->min; node != NULL; node = next(node))
+        nodes[i++] = node;
+
+    this->root = buildBranch(this, NULL, nodes, 0, this->size, NULL, 0, redDepthOfBuiltTree(this->size));
+}
+
+
+static int nodeHasGreaterValue(_BalancedBinaryTree const * const this, _BalancedBinaryTreeNode const * const node, void const * const value)
+{
+    return this->compare(node->value, value) > 0;
+}
+
+
+static int isRedNode(_BalancedBinaryTreeNode const * const this)
+{
+    return (this != NULL) && (colorOf(this) == RED);
+}
+
+
+static BalancedBinaryTreeNodeColor colorOf(_BalancedBinaryTreeNode const * const this)
+{
+#ifdef TREE_PACKED_COLORS
+    return ((size_t) this->parent & RED_PARENT_BIT) ? RED : BLACK;
+#else
+    return this->color;
+#endif
+}
+
+
+static void setColor(_BalancedBinaryTreeNode * const this, BalancedBinaryTreeNodeColor color)
+{
+#ifdef TREE_PACKED_COLORS
+    if (color == RED)
+        this->parent = (_BalancedBinaryTreeNode *) ((size_t) this->parent | RED_PARENT_BIT);
+    else
+        this->parent = (_BalancedBinaryTreeNode *) ((size_t) this->parent & ~RED_PARENT_BIT);
+#else
+    this->color = color;
+#endif
+}
+
+
+static _BalancedBinaryTreeNode * parentOf(_BalancedBinaryTreeNode const * const this)
+{
+#ifdef TREE_PACKED_COLORS
+    return (_BalancedBinaryTreeNode *) ((size_t) this->parent & ~RED_PARENT_BIT);
+#else
+    return this->parent;
+#endif
+}
+
+
+static void setParent(_BalancedBinaryTreeNode * const this, _BalancedBinaryTreeNode * const parent)
+{
+#ifdef TREE_PACKED_COLORS
+    this->parent = (_BalancedBinaryTreeNode *) ((size_t) parent | ((size_t) this->parent & RED_PARENT_BIT));
+#else
+    this->parent = parent;
+#endif
+}
+
+
+static _BalancedBinaryTreeNode * leftMostNode(_BalancedBinaryTreeNode * this)
+{
+    while (this->leftNode != NULL)
+        this = this->leftNode;
+
+    return this;
+}
+
+
+static _BalancedBinaryTreeNode * rightMostNode(_BalancedBinaryTreeNode * this)
+{
+    while (this->rightNode != NULL)
+        this = this->rightNode;
+
+    return this;
+}
+
+
+static _BalancedBinaryTreeNode * addLeaf(_BalancedBinaryTree * const this, _BalancedBinaryTreeNode * node, void const * const value)
+{
+    _BalancedBinaryTreeNode ** place;
+    _BalancedBinaryTreeNode * leaf;
+
+    for (;;)
+    {
+        place = nodeHasGreaterValue(this, node, value) ? & node->leftNode : & node->rightNode;
+        if (* place == NULL)
+            break;
+        node = * place;
+    }
+
+    leaf = constructNode(this, value);
+    if (leaf == NULL)
+        return NULL;
+
+    setParent(leaf, node);
+    setColor(leaf, RED);
+    * place = leaf;
+    registerLeaf(this, leaf);
+    addToWeights(node, 1);
+
+    return leaf;
+}
+
+
+static void registerLeaf(_BalancedBinaryTree * const this, _BalancedBinaryTreeNode * const leaf)
+{
+    this->size++;
+
+    if (leaf == parentOf(leaf)->leftNode)
+    {
+        if (parentOf(leaf) == this->min)
+            this->min = leaf;
+    }
+    else if (parentOf(leaf) == this->max)
+        this->max = leaf;
+}
+
+
+static void repairAfterInsertion(_BalancedBinaryTree * const this, _BalancedBinaryTreeNode * node)
+{
+    _BalancedBinaryTreeNode * parent, * grandParent, * uncle;
+
+    /* a red parent is never the root, so the grandparent always exists */
+    while (isRedNode(parentOf(node)))
+    {
+        parent = parentOf(node);
+        grandParent = parentOf(parent);
+
+        if (parent == grandParent->leftNode)
+        {
+            uncle = grandParent->rightNode;
+            if (! isRedNode(uncle) && (node == parent->rightNode))
+            {
+                rotateLeft(this, parent);
+                node = parent;
+                parent = parentOf(node);
+            }
+        }
+        else
+        {
+            uncle = grandParent->leftNode;
+            if (! isRedNode(uncle) && (node == parent->leftNode))
+            {
+                rotateRight(this, parent);
+                node = parent;
+                parent = parentOf(node);
+            }
+        }
+
+        if (isRedNode(uncle))
+        {
+            setColor(parent, BLACK);
+            setColor(uncle, BLACK);
+            setColor(grandParent, RED);
+            node = grandParent;
+            continue;
+        }
+
+        setColor(parent, BLACK);
+        setColor(grandParent, RED);
+        if (parent == grandParent->leftNode)
+            rotateRight(this, grandParent);
+        else
+            rotateLeft(this, grandParent);
+    }
+
+    setColor(this->root, BLACK);
+}
+
+
+static void rotateLeft(_BalancedBinaryTree * const this, _BalancedBinaryTreeNode * const node)
+{
+    _BalancedBinaryTreeNode * pivot = node->rightNode;
+
+    node->rightNode = pivot->leftNode;
+    if (pivot->leftNode != NULL)
+        setParent(pivot->leftNode, node);
+
+    replaceInParent(this, node, pivot);
+
+    pivot->leftNode = node;
+    setParent(node, pivot);
+    passWeight(node, pivot);
+}
+
+
+static void rotateRight(_BalancedBinaryTree * const this, _BalancedBinaryTreeNode * const node)
+{
+    _BalancedBinaryTreeNode * pivot = node->leftNode;
+
+    node->leftNode = pivot->rightNode;
+    if (pivot->rightNode != NULL)
+        setParent(pivot->rightNode, node);
+
+    replaceInParent(this, node, pivot);
+
+    pivot->rightNode = node;
+    setParent(node, pivot);
+    passWeight(node, pivot);
+}
+
+
+static void addToWeights(_BalancedBinaryTreeNode * this, int difference)
+{
+#ifdef TREE_ORDER_STATISTICS
+    for (; this != NULL; this = parentOf(this))
+        this->weight += difference;
+#else
+    (void) this;
+    (void) difference;
+#endif
+}
+
+
+static void passWeight(_BalancedBinaryTreeNode * const node, _BalancedBinaryTreeNode * const pivot)
+{
+#ifdef TREE_ORDER_STATISTICS
+    pivot->weight = node->weight;
+    node->weight = 1;
+    if (node->leftNode != NULL)
+        node->weight += node->leftNode->weight;
+    if (node->rightNode != NULL)
+        node->weight += node->rightNode->weight;
+#else
+    (void) node;
+    (void) pivot;
+#endif
+}
+
+
+static void replaceInParent(
+    _BalancedBinaryTree * const this,
+    _BalancedBinaryTreeNode const * const node,
+    _BalancedBinaryTreeNode * const replacement
+)
+{
+    _BalancedBinaryTreeNode * parent = parentOf(node);
+
+    if (replacement != NULL)
+        setParent(replacement, parent);
+
+    if (parent == NULL)
+        this->root = replacement;
+    else if (parent->leftNode == node)
+        parent->leftNode = replacement;
+    else
+        parent->rightNode = replacement;
+}
+
+
+static void unlinkNode(_BalancedBinaryTree * const this, _BalancedBinaryTreeNode * const node)
+{
+    _BalancedBinaryTreeNode * successor, * replacement, * replacementParent;
+    BalancedBinaryTreeNodeColor removedColor = colorOf(node);
+
+    if ((node->leftNode == NULL) || (node->rightNode == NULL))
+    {
+        replacement = (node->leftNode != NULL) ? node->leftNode : node->rightNode;
+        replacementParent = parentOf(node);
+        addToWeights(parentOf(node), -1);
+        replaceInParent(this, node, replacement);
+    }
+    else
+    {
+        successor = leftMostNode(node->rightNode);
+        addToWeights(parentOf(successor), -1);
+
+        removedColor = colorOf(successor);
+        replacement = successor->rightNode;
+
+        if (parentOf(successor) == node)
+            replacementParent = successor;
+        else
+        {
+            replacementParent = parentOf(successor);
+            replaceInParent(this, successor, replacement);
+            successor->rightNode = node->rightNode;
+            setParent(successor->rightNode, successor);
+        }
+
+        replaceInParent(this, node, successor);
+        successor->leftNode = node->leftNode;
+        setParent(successor->leftNode, successor);
+        setColor(successor, colorOf(node));
+#ifdef TREE_ORDER_STATISTICS
+        successor->weight = node->weight;
+#endif
+    }
+
+    if (removedColor == BLACK)
+        repairAfterRemoval(this, replacement, replacementParent);
+}
+
+
+static void repairAfterRemoval(
+    _BalancedBinaryTree * const this,
+    _BalancedBinaryTreeNode * node,
+    _BalancedBinaryTreeNode * parent
+)
+{
+    _BalancedBinaryTreeNode * sibling;
+
+    /* the branch holding the node misses a black node, the sibling branch can't be empty */
+    while ((parent != NULL) && ! isRedNode(node))
+    {
+        if (node == parent->leftNode)
+        {
+            sibling = parent->rightNode;
+            if (isRedNode(sibling))
+            {
+                setColor(sibling, BLACK);
+                setColor(parent, RED);
+                rotateLeft(this, parent);
+                sibling = parent->rightNode;
+            }
+
+            if (! isRedNode(sibling->leftNode) && ! isRedNode(sibling->rightNode))
+            {
+                setColor(sibling, RED);
+                node = parent;
+                parent = parentOf(node);
+                continue;
+            }
+
+            if (! isRedNode(sibling->rightNode))
+            {
+                setColor(sibling->leftNode, BLACK);
+                setColor(sibling, RED);
+                rotateRight(this, sibling);
+                sibling = parent->rightNode;
+            }
+
+            setColor(sibling, colorOf(parent));
+            setColor(parent, BLACK);
+            setColor(sibling->rightNode, BLACK);
+            rotateLeft(this, parent);
+        }
+        else
+        {
+            sibling = parent->leftNode;
+            if (isRedNode(sibling))
+            {
+                setColor(sibling, BLACK);
+                setColor(parent, RED);
+                rotateRight(this, parent);
+                sibling = parent->leftNode;
+            }
+
+            if (! isRedNode(sibling->leftNode) && ! isRedNode(sibling->rightNode))
+            {
+                setColor(sibling, RED);
+                node = parent;
+                parent = parentOf(node);
+                continue;
+            }
+
+            if (! isRedNode(sibling->leftNode))
+            {
+                setColor(sibling->rightNode, BLACK);
+                setColor(sibling, RED);
+                rotateLeft(this, sibling);
+                sibling = parent->leftNode;
+            }
+
+            setColor(sibling, colorOf(parent));
+            setColor(parent, BLACK);
+            setColor(sibling->leftNode, BLACK);
+            rotateRight(this, parent);
+        }
 
-    this->rightNode = constructor(value, this->compare);
-    this->rightNode->parent = this;
+        return;
+    }
 
-    return this->rightNode;
+    if (node != NULL)
+        setColor(node, BLACK);
 }
 
 
@@ -169,15 +1182,32 @@ static _BalancedBinaryTree * addValueToTheRight(_BalancedBinaryTree * const this
  */
 static BalancedBinaryTreeMethods methods = {
     constructor,
+    arenaConstructor,
+    sortedConstructor,
     destructor,
     value,
     findValue,
     containsValue,
+    findMany,
     addValue,
+    insertOrGet,
+    addMany,
+    size,
+    min,
+    max,
     height,
     detachNode,
     root,
     pop,
-    map
+    map,
+    next,
+    previous,
+    seek,
+    upperBound,
+    floorNode,
+    mapRange,
+    rankOfValue,
+    selectNode,
+    freeze
 };
 BalancedBinaryTreeMethods const * const BalancedBinaryTree = & methods;
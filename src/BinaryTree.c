@@ -1,8 +1,11 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "Class.h"
+#include "Pool.h"
+#include "Sort.h"
 #include "BinaryTree.h"
 
 
@@ -10,14 +13,180 @@
 
 struct _BinaryTree
 {
-    void const * value;
+    _BinaryTreeNode * root;
     int (* compare)(void const * const currentValue, void const * const otherValue);
-    _BinaryTree * parent;
-    _BinaryTree * leftNode;
-    _BinaryTree * rightNode;
+    unsigned int size;
+    _BinaryTreeNode * min;
+    _BinaryTreeNode * max;
+    char const * nodeClassName;
+    _Pool * arena;
+    int ownsArena;
+};
+
+
+struct _BinaryTreeNode
+{
+    void const * value;
+    _BinaryTreeNode * parent;
+    _BinaryTreeNode * leftNode;
+    _BinaryTreeNode * rightNode;
+#ifdef TREE_ORDER_STATISTICS
+    unsigned int weight;
+#endif
 };
 
 
+/**
+ * Number of pending branches the height walk keeps on the call stack before growing on the heap
+ *
+ * Built with TREE_HEIGHT_FALLBACK, the stack is kept tiny and never grows,
+ * so that tests reach the walk through parents taken when growing fails
+ */
+#ifdef TREE_HEIGHT_FALLBACK
+#define BRANCH_HEIGHT_LOCAL_STEPS 2
+#else
+#define BRANCH_HEIGHT_LOCAL_STEPS 64
+#endif
+
+
+/**
+ * A branch left aside by the height walk, and the depth of its top-most node
+ */
+typedef struct
+{
+    _BinaryTreeNode const * node;
+    unsigned int depth;
+} BranchHeightStep;
+
+
+/**
+ * Number of lookups findMany walks down the tree at once
+ */
+#define FIND_MANY_LANES 16
+
+
+/**
+ * Asks for the memory holding the address to be loaded ahead, where the compiler offers it
+ */
+#ifdef __GNUC__
+#define PREFETCH(address) __builtin_prefetch(address)
+#else
+#define PREFETCH(address) ((void) (address))
+#endif
+
+
+/**
+ * A lookup of findMany, the node it reached and the index of the value it looks for
+ */
+typedef struct
+{
+    _BinaryTreeNode * node;
+    unsigned int index;
+} FindManyLane;
+
+
+
+
+/**
+ * @param value - the value the node will hold
+ *
+ * @return - a node without parent nor sons, or NULL if allocation failed
+ */
+static _BinaryTreeNode * constructNode(_BinaryTree const * const this, void const * value);
+
+
+/**
+ * Links nodes into a branch whose top-most node holds the middle value, and whose halves hold the others,
+ * recursion goes as deep as the branch is high, which is logarithmic
+ *
+ * @param values - the sorted values to create nodes for, which must be reserved in the arena
+ * @param nodes - the nodes to link instead, holding sorted values, or NULL to create them
+ * @param first - the index of the first value or node of the branch
+ * @param count - the number of values or nodes of the branch
+ * @param parent - the node the branch hangs from
+ *
+ * @return - the top-most node of the branch, or NULL if there is no value
+ */
+static _BinaryTreeNode * buildBranch(
+    _BinaryTree const * const this,
+    void const * const * const values,
+    _BinaryTreeNode * const * const nodes,
+    unsigned int first,
+    unsigned int count,
+    _BinaryTreeNode * const parent
+);
+
+
+/**
+ * @param last - the node holding the last value added from the batch, or NULL
+ * @param value - the value to add, not lesser than the last one
+ *
+ * @return - the top-most node of the smallest branch above the last node the value belongs to
+ */
+static _BinaryTreeNode * closestBranch(_BinaryTree const * const this, _BinaryTreeNode * last, void const * const value);
+
+
+/**
+ * Adds the sorted values one after the other, each descent starting from the branch of the previous one
+ *
+ * @return - the number of values added, less than count if allocation failed
+ */
+static unsigned int addSortedValues(_BinaryTree * const this, void const * const * const values, unsigned int count);
+
+
+/**
+ * Merges the sorted values with the ones of the tree, and relinks all of them into a tree of the least height
+ *
+ * @return - 1 if the tree was rebuilt, 0 if allocation failed and the tree is left as is
+ */
+static int rebuildWithSortedValues(_BinaryTree * const this, void const * const * const values, unsigned int count);
+
+
+/**
+ * Gives the memory of the node back to the class or to the arena it comes from
+ */
+static void deleteNode(_BinaryTree const * const this, _BinaryTreeNode ** node);
+
+
+/**
+ * Destroys the node and all the nodes below it
+ */
+static void destroyBranch(_BinaryTree const * const this, _BinaryTreeNode ** node);
+
+
+/**
+ * @param node - the node from which to find the value, and deeper
+ *
+ * @return - the first node having the given value, or NULL if not found
+ */
+static _BinaryTreeNode * findValueBelow(_BinaryTree const * const this, _BinaryTreeNode * node, void const * const value);
+
+
+/**
+ * @return - the height of the branch
+ */
+static unsigned int branchHeight(_BinaryTreeNode const * this);
+
+
+/**
+ * Same as branchHeight, walking through parent links instead of a stack, so that it can't fail
+ *
+ * @return - the number of nodes from the node to the deepest one below it
+ */
+static unsigned int branchHeightThroughParents(_BinaryTreeNode const * const this);
+
+
+/**
+ * @return - the number of nodes in the branch, kept in its top-most node when order statistics are enabled
+ */
+static unsigned int branchWeight(_BinaryTreeNode const * const this);
+
+
+/**
+ * Adds the difference to the weight of the node and of all the nodes above it,
+ * does nothing unless order statistics are enabled
+ */
+static void addToWeights(_BinaryTreeNode * this, int difference);
 
 
 /**
@@ -25,47 +194,170 @@ struct _BinaryTree
  *
  * @return - 1 if the value of the node is greater than the other one, 0 otherwise
  */
-static int nodeHasGreaterValue(_BinaryTree const * const this, void const * const value);
+static int nodeHasGreaterValue(_BinaryTree const * const this, _BinaryTreeNode const * const node, void const * const value);
 
 
-static int isLeftSon(_BinaryTree const * const this);
+static int isLeftSon(_BinaryTreeNode const * const this);
 
 
 /**
- * @return - the node whose value is right after this one in the tree
+ * Balanced trees share these functions, and may keep the color of their nodes in the lowest bit of the parent pointer
+ *
+ * @return - the parent of the node, or NULL if it has none
  */
-static _BinaryTree * successor(_BinaryTree * const this);
+static _BinaryTreeNode * parentOf(_BinaryTreeNode const * const this);
 
 
-static _BinaryTree * addValueToTheLeft(_BinaryTree * const this, void const * const value);
+/**
+ * @return - the node having the smallest value in the branch
+ */
+static _BinaryTreeNode * leftMostNode(_BinaryTreeNode * this);
+
+
+/**
+ * @return - the node having the greatest value in the branch
+ */
+static _BinaryTreeNode * rightMostNode(_BinaryTreeNode * this);
+
+
+/**
+ * @return - the node whose value is right after this one in the tree, or NULL if it's the last one
+ */
+static _BinaryTreeNode * nextNode(_BinaryTreeNode * this);
+
+
+/**
+ * @return - the node whose value is right before this one in the tree, or NULL if it's the first one
+ */
+static _BinaryTreeNode * previousNode(_BinaryTreeNode * this);
 
 
-static _BinaryTree * addValueToTheRight(_BinaryTree * const this, void const * const value);
+/**
+ * @return - the node whose value is right after this one in its branch
+ */
+static _BinaryTreeNode * successor(_BinaryTreeNode * const this);
+
+
+/**
+ * Walks down from the node to the empty place of the value, and puts a new leaf there
+ *
+ * @param node - the node from which to add the value, and deeper
+ *
+ * @return - the newly created leaf, or NULL if allocation failed
+ */
+static _BinaryTreeNode * addValueBelow(_BinaryTree * const this, _BinaryTreeNode * node, void const * const value);
+
 
+/**
+ * Counts the newly added leaf in the tree, and updates the bounds if needed
+ */
+static void registerLeaf(_BinaryTree * const this, _BinaryTreeNode * const leaf);
 
-static void attachLeftSonToParent(_BinaryTree * const this);
 
+/**
+ * Links the replacement to the parent of the node, or makes it the root
+ *
+ * @param replacement - the node taking the place, can be NULL
+ */
+static void replaceInParent(_BinaryTree * const this, _BinaryTreeNode const * const node, _BinaryTreeNode * const replacement);
 
-static void attachRightSonToParent(_BinaryTree * const this);
 
+static void attachLeftSonToParent(_BinaryTree * const this, _BinaryTreeNode * const node);
 
-static void replaceNodeWithSuccessor(_BinaryTree * const this);
 
+static void attachRightSonToParent(_BinaryTree * const this, _BinaryTreeNode * const node);
 
 
+static void replaceNodeWithSuccessor(_BinaryTree * const this, _BinaryTreeNode * const node);
 
-static _BinaryTree * constructor(void const * value, int (* compareValuesCallback)(void const * const currentValue, void const * const otherValue))
+
+/**
+ * @return - the deepest node reached by going left whenever possible, right otherwise
+ */
+static _BinaryTreeNode * deepestFirstNode(_BinaryTreeNode * this);
+
+
+/**
+ * @param traversal - the order in which nodes are visited
+ *
+ * @return - the first node to visit in the branch
+ */
+static _BinaryTreeNode * firstInTraversal(_BinaryTreeNode * const this, BinaryTreeTraversal traversal);
+
+
+/**
+ * Steps to the following node by walking parent and son links, without any stack
+ *
+ * @param traversal - the order in which nodes are visited
+ *
+ * @return - the node to visit after this one, or NULL if it was the last one of the tree
+ */
+static _BinaryTreeNode * nextInTraversal(_BinaryTreeNode * this, BinaryTreeTraversal traversal);
+
+
+
+
+static _BinaryTree * constructor(int (* compareValuesCallback)(void const * const currentValue, void const * const otherValue))
 {
     _BinaryTree * this = Class->constructor("BinaryTree", sizeof(* this));
 
     if (this == NULL)
         return NULL;
 
-    this->value = value;
+    this->root = NULL;
     this->compare = compareValuesCallback;
-    this->parent = NULL;
-    this->leftNode = NULL;
-    this->rightNode = NULL;
+    this->size = 0;
+    this->min = NULL;
+    this->max = NULL;
+    this->nodeClassName = "BinaryTreeNode";
+    this->arena = NULL;
+    this->ownsArena = 0;
+
+    return this;
+}
+
+
+static _BinaryTree * arenaConstructor(int (* compareValuesCallback)(void const * const currentValue, void const * const otherValue))
+{
+    _BinaryTree * this = constructor(compareValuesCallback);
+
+    if (this == NULL)
+        return NULL;
+
+    this->arena = Pool->constructor(sizeof(_BinaryTreeNode));
+    if (this->arena == NULL)
+    {
+        Class->destructor("BinaryTree", (void **) & this);
+        return NULL;
+    }
+    this->ownsArena = 1;
+
+    return this;
+}
+
+
+static _BinaryTree * sortedConstructor(
+    int (* compareValuesCallback)(void const * const currentValue, void const * const otherValue),
+    void const * const * const values,
+    unsigned int count
+)
+{
+    _BinaryTree * this = arenaConstructor(compareValuesCallback);
+
+    if ((this == NULL) || (count == 0))
+        return this;
+
+    if (! Pool->reserve(this->arena, count))
+    {
+        Pool->destructor(& this->arena);
+        Class->destructor("BinaryTree", (void **) & this);
+        return NULL;
+    }
+
+    this->root = buildBranch(this, values, NULL, 0, count, NULL);
+    this->size = count;
+    this->min = leftMostNode(this->root);
+    this->max = rightMostNode(this->root);
 
     return this;
 }
@@ -76,35 +368,29 @@ static void destructor(_BinaryTree ** this)
     if ((this == NULL) || (* this == NULL))
         return;
 
-    destructor(& (* this)->parent);
-    destructor(& (* this)->leftNode);
-    destructor(& (* this)->rightNode);
-    Class->destructor((void **) this);
+    if ((* this)->arena == NULL)
+        destroyBranch(* this, & (* this)->root);
+    else if ((* this)->ownsArena)
+        Pool->destructor(& (* this)->arena);
+
+    Class->destructor("BinaryTree", (void **) this);
 }
 
 
-static void const * value(_BinaryTree const * const this)
+static void const * value(_BinaryTreeNode const * const node)
 {
-    if (this == NULL)
+    if (node == NULL)
         return NULL;
-    return this->value;
+    return node->value;
 }
 
 
-static _BinaryTree * findValue(_BinaryTree * const this, void const * const value)
+static _BinaryTreeNode * findValue(_BinaryTree * const this, void const * const value)
 {
-    int comparison;
-
     if (this == NULL)
         return NULL;
 
-    comparison = this->compare(this->value, value);
-
-    if (comparison == 0)
-        return this;
-    if (comparison > 0)
-        return findValue(this->leftNode, value);
-    return findValue(this->rightNode, value);
+    return findValueBelow(this, this->root, value);
 }
 
 
@@ -114,194 +400,1002 @@ static int containsValue(_BinaryTree * const this, void const * const value)
 }
 
 
-static _BinaryTree * addValue(_BinaryTree * const this, void const * const value)
+static unsigned int findMany(
+    _BinaryTree * const this,
+    void const * const * const values,
+    unsigned int count,
+    _BinaryTreeNode ** const results
+)
 {
-    if (nodeHasGreaterValue(this, value))
-        return addValueToTheLeft(this, value);
-    return addValueToTheRight(this, value);
+    FindManyLane lanes[FIND_MANY_LANES];
+    unsigned int started = 0, found = 0, active = 0, lane = 0;
+    int comparison;
+
+    if ((this == NULL) || (results == NULL))
+        return 0;
+
+    for (; (active < FIND_MANY_LANES) && (started < count); active++, started++)
+    {
+        lanes[active].node = this->root;
+        lanes[active].index = started;
+    }
+
+    /* each lane steps one node down in turn, its next node being prefetched while the others step */
+    while (active > 0)
+    {
+        if (lane >= active)
+            lane = 0;
+
+        if (lanes[lane].node == NULL)
+            comparison = 0;
+        else
+        {
+            comparison = this->compare(lanes[lane].node->value, values[lanes[lane].index]);
+            if (comparison != 0)
+            {
+                lanes[lane].node = (comparison > 0) ? lanes[lane].node->leftNode : lanes[lane].node->rightNode;
+                if (lanes[lane].node != NULL)
+                {
+                    PREFETCH(lanes[lane].node);
+                    lane++;
+                    continue;
+                }
+            }
+        }
+
+        /* the lookup is over, the lane starts the next one or takes over the last lane */
+        results[lanes[lane].index] = lanes[lane].node;
+        if (lanes[lane].node != NULL)
+            found++;
+
+        if (started < count)
+        {
+            lanes[lane].node = this->root;
+            lanes[lane].index = started++;
+        }
+        else
+            lanes[lane] = lanes[--active];
+    }
+
+    return found;
 }
 
 
-static unsigned int height(_BinaryTree const * const this)
+static _BinaryTreeNode * addValue(_BinaryTree * const this, void const * const value)
 {
-    int leftHeight, rightHeight;
-
     if (this == NULL)
-        return 0;
+        return NULL;
+
+    if (this->root != NULL)
+        return addValueBelow(this, this->root, value);
 
-    leftHeight = 1 + height(this->leftNode);
-    rightHeight = 1 + height(this->rightNode);
+    this->root = constructNode(this, value);
+    if (this->root == NULL)
+        return NULL;
 
-    if (leftHeight > rightHeight)
-        return leftHeight;
+    this->size = 1;
+    this->min = this->root;
+    this->max = this->root;
 
-    return rightHeight;
+    return this->root;
 }
 
 
-static _BinaryTree * detachNode(_BinaryTree * const this)
+static _BinaryTreeNode * insertOrGet(_BinaryTree * const this, void const * const value, int * const inserted)
 {
-    _BinaryTree * parent;
+    _BinaryTreeNode ** place;
+    _BinaryTreeNode * node = NULL;
+    _BinaryTreeNode * leaf;
+    int comparison = 0;
+
+    if (inserted != NULL)
+        * inserted = 0;
     if (this == NULL)
         return NULL;
 
-    parent = this->parent;
-    if (parent == NULL)
+    for (place = & this->root; * place != NULL; place = (comparison > 0) ? & node->leftNode : & node->rightNode)
+    {
+        node = * place;
+        comparison = this->compare(node->value, value);
+        if (comparison == 0)
+            return node;
+    }
+
+    leaf = constructNode(this, value);
+    if (leaf == NULL)
         return NULL;
 
-    if (isLeftSon(this))
-        parent->leftNode = NULL;
+    * place = leaf;
+    if (node == NULL)
+    {
+        this->size = 1;
+        this->min = leaf;
+        this->max = leaf;
+    }
+    else
+    {
+        leaf->parent = node;
+        registerLeaf(this, leaf);
+        addToWeights(node, 1);
+    }
+
+    if (inserted != NULL)
+        * inserted = 1;
+
+    return leaf;
+}
+
+
+static unsigned int addMany(_BinaryTree * const this, void const * const * const values, unsigned int count)
+{
+    void const ** sortedValues;
+    unsigned int added;
+
+    if ((this == NULL) || (count == 0))
+        return 0;
+
+    sortedValues = malloc(count * sizeof(* sortedValues));
+    if (sortedValues == NULL)
+    {
+        fprintf(stderr, "Memory allocation failed for class %s\n", "BinaryTree");
+        return 0;
+    }
+
+    memcpy(sortedValues, values, count * sizeof(* sortedValues));
+    if (! Sort->values(sortedValues, count, this->compare))
+    {
+        free(sortedValues);
+        return 0;
+    }
+
+    /* relinking every node costs less than descending for each value once the batch outnumbers the tree */
+    if ((count >= this->size) && rebuildWithSortedValues(this, sortedValues, count))
+        added = count;
     else
-        parent->rightNode = NULL;
-    this->parent = NULL;
+        added = addSortedValues(this, sortedValues, count);
+
+    free(sortedValues);
+
+    return added;
+}
+
 
-    return parent;
+static unsigned int size(_BinaryTree const * const this)
+{
+    if (this == NULL)
+        return 0;
+    return this->size;
 }
 
 
-static _BinaryTree * root(_BinaryTree * const this)
+static _BinaryTreeNode * min(_BinaryTree const * const this)
 {
-    _BinaryTree * root = this;
+    if (this == NULL)
+        return NULL;
+    return this->min;
+}
+
 
+static _BinaryTreeNode * max(_BinaryTree const * const this)
+{
     if (this == NULL)
         return NULL;
+    return this->max;
+}
 
-    while (root->parent != NULL)
-        root = root->parent;
 
-    return root;
+static unsigned int height(_BinaryTree const * const this)
+{
+    if (this == NULL)
+        return 0;
+    return branchHeight(this->root);
 }
 
 
-static _BinaryTree * pop(_BinaryTree * const this, void const * const value)
+static _BinaryTree * detachNode(_BinaryTree * const this, _BinaryTreeNode * const node)
 {
-    _BinaryTree * node;
+    _BinaryTree * branch;
+
+    if ((this == NULL) || (node == NULL))
+        return NULL;
+
+    branch = constructor(this->compare);
+    if (branch == NULL)
+        return NULL;
+    branch->nodeClassName = this->nodeClassName;
+    branch->arena = this->arena;
+
+    branch->size = branchWeight(node);
+    addToWeights(parentOf(node), - (int) branch->size);
+
+    replaceInParent(this, node, NULL);
+    node->parent = NULL;
+
+    branch->root = node;
+    branch->min = leftMostNode(node);
+    branch->max = rightMostNode(node);
 
+    this->size -= branch->size;
+    this->min = leftMostNode(this->root);
+    this->max = rightMostNode(this->root);
+
+    return branch;
+}
+
+
+static _BinaryTreeNode * root(_BinaryTree const * const this)
+{
     if (this == NULL)
         return NULL;
+    return this->root;
+}
+
+
+static void const * pop(_BinaryTree * const this, void const * const value)
+{
+    _BinaryTreeNode * node;
+    void const * poppedValue;
 
     node = findValue(this, value);
     if (node == NULL)
         return NULL;
 
+    if (node == this->min)
+        this->min = nextNode(node);
+    if (node == this->max)
+        this->max = previousNode(node);
+
+    /* the successor leaves its place to take the one of the node, above which every branch shrinks */
+    if ((node->leftNode != NULL) && (node->rightNode != NULL))
+        addToWeights(parentOf(successor(node)), -1);
+    else
+        addToWeights(parentOf(node), -1);
+
     if (node->leftNode == NULL)
-        attachRightSonToParent(node);
+        attachRightSonToParent(this, node);
     else if (node->rightNode == NULL)
-        attachLeftSonToParent(node);
+        attachLeftSonToParent(this, node);
     else
-        replaceNodeWithSuccessor(node);
+        replaceNodeWithSuccessor(this, node);
 
-    node->parent = NULL;
+    this->size--;
 
-    return node;
+    poppedValue = node->value;
+    deleteNode(this, & node);
+
+    return poppedValue;
 }
 
 
 static void map(_BinaryTree const * const this, void (* callback)(void const * const value), BinaryTreeTraversal traversal)
 {
+    _BinaryTreeNode * node;
+
     if (this == NULL)
         return;
 
-    if (traversal == PreOrder)
-        callback(this->value);
+    for (node = firstInTraversal(this->root, traversal); node != NULL; node = nextInTraversal(node, traversal))
+        callback(node->value);
+}
 
-    map(this->leftNode, callback, traversal);
 
-    if (traversal == InOrder)
-        callback(this->value);
+static _BinaryTreeNode * next(_BinaryTreeNode * const node)
+{
+    if (node == NULL)
+        return NULL;
+    return nextNode(node);
+}
 
-    map(this->rightNode, callback, traversal);
 
-    if (traversal == PostOrder)
-        callback(this->value);
+static _BinaryTreeNode * previous(_BinaryTreeNode * const node)
+{
+    if (node == NULL)
+        return NULL;
+    return previousNode(node);
 }
 
 
+static _BinaryTreeNode * seek(_BinaryTree const * const this, void const * const value)
+{
+    _BinaryTreeNode * node, * found = NULL;
+
+    if (this == NULL)
+        return NULL;
+
+    /* equal values are added to the right, going left on them reaches the first one */
+    node = this->root;
+    while (node != NULL)
+    {
+        if (this->compare(node->value, value) >= 0)
+        {
+            found = node;
+            node = node->leftNode;
+        }
+        else
+            node = node->rightNode;
+    }
+
+    return found;
+}
 
 
-static int nodeHasGreaterValue(_BinaryTree const * const this, void const * const value)
+static _BinaryTreeNode * upperBound(_BinaryTree const * const this, void const * const value)
 {
-    return this->compare(this->value, value) > 0;
+    _BinaryTreeNode * node, * found = NULL;
+
+    if (this == NULL)
+        return NULL;
+
+    node = this->root;
+    while (node != NULL)
+    {
+        if (this->compare(node->value, value) > 0)
+        {
+            found = node;
+            node = node->leftNode;
+        }
+        else
+            node = node->rightNode;
+    }
+
+    return found;
 }
 
 
-static int isLeftSon(_BinaryTree const * const this)
+static _BinaryTreeNode * floorNode(_BinaryTree const * const this, void const * const value)
 {
-    return (this->parent != NULL) && (this->parent->leftNode == this);
+    _BinaryTreeNode * node, * found = NULL;
+
+    if (this == NULL)
+        return NULL;
+
+    node = this->root;
+    while (node != NULL)
+    {
+        if (this->compare(node->value, value) <= 0)
+        {
+            found = node;
+            node = node->rightNode;
+        }
+        else
+            node = node->leftNode;
+    }
+
+    return found;
 }
 
 
-static _BinaryTree * successor(_BinaryTree * const this)
+static void mapRange(
+    _BinaryTree const * const this,
+    void const * const lowest,
+    void const * const greatest,
+    void (* callback)(void const * const value)
+)
 {
-    _BinaryTree * successor;
+    _BinaryTreeNode * node;
+
+    /* stepping from the lower bound only climbs into branches holding values in the range */
+    for (node = seek(this, lowest); node != NULL; node = nextNode(node))
+    {
+        if (this->compare(node->value, greatest) > 0)
+            return;
+        callback(node->value);
+    }
+}
 
-    successor = this->leftNode;
-    while (successor->rightNode != NULL)
-        successor = successor->rightNode;
 
-    return successor;
+static unsigned int rankOfValue(_BinaryTree const * const this, void const * const value)
+{
+    _BinaryTreeNode * node;
+    unsigned int lesserValues = 0;
+
+    if (this == NULL)
+        return 0;
+
+    /* every branch left aside on the right way down holds lesser values only */
+    node = this->root;
+    while (node != NULL)
+    {
+        if (this->compare(node->value, value) < 0)
+        {
+            lesserValues += branchWeight(node->leftNode) + 1;
+            node = node->rightNode;
+        }
+        else
+            node = node->leftNode;
+    }
+
+    return lesserValues;
 }
 
 
-static _BinaryTree * addValueToTheLeft(_BinaryTree * const this, void const * const value)
+static _BinaryTreeNode * selectNode(_BinaryTree const * const this, unsigned int index)
 {
-    if (this->leftNode != NULL)
-        return addValue(this->leftNode, value);
+    _BinaryTreeNode * node;
+#ifdef TREE_ORDER_STATISTICS
+    unsigned int lesserValues;
+#endif
+
+    if ((this == NULL) || (index >= this->size))
+        return NULL;
 
-    this->leftNode = constructor(value, this->compare);
-    this->leftNode->parent = this;
+#ifdef TREE_ORDER_STATISTICS
+    node = this->root;
+    for (;;)
+    {
+        lesserValues = branchWeight(node->leftNode);
+        if (index == lesserValues)
+            return node;
+
+        if (index < lesserValues)
+            node = node->leftNode;
+        else
+        {
+            index -= lesserValues + 1;
+            node = node->rightNode;
+        }
+    }
+#else
+    for (node = this->min; index > 0; index--)
+        node = nextNode(node);
 
-    return this->leftNode;
+    return node;
+#endif
 }
 
 
-static _BinaryTree * addValueToTheRight(_BinaryTree * const this, void const * const value)
+static _FrozenTree * freeze(_BinaryTree const * const this, FrozenTreeLayout layout)
 {
-    if (this->rightNode != NULL)
-        return addValue(this->rightNode, value);
+    void const ** values;
+    _BinaryTreeNode * node;
+    _FrozenTree * frozen;
+    unsigned int i = 0;
+
+    if (this == NULL)
+        return NULL;
+
+    values = malloc((this->size + 1UL) * sizeof(* values));
+    if (values == NULL)
+    {
+        fprintf(stderr, "Memory allocation failed for class %s\n", "BinaryTree");
+        return NULL;
+    }
 
-    this->rightNode = constructor(value, this->compare);
-    this->rightNode->parent = this;
+    for (node = this->min; node != NULL; node = nextNode(node))
+        values[i++] = node->value;
 
-    return this->rightNode;
+    frozen = FrozenTree->constructor(this->compare, values, this->size, layout);
+    free(values);
+
+    return frozen;
 }
 
 
-static void attachLeftSonToParent(_BinaryTree * const this)
+
+
+static _BinaryTreeNode * constructNode(_BinaryTree const * const this, void const * value)
 {
-    if (isLeftSon(this))
-        this->parent->leftNode = this->leftNode;
+    _BinaryTreeNode * node;
+
+    if (this->arena != NULL)
+        node = Pool->allocate(this->arena);
     else
-        this->parent->rightNode = this->leftNode;
+        node = Class->constructor(this->nodeClassName, sizeof(* node));
+
+    if (node == NULL)
+        return NULL;
 
-    this->leftNode = NULL;
+    node->value = value;
+    node->parent = NULL;
+    node->leftNode = NULL;
+    node->rightNode = NULL;
+#ifdef TREE_ORDER_STATISTICS
+    node->weight = 1;
+#endif
+
+    return node;
 }
 
 
-static void attachRightSonToParent(_BinaryTree * const this)
+static _BinaryTreeNode * buildBranch(
+    _BinaryTree const * const this,
+    void const * const * const values,
+    _BinaryTreeNode * const * const nodes,
+    unsigned int first,
+    unsigned int count,
+    _BinaryTreeNode * const parent
+)
 {
-    if (isLeftSon(this))
-        this->parent->leftNode = this->rightNode;
-    else
-        this->parent->rightNode = this->rightNode;
+    unsigned int middle = first + count / 2;
+    _BinaryTreeNode * node;
+
+    if (count == 0)
+        return NULL;
+
+    node = (nodes != NULL) ? nodes[middle] : constructNode(this, values[middle]);
+    node->parent = parent;
+    node->leftNode = buildBranch(this, values, nodes, first, middle - first, node);
+    node->rightNode = buildBranch(this, values, nodes, middle + 1, first + count - middle - 1, node);
+#ifdef TREE_ORDER_STATISTICS
+    node->weight = count;
+#endif
+
+    return node;
+}
+
+
+static _BinaryTreeNode * closestBranch(_BinaryTree const * const this, _BinaryTreeNode * last, void const * const value)
+{
+    if (last == NULL)
+        return this->root;
+
+    /* the branch of a left son only holds values lesser than its parent */
+    while (parentOf(last) != NULL)
+    {
+        if (isLeftSon(last) && nodeHasGreaterValue(this, parentOf(last), value))
+            return last;
+        last = parentOf(last);
+    }
+
+    return last;
+}
+
+
+static unsigned int addSortedValues(_BinaryTree * const this, void const * const * const values, unsigned int count)
+{
+    _BinaryTreeNode * last = NULL;
+    unsigned int i;
+
+    for (i = 0; i < count; i++)
+    {
+        if (this->root == NULL)
+            last = addValue(this, values[i]);
+        else
+            last = addValueBelow(this, closestBranch(this, last, values[i]), values[i]);
+
+        if (last == NULL)
+            break;
+    }
+
+    return i;
+}
+
+
+static int rebuildWithSortedValues(_BinaryTree * const this, void const * const * const values, unsigned int count)
+{
+    unsigned int total = this->size + count, i, added = 0;
+    _BinaryTreeNode ** nodes, * node;
+
+    nodes = malloc(total * sizeof(* nodes));
+    if (nodes == NULL)
+    {
+        fprintf(stderr, "Memory allocation failed for class %s\n", "BinaryTree");
+        return 0;
+    }
+
+    /* equal values go after the ones already in the tree, as they would when added one by one */
+    node = this->min;
+    for (i = 0; i < total; i++)
+    {
+        if ((added == count) || ((node != NULL) && ! nodeHasGreaterValue(this, node, values[added])))
+        {
+            nodes[i] = node;
+            node = nextNode(node);
+            continue;
+        }
+
+        nodes[i] = constructNode(this, values[added]);
+        if (nodes[i] == NULL)
+        {
+            while (i-- > 0)
+                if ((parentOf(nodes[i]) == NULL) && (nodes[i] != this->root))
+                    deleteNode(this, & nodes[i]);
+            free(nodes);
+            return 0;
+        }
+        added++;
+    }
+
+    this->root = buildBranch(this, NULL, nodes, 0, total, NULL);
+    this->size = total;
+    this->min = nodes[0];
+    this->max = nodes[total - 1];
+
+    free(nodes);
+
+    return 1;
+}
+
+
+static void deleteNode(_BinaryTree const * const this, _BinaryTreeNode ** node)
+{
+    if (this->arena == NULL)
+    {
+        Class->destructor(this->nodeClassName, (void **) node);
+        return;
+    }
+
+    Pool->release(this->arena, * node);
+    * node = NULL;
+}
+
+
+static void destroyBranch(_BinaryTree const * const this, _BinaryTreeNode ** node)
+{
+    _BinaryTreeNode * current, * next;
+
+    if ((node == NULL) || (* node == NULL))
+        return;
+
+    /* sons are deleted before their parent, whose links are all that's needed to step */
+    current = firstInTraversal(* node, PostOrder);
+    while (current != NULL)
+    {
+        next = nextInTraversal(current, PostOrder);
+        deleteNode(this, & current);
+        current = next;
+    }
+
+    * node = NULL;
+}
+
+
+static _BinaryTreeNode * findValueBelow(_BinaryTree const * const this, _BinaryTreeNode * node, void const * const value)
+{
+    int comparison;
+
+    while (node != NULL)
+    {
+        comparison = this->compare(node->value, value);
+
+        if (comparison == 0)
+            return node;
+        node = (comparison > 0) ? node->leftNode : node->rightNode;
+    }
+
+    return NULL;
+}
+
+
+static unsigned int branchHeight(_BinaryTreeNode const * this)
+{
+    BranchHeightStep localSteps[BRANCH_HEIGHT_LOCAL_STEPS];
+    BranchHeightStep * steps = localSteps, * grownSteps;
+    _BinaryTreeNode const * const top = this;
+    unsigned int capacity = BRANCH_HEIGHT_LOCAL_STEPS, pending = 0;
+    unsigned int depth = 1, height = 0;
+
+    if (this == NULL)
+        return 0;
+
+    /* pre-order walk, right sons wait on a stack along with their depth */
+    for (;;)
+    {
+        if (depth > height)
+            height = depth;
+
+        if ((this->leftNode != NULL) && (this->rightNode != NULL))
+        {
+            if (pending == capacity)
+            {
+#ifdef TREE_HEIGHT_FALLBACK
+                grownSteps = NULL;
+#else
+                grownSteps = malloc(2 * capacity * sizeof(* steps));
+#endif
+                /* the height of the part walked so far would be wrong, the branch is walked again without a stack */
+                if (grownSteps == NULL)
+                {
+                    if (steps != localSteps)
+                        free(steps);
+                    return branchHeightThroughParents(top);
+                }
+                memcpy(grownSteps, steps, capacity * sizeof(* steps));
+                if (steps != localSteps)
+                    free(steps);
+                steps = grownSteps;
+                capacity *= 2;
+            }
+
+            steps[pending].node = this->rightNode;
+            steps[pending].depth = depth + 1;
+            pending++;
+        }
+
+        if ((this->leftNode != NULL) || (this->rightNode != NULL))
+        {
+            this = (this->leftNode != NULL) ? this->leftNode : this->rightNode;
+            depth++;
+        }
+        else if (pending > 0)
+        {
+            pending--;
+            this = steps[pending].node;
+            depth = steps[pending].depth;
+        }
+        else
+            break;
+    }
+
+    if (steps != localSteps)
+        free(steps);
+
+    return height;
+}
+
+
+static unsigned int branchHeightThroughParents(_BinaryTreeNode const * const this)
+{
+    _BinaryTreeNode const * node = this;
+    unsigned int depth = 1, height = 0;
+
+    if (this == NULL)
+        return 0;
 
-    this->rightNode = NULL;
+    /* pre-order walk, climbing back up to the next right son without leaving the branch */
+    for (;;)
+    {
+        if (depth > height)
+            height = depth;
+
+        if ((node->leftNode != NULL) || (node->rightNode != NULL))
+        {
+            node = (node->leftNode != NULL) ? node->leftNode : node->rightNode;
+            depth++;
+            continue;
+        }
+
+        while ((node != this) && ! (isLeftSon(node) && (parentOf(node)->rightNode != NULL)))
+        {
+            node = parentOf(node);
+            depth--;
+        }
+        if (node == this)
+            return height;
+
+        node = parentOf(node)->rightNode;
+    }
 }
 
 
-static void replaceNodeWithSuccessor(_BinaryTree * const this)
+static unsigned int branchWeight(_BinaryTreeNode const * const this)
 {
-    _BinaryTree * succeeding = successor(this);
+#ifdef TREE_ORDER_STATISTICS
+    if (this == NULL)
+        return 0;
+    return this->weight;
+#else
+    _BinaryTreeNode * node, * last;
+    unsigned int count = 1;
+
+    if (this == NULL)
+        return 0;
+
+    /* the branch may have a parent, stepping in order between its bounds doesn't leave it */
+    last = rightMostNode((_BinaryTreeNode *) this);
+    for (node = leftMostNode((_BinaryTreeNode *) this); node != last; node = nextNode(node))
+        count++;
+
+    return count;
+#endif
+}
+
+
+static void addToWeights(_BinaryTreeNode * this, int difference)
+{
+#ifdef TREE_ORDER_STATISTICS
+    for (; this != NULL; this = parentOf(this))
+        this->weight += difference;
+#else
+    (void) this;
+    (void) difference;
+#endif
+}
+
+
+static int nodeHasGreaterValue(_BinaryTree const * const this, _BinaryTreeNode const * const node, void const * const value)
+{
+    return this->compare(node->value, value) > 0;
+}
+
+
+static int isLeftSon(_BinaryTreeNode const * const this)
+{
+    return (parentOf(this) != NULL) && (parentOf(this)->leftNode == this);
+}
+
+
+static _BinaryTreeNode * parentOf(_BinaryTreeNode const * const this)
+{
+#ifdef TREE_PACKED_COLORS
+    return (_BinaryTreeNode *) ((size_t) this->parent & ~(size_t) 1);
+#else
+    return this->parent;
+#endif
+}
+
+
+static _BinaryTreeNode * leftMostNode(_BinaryTreeNode * this)
+{
+    if (this == NULL)
+        return NULL;
+
+    while (this->leftNode != NULL)
+        this = this->leftNode;
+
+    return this;
+}
+
+
+static _BinaryTreeNode * rightMostNode(_BinaryTreeNode * this)
+{
+    if (this == NULL)
+        return NULL;
+
+    while (this->rightNode != NULL)
+        this = this->rightNode;
+
+    return this;
+}
+
+
+static _BinaryTreeNode * nextNode(_BinaryTreeNode * this)
+{
+    if (this->rightNode != NULL)
+        return leftMostNode(this->rightNode);
+
+    while ((parentOf(this) != NULL) && ! isLeftSon(this))
+        this = parentOf(this);
+
+    return parentOf(this);
+}
+
+
+static _BinaryTreeNode * previousNode(_BinaryTreeNode * this)
+{
+    if (this->leftNode != NULL)
+        return rightMostNode(this->leftNode);
+
+    while (isLeftSon(this))
+        this = parentOf(this);
+
+    return parentOf(this);
+}
+
 
-    if (isLeftSon(this))
-        this->parent->leftNode = succeeding;
+static _BinaryTreeNode * successor(_BinaryTreeNode * const this)
+{
+    return leftMostNode(this->rightNode);
+}
+
+
+static _BinaryTreeNode * addValueBelow(_BinaryTree * const this, _BinaryTreeNode * node, void const * const value)
+{
+    _BinaryTreeNode ** place;
+    _BinaryTreeNode * leaf;
+
+    for (;;)
+    {
+        place = nodeHasGreaterValue(this, node, value) ? & node->leftNode : & node->rightNode;
+        if (* place == NULL)
+            break;
+        node = * place;
+    }
+
+    leaf = constructNode(this, value);
+    if (leaf == NULL)
+        return NULL;
+
+    leaf->parent = node;
+    * place = leaf;
+    registerLeaf(this, leaf);
+    addToWeights(node, 1);
+
+    return leaf;
+}
+
+
+static void registerLeaf(_BinaryTree * const this, _BinaryTreeNode * const leaf)
+{
+    this->size++;
+
+    if ((parentOf(leaf) == this->min) && isLeftSon(leaf))
+        this->min = leaf;
+    else if ((parentOf(leaf) == this->max) && ! isLeftSon(leaf))
+        this->max = leaf;
+}
+
+
+static void replaceInParent(_BinaryTree * const this, _BinaryTreeNode const * const node, _BinaryTreeNode * const replacement)
+{
+    if (replacement != NULL)
+        replacement->parent = parentOf(node);
+
+    if (parentOf(node) == NULL)
+        this->root = replacement;
+    else if (isLeftSon(node))
+        parentOf(node)->leftNode = replacement;
     else
-        this->parent->rightNode = succeeding;
+        parentOf(node)->rightNode = replacement;
+}
+
+
+static void attachLeftSonToParent(_BinaryTree * const this, _BinaryTreeNode * const node)
+{
+    replaceInParent(this, node, node->leftNode);
+}
+
+
+static void attachRightSonToParent(_BinaryTree * const this, _BinaryTreeNode * const node)
+{
+    replaceInParent(this, node, node->rightNode);
+}
+
+
+static void replaceNodeWithSuccessor(_BinaryTree * const this, _BinaryTreeNode * const node)
+{
+    _BinaryTreeNode * succeeding = successor(node);
+
+    if (parentOf(succeeding) != node)
+    {
+        attachRightSonToParent(this, succeeding);
+        succeeding->rightNode = node->rightNode;
+        succeeding->rightNode->parent = succeeding;
+    }
+
+    replaceInParent(this, node, succeeding);
+    succeeding->leftNode = node->leftNode;
+    succeeding->leftNode->parent = succeeding;
+#ifdef TREE_ORDER_STATISTICS
+    succeeding->weight = node->weight;
+#endif
+}
+
+
+static _BinaryTreeNode * deepestFirstNode(_BinaryTreeNode * this)
+{
+    while ((this->leftNode != NULL) || (this->rightNode != NULL))
+        this = (this->leftNode != NULL) ? this->leftNode : this->rightNode;
+
+    return this;
+}
+
+
+static _BinaryTreeNode * firstInTraversal(_BinaryTreeNode * const this, BinaryTreeTraversal traversal)
+{
+    if (this == NULL)
+        return NULL;
+
+    if (traversal == PreOrder)
+        return this;
+    if (traversal == InOrder)
+        return leftMostNode(this);
+    return deepestFirstNode(this);
+}
+
+
+static _BinaryTreeNode * nextInTraversal(_BinaryTreeNode * this, BinaryTreeTraversal traversal)
+{
+    if (traversal == InOrder)
+        return nextNode(this);
+
+    if (traversal == PostOrder)
+    {
+        if (isLeftSon(this) && (parentOf(this)->rightNode != NULL))
+            return deepestFirstNode(parentOf(this)->rightNode);
+        return parentOf(this);
+    }
+
+    if (this->leftNode != NULL)
+        return this->leftNode;
+    if (this->rightNode != NULL)
+        return this->rightNode;
 
-    succeeding->rightNode = this->rightNode;
+    for (; parentOf(this) != NULL; this = parentOf(this))
+        if (isLeftSon(this) && (parentOf(this)->rightNode != NULL))
+            return parentOf(this)->rightNode;
 
-    this->leftNode = NULL;
-    this->rightNode = NULL;
+    return NULL;
 }
 
 
@@ -312,15 +1406,32 @@ static void replaceNodeWithSuccessor(_BinaryTree * const this)
  */
 static BinaryTreeMethods methods = {
     constructor,
+    arenaConstructor,
+    sortedConstructor,
     destructor,
     value,
     findValue,
     containsValue,
+    findMany,
     addValue,
+    insertOrGet,
+    addMany,
+    size,
+    min,
+    max,
     height,
     detachNode,
     root,
     pop,
-    map
+    map,
+    next,
+    previous,
+    seek,
+    upperBound,
+    floorNode,
+    mapRange,
+    rankOfValue,
+    selectNode,
+    freeze
 };
 BinaryTreeMethods const * const BinaryTree = & methods;
@@ -1,10 +1,14 @@
-
 #ifndef BINARY_TREE_CLASS_HEADER
 #define BINARY_TREE_CLASS_HEADER
 
 
 
 
+#include "FrozenTree.h"
+
+
+
+
 /**
  * Ways to travel a tree
  */
@@ -18,77 +22,173 @@ typedef enum
 
 
 
+/**
+ * A tree, owning its nodes and knowing how to compare their values
+ */
 typedef struct _BinaryTree _BinaryTree;
 
 
+/**
+ * A node of a tree, holding one value
+ */
+typedef struct _BinaryTreeNode _BinaryTreeNode;
+
+
 
 
 typedef struct
 {
     /**
-     * @param value - the value of the root
-     * @param compareCallback - the callback to compare future elements with, should return :
+     * @param compareCallback - the callback to compare elements with, should return :
      *  < 0 if current value is smaller,
      *  > 0 if other value is smaller,
      *  = 0 if both are equal
+     *
+     * @return - an empty tree, or NULL if allocation failed
      */
     _BinaryTree * (* constructor)(
-        void const * value,
         int (* compareValuesCallback)(void const * const currentValue, void const * const otherValue)
     );
 
     /**
-     * Destroys all nodes and sets them all to NULL
+     * Same as constructor, but nodes are carved from a region owned by the tree,
+     * which the destructor gives back at once instead of deleting nodes one by one
+     *
+     * Branches detached from the tree keep their nodes in that region,
+     * so they must be destroyed before the tree
+     */
+    _BinaryTree * (* arenaConstructor)(
+        int (* compareValuesCallback)(void const * const currentValue, void const * const otherValue)
+    );
+
+    /**
+     * Builds a tree of the least height out of sorted values, in linear time
+     *
+     * Nodes are carved from a single block owned by the tree, as with arenaConstructor
+     *
+     * @param values - the values to store, sorted according to the callback
+     * @param count - the number of values
+     *
+     * @return - a tree holding the values, or NULL if allocation failed
+     */
+    _BinaryTree * (* sortedConstructor)(
+        int (* compareValuesCallback)(void const * const currentValue, void const * const otherValue),
+        void const * const * const values,
+        unsigned int count
+    );
+
+    /**
+     * Destroys the tree and all its nodes, and sets it to NULL
      */
     void (* destructor)(_BinaryTree ** this);
 
     /**
      * @return - the value of the node, or NULL if node is NULL
      */
-    void const * (* value)(_BinaryTree const * const this);
+    void const * (* value)(_BinaryTreeNode const * const node);
 
     /**
-     * @param value - the value to find from the node and deeper in the tree
+     * @param value - the value to find in the tree
      *
      * @return - the first node having the given value, or NULL if not found
      */
-    _BinaryTree * (* find)(_BinaryTree * const this, void const * const value);
+    _BinaryTreeNode * (* find)(_BinaryTree * const this, void const * const value);
 
     /**
-     * @param value - the value to find from the node and deeper in the tree
+     * @param value - the value to find in the tree
      *
-     * @return - 1 if the value was found from the node or deeper, 0 otherwise
+     * @return - 1 if the value was found in the tree, 0 otherwise
      */
     int (* contains)(_BinaryTree * const this, void const * const value);
 
     /**
+     * Finds a batch of values, walking several of them down the tree at once
+     * so that waiting for a node to be loaded from memory overlaps with the other walks
+     *
+     * @param values - the values to find
+     * @param count - the number of values
+     * @param results - filled with the first node having each value, or NULL if it was not found
+     *
+     * @return - the number of values found
+     */
+    unsigned int (* findMany)(
+        _BinaryTree * const this,
+        void const * const * const values,
+        unsigned int count,
+        _BinaryTreeNode ** const results
+    );
+
+    /**
+     * @param value - the value to add in the tree
+     *
+     * @return - the newly created node, or NULL if tree is NULL or allocation failed
+     */
+    _BinaryTreeNode * (* add)(_BinaryTree * const this, void const * const value);
+
+    /**
+     * Adds the value unless an equal one is already in the tree, walking down the tree once for both
+     *
      * @param value - the value to add in the tree
+     * @param inserted - set to 1 if a node was created, 0 otherwise, can be NULL
      *
-     * @return - the constructorly created node
+     * @return - the node having an equal value if there was one, the newly created node otherwise,
+     *  or NULL if tree is NULL or allocation failed
      */
-    _BinaryTree * (* add)(_BinaryTree * const this, void const * const value);
+    _BinaryTreeNode * (* insertOrGet)(_BinaryTree * const this, void const * const value, int * const inserted);
 
     /**
-     * @return - the height of the tree from the given node
+     * Adds a batch of values, sorted first so that they can be added in a single ordered pass,
+     * or merged with the values of the tree into a rebuilt tree if the batch is at least as large
+     *
+     * @param values - the values to add, in any order
+     * @param count - the number of values
+     *
+     * @return - the number of values added, less than count if allocation failed
+     */
+    unsigned int (* addMany)(_BinaryTree * const this, void const * const * const values, unsigned int count);
+
+    /**
+     * @return - the number of values in the tree
+     */
+    unsigned int (* size)(_BinaryTree const * const this);
+
+    /**
+     * @return - the node having the smallest value, or NULL if tree is empty
+     */
+    _BinaryTreeNode * (* min)(_BinaryTree const * const this);
+
+    /**
+     * @return - the node having the greatest value, or NULL if tree is empty
+     */
+    _BinaryTreeNode * (* max)(_BinaryTree const * const this);
+
+    /**
+     * @return - the height of the tree
      */
     unsigned int (* height)(_BinaryTree const * const this);
 
     /**
-     * Detaches the whole branch from its parent
+     * Detaches the whole branch from the tree
+     *
+     * @param node - the top-most node of the branch
      *
-     * @return - the parent of the detached node, or NULL if node is NULL
+     * @return - a new tree made of the branch, or NULL if tree or node is NULL
      */
-    _BinaryTree * (* detach)(_BinaryTree * const this);
+    _BinaryTree * (* detach)(_BinaryTree * const this, _BinaryTreeNode * const node);
 
-    _BinaryTree * (* root)(_BinaryTree * const this);
+    /**
+     * @return - the top-most node of the tree, or NULL if tree is empty
+     */
+    _BinaryTreeNode * (* root)(_BinaryTree const * const this);
 
     /**
-     * @param this - the node from which to find the value, and deeper
+     * Removes the node holding the value from the tree, and destroys it
+     *
      * @param value - the value to pop from the tree
      *
-     * @return - the popped node, or NULL if it was not found
+     * @return - the value which was stored in the tree, or NULL if it was not found
      */
-    _BinaryTree * (* pop)(_BinaryTree * const this, void const * const value);
+    void const * (* pop)(_BinaryTree * const this, void const * const value);
 
     /**
      * Applies the callback on every node in the tree
@@ -100,6 +200,85 @@ typedef struct
         void (* callback)(void const * const value),
         BinaryTreeTraversal traversal
     );
+
+    /**
+     * Steps forward through the values, nodes stay valid until popped,
+     * so walking from min or from seek can be paused and resumed at will
+     *
+     * @return - the node having the value right after this one, or NULL if node is NULL or the last one
+     */
+    _BinaryTreeNode * (* next)(_BinaryTreeNode * const node);
+
+    /**
+     * Steps backward through the values, from max or from any other node
+     *
+     * @return - the node having the value right before this one, or NULL if node is NULL or the first one
+     */
+    _BinaryTreeNode * (* previous)(_BinaryTreeNode * const node);
+
+    /**
+     * @param value - the value to step to
+     *
+     * @return - the first node whose value isn't lesser than the given one, or NULL if there is none
+     */
+    _BinaryTreeNode * (* seek)(_BinaryTree const * const this, void const * const value);
+
+    /**
+     * @param value - the value to step past
+     *
+     * @return - the first node whose value is greater than the given one, or NULL if there is none
+     */
+    _BinaryTreeNode * (* upperBound)(_BinaryTree const * const this, void const * const value);
+
+    /**
+     * @param value - the value to step back to
+     *
+     * @return - the last node whose value isn't greater than the given one, or NULL if there is none
+     */
+    _BinaryTreeNode * (* floor)(_BinaryTree const * const this, void const * const value);
+
+    /**
+     * Applies the callback on every value between the bounds, in order,
+     * without visiting the branches outside of them
+     *
+     * @param lowest - the smallest value to visit
+     * @param greatest - the greatest value to visit
+     * @param callback - the callback to apply on each value
+     */
+    void (* mapRange)(
+        _BinaryTree const * const this,
+        void const * const lowest,
+        void const * const greatest,
+        void (* callback)(void const * const value)
+    );
+
+    /**
+     * Runs in logarithmic time when built with TREE_ORDER_STATISTICS, in linear time otherwise
+     *
+     * @param value - the value to rank
+     *
+     * @return - the number of values lesser than the given one in the tree
+     */
+    unsigned int (* rank)(_BinaryTree const * const this, void const * const value);
+
+    /**
+     * Runs in logarithmic time when built with TREE_ORDER_STATISTICS, in linear time otherwise
+     *
+     * @param index - the number of values lesser than the one to find
+     *
+     * @return - the node having the index-th smallest value, or NULL if index isn't lesser than the size
+     */
+    _BinaryTreeNode * (* select)(_BinaryTree const * const this, unsigned int index);
+
+    /**
+     * Takes a read-only snapshot of the values, which stays valid once the tree is destroyed,
+     * to be searched without loading any node
+     *
+     * @param layout - the order to lay values out in
+     *
+     * @return - a snapshot holding the values of the tree, or NULL if tree is NULL or allocation failed
+     */
+    _FrozenTree * (* freeze)(_BinaryTree const * const this, FrozenTreeLayout layout);
 } BinaryTreeMethods;
 
 
@@ -1,33 +1,179 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "Class.h"
+#include "Pool.h"
+
+
+
+
+#ifdef CLASS_POOLS
+#define CLASS_POOLS_ENABLED 1
+#else
+#define CLASS_POOLS_ENABLED 0
+#endif
+
+
+/**
+ * Allocation state of a class
+ */
+typedef struct _ClassEntry
+{
+    char const * className;
+    _Pool * pool;
+    unsigned long allocations;
+    unsigned long deallocations;
+    struct _ClassEntry * next;
+} ClassEntry;
+
+
+
+
+static ClassEntry * entries = NULL;
+
+
+static int poolsEnabled = CLASS_POOLS_ENABLED;
+
+
+
+
+/**
+ * @param className - the name of the class to find the state of
+ *
+ * @return - the state of the class, or NULL if the class was never allocated
+ */
+static ClassEntry * findEntry(char const * const className);
+
+
+/**
+ * @return - the state of the class, created if needed, or NULL if allocation failed
+ */
+static ClassEntry * findOrAddEntry(char const * const className, unsigned int blockSize);
 
 
 
 
 static void * Class_allocate(char const * const className, unsigned int blockSize)
 {
-    void * this = malloc(blockSize);
+    ClassEntry * entry = findOrAddEntry(className, blockSize);
+    void * this;
+
+    if ((entry != NULL) && (entry->pool != NULL))
+        this = Pool->allocate(entry->pool);
+    else
+        this = malloc(blockSize);
 
     if (this == NULL)
+    {
         fprintf(stderr, "Memory allocation failed for class %s\n", className);
+        return NULL;
+    }
+
+    if (entry != NULL)
+        entry->allocations++;
 
     return this;
 }
 
 
-static void Class_deallocate(void ** this)
+static void Class_deallocate(char const * const className, void ** this)
 {
+    ClassEntry * entry;
+
     if ((this == NULL) || (* this == NULL))
         return;
 
-    free(* this);
+    entry = findEntry(className);
+    if (entry != NULL)
+        entry->deallocations++;
+
+    if ((entry != NULL) && (entry->pool != NULL))
+        Pool->release(entry->pool, * this);
+    else
+        free(* this);
     * this = NULL;
 }
 
 
+static void Class_usePools(int enabled)
+{
+    poolsEnabled = enabled;
+}
+
+
+static ClassStatistics Class_statistics(char const * const className)
+{
+    ClassEntry * entry = findEntry(className);
+    PoolStatistics poolStatistics;
+    ClassStatistics statistics;
+
+    if (entry == NULL)
+    {
+        statistics.allocations = 0;
+        statistics.deallocations = 0;
+    }
+    else
+    {
+        statistics.allocations = entry->allocations;
+        statistics.deallocations = entry->deallocations;
+    }
+
+    poolStatistics = Pool->statistics((entry == NULL) ? NULL : entry->pool);
+    statistics.pooledAllocations = poolStatistics.allocations;
+    statistics.reusedAllocations = poolStatistics.reuses;
+    statistics.chunks = poolStatistics.chunks;
+
+    return statistics;
+}
+
+
+
+
+static ClassEntry * findEntry(char const * const className)
+{
+    ClassEntry * entry;
+
+    /* class names are usually the same literal, compare addresses first */
+    for (entry = entries; entry != NULL; entry = entry->next)
+        if (entry->className == className)
+            return entry;
+
+    for (entry = entries; entry != NULL; entry = entry->next)
+        if (strcmp(entry->className, className) == 0)
+            return entry;
+
+    return NULL;
+}
+
+
+static ClassEntry * findOrAddEntry(char const * const className, unsigned int blockSize)
+{
+    ClassEntry * entry = findEntry(className);
+
+    if (entry != NULL)
+        return entry;
+
+    entry = malloc(sizeof(* entry));
+    if (entry == NULL)
+        return NULL;
+
+    entry->className = className;
+    entry->pool = NULL;
+    entry->allocations = 0;
+    entry->deallocations = 0;
+
+    if (poolsEnabled)
+        entry->pool = Pool->constructor(blockSize);
+
+    entry->next = entries;
+    entries = entry;
+
+    return entry;
+}
+
+
 
 
 /**
@@ -35,6 +181,8 @@ static void Class_deallocate(void ** this)
  */
 static ClassMethods methods = {
     Class_allocate,
-    Class_deallocate
+    Class_deallocate,
+    Class_usePools,
+    Class_statistics
 };
 ClassMethods const * const Class = & methods;
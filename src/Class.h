@@ -1,12 +1,49 @@
-
 #ifndef CLASS_HEADER
 #define CLASS_HEADER
 
 
 
 
+/**
+ * Counters of allocations made for a class
+ */
+typedef struct
+{
+    /**
+     * Number of instances allocated
+     */
+    unsigned long allocations;
+
+    /**
+     * Number of instances deleted
+     */
+    unsigned long deallocations;
+
+    /**
+     * Number of instances allocated from the pool of the class
+     */
+    unsigned long pooledAllocations;
+
+    /**
+     * Number of pooled instances reusing the memory of a deleted one
+     */
+    unsigned long reusedAllocations;
+
+    /**
+     * Number of chunks the pool of the class requested to the system
+     */
+    unsigned long chunks;
+} ClassStatistics;
+
+
+
+
 /**
  * Common class methods
+ *
+ * Instances are allocated with malloc, unless pools are enabled, at runtime
+ * with usePools or at build time by defining CLASS_POOLS: every class then
+ * gets a pool carving its instances from large chunks and reusing deleted ones
  */
 typedef struct
 {
@@ -14,7 +51,7 @@ typedef struct
     * Allocates a new instance and returns it
     *
     * @param className - the name of the class to allocate
-    * @param blockSize - the size of the class to allocate
+    * @param blockSize - the size of the class to allocate, the same for every instance of the class
     *
     * @return - the allocated instance, or NULL if allocation failed
     */
@@ -23,9 +60,25 @@ typedef struct
     /**
     * Deletes the instance and sets it to NULL
     *
+    * @param className - the name of the class the instance was allocated for
     * @param this - pointer to the instance to destructor
     */
-    void (* destructor)(void ** this);
+    void (* destructor)(char const * const className, void ** this);
+
+    /**
+    * Enables or disables pools for classes not allocated yet,
+    * classes which already have a pool keep it
+    *
+    * @param enabled - 1 to allocate instances from pools, 0 to use malloc
+    */
+    void (* usePools)(int enabled);
+
+    /**
+    * @param className - the name of the class to get counters of
+    *
+    * @return - the allocation counters of the class, all 0 if never allocated
+    */
+    ClassStatistics (* statistics)(char const * const className);
 
 } ClassMethods;
 
@@ -0,0 +1,946 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Class.h"
+#include "CompactTree.h"
+
+
+
+
+/**
+ * Index designating no node, the first slot of the array is never used
+ */
+#define NO_NODE 0U
+
+
+/**
+ * Bit of the parent index telling a node is red, indices stay below it
+ */
+#define RED_BIT 0x80000000U
+
+
+/**
+ * Number of nodes a path can hold, a red-black tree being at most twice as high as the logarithm of its size,
+ * the deepest path in a tree of 2^31 nodes is shorter
+ */
+#define PATH_CAPACITY 64U
+
+
+/**
+ * Number of nodes the array holds when the first value is added, it doubles whenever it's full
+ */
+#define INITIAL_CAPACITY 16U
+
+
+/**
+ * Indices rather than pointers, so that a node takes 24 bytes instead of 48 on 64 bits platforms
+ *
+ * With hot and cold nodes, parents and colors, which lookups don't need, are kept in an array of their own,
+ * so that the 16 bytes left fit 4 nodes in a cache line
+ *
+ * With path stacks, nodes have no parent at all, and colors are kept one bit per node in an array of their own
+ */
+typedef struct
+{
+    void const * value;
+    unsigned int leftNode;
+    unsigned int rightNode;
+#if ! defined(TREE_HOT_COLD_NODES) && ! defined(TREE_PATH_STACKS)
+    unsigned int parent;
+#endif
+} CompactTreeNode;
+
+
+/**
+ * The parent index of the node along with its color, wherever it's kept
+ */
+#ifdef TREE_HOT_COLD_NODES
+#define PARENT_OF(this, node) ((this)->parents[node])
+#else
+#define PARENT_OF(this, node) ((this)->nodes[node].parent)
+#endif
+
+
+/**
+ * Number of bits in a word of the colors array
+ */
+#define COLOR_BITS (8U * sizeof(unsigned int))
+
+
+/**
+ * Nodes met from the root down to the one being added, removed or stepped from,
+ * standing for the parent links when a mutation walks back up
+ */
+typedef struct
+{
+    unsigned int nodes[PATH_CAPACITY];
+    unsigned int depth;
+} CompactTreePath;
+
+
+struct _CompactTree
+{
+    CompactTreeNode * nodes;
+#if defined(TREE_PATH_STACKS)
+    unsigned int * colors;
+#elif defined(TREE_HOT_COLD_NODES)
+    unsigned int * parents;
+#endif
+    unsigned int capacity;
+    unsigned int used;
+    unsigned int freeNodes;
+    unsigned int root;
+    unsigned int size;
+    int (* compare)(void const * const currentValue, void const * const otherValue);
+};
+
+
+
+
+/**
+ * Takes a node from the ones freed by pop, or from the end of the array, growing it if it's full
+ *
+ * @return - a node holding the value, without parent nor sons, or NO_NODE if allocation failed
+ */
+static unsigned int constructNode(_CompactTree * const this, void const * const value);
+
+
+/**
+ * Chains the node to the ones reused by later adds, through its right son
+ */
+static void deleteNode(_CompactTree * const this, unsigned int node);
+
+
+/**
+ * Grows the array of nodes, along with the arrays kept aside of it
+ *
+ * @return - 1 if it grew, 0 if allocation failed or indices ran out
+ */
+static int growNodes(_CompactTree * const this);
+
+
+#ifndef TREE_PATH_STACKS
+static unsigned int parentOf(_CompactTree const * const this, unsigned int node);
+#else
+/**
+ * Walks down to the node, trying both sides of the values equal to its own
+ *
+ * @param branch - the node to walk down from
+ * @param path - filled from its depth with the nodes met down to the node, left as it was if it's not in the branch
+ *
+ * @return - 1 if the node was reached, 0 otherwise
+ */
+static int pathTo(_CompactTree const * const this, unsigned int branch, unsigned int node, CompactTreePath * const path);
+#endif
+
+
+/**
+ * Links the node to its parent, keeping its color, nodes having no parent link with path stacks
+ */
+static void setParent(_CompactTree * const this, unsigned int node, unsigned int parent);
+
+
+static int isRedNode(_CompactTree const * const this, unsigned int node);
+
+
+static void setRed(_CompactTree * const this, unsigned int node, int isRed);
+
+
+static unsigned int leftMostNode(_CompactTree const * const this, unsigned int node);
+
+
+static unsigned int rightMostNode(_CompactTree const * const this, unsigned int node);
+
+
+/**
+ * Recolors and rotates nodes above the newly added one until no red node has a red son
+ *
+ * @param path - the nodes from the root down to the newly added one
+ */
+static void repairAfterInsertion(_CompactTree * const this, CompactTreePath const * const path);
+
+
+/**
+ * Makes the right son of the node take its place, the node becomes its left son
+ *
+ * @param parent - the parent of the node, or NO_NODE if it's the root
+ */
+static void rotateLeft(_CompactTree * const this, unsigned int node, unsigned int parent);
+
+
+/**
+ * Makes the left son of the node take its place, the node becomes its right son
+ *
+ * @param parent - the parent of the node, or NO_NODE if it's the root
+ */
+static void rotateRight(_CompactTree * const this, unsigned int node, unsigned int parent);
+
+
+/**
+ * Links the replacement to the parent of the node, or makes it the root
+ *
+ * @param parent - the parent of the node, or NO_NODE if it's the root
+ * @param replacement - the node taking the place, can be NO_NODE
+ */
+static void replaceInParent(_CompactTree * const this, unsigned int parent, unsigned int node, unsigned int replacement);
+
+
+/**
+ * Unlinks the node from the tree, rebalancing it if a black node was removed
+ *
+ * @param path - the nodes from the root down to the node, reused to walk back up
+ */
+static void unlinkNode(_CompactTree * const this, CompactTreePath * const path);
+
+
+/**
+ * Recolors and rotates nodes around the branch missing a black node,
+ * until every path from the root has the same number of black nodes again
+ *
+ * @param node - the node which took the place of the removed one, can be NO_NODE
+ * @param path - the nodes from the root down to the parent of that node
+ */
+static void repairAfterRemoval(_CompactTree * const this, unsigned int node, CompactTreePath * const path);
+
+
+/**
+ * Recursion goes as deep as the tree is high, which is logarithmic
+ *
+ * @return - the number of nodes from the node to the deepest one below it
+ */
+static unsigned int branchHeight(_CompactTree const * const this, unsigned int node);
+
+
+
+
+static _CompactTree * constructor(int (* compareValuesCallback)(void const * const currentValue, void const * const otherValue))
+{
+    _CompactTree * this = Class->constructor("CompactTree", sizeof(* this));
+
+    if (this == NULL)
+        return NULL;
+
+    this->nodes = NULL;
+#if defined(TREE_PATH_STACKS)
+    this->colors = NULL;
+#elif defined(TREE_HOT_COLD_NODES)
+    this->parents = NULL;
+#endif
+    this->capacity = 0;
+    this->used = 1;
+    this->freeNodes = NO_NODE;
+    this->root = NO_NODE;
+    this->size = 0;
+    this->compare = compareValuesCallback;
+
+    return this;
+}
+
+
+static _CompactTree * copy(_CompactTree const * const this)
+{
+    _CompactTree * copied;
+
+    if (this == NULL)
+        return NULL;
+
+    copied = Class->constructor("CompactTree", sizeof(* copied));
+    if (copied == NULL)
+        return NULL;
+
+    * copied = * this;
+    if (this->nodes == NULL)
+        return copied;
+
+    /* links are indices, the copied nodes link to each other as the original ones do */
+    copied->nodes = malloc(this->capacity * sizeof(* copied->nodes));
+    if (copied->nodes == NULL)
+    {
+        Class->destructor("CompactTree", (void **) & copied);
+        return NULL;
+    }
+
+#if defined(TREE_PATH_STACKS)
+    copied->colors = malloc((this->capacity / COLOR_BITS + 1) * sizeof(* copied->colors));
+    if (copied->colors == NULL)
+    {
+        free(copied->nodes);
+        Class->destructor("CompactTree", (void **) & copied);
+        return NULL;
+    }
+#elif defined(TREE_HOT_COLD_NODES)
+    copied->parents = malloc(this->capacity * sizeof(* copied->parents));
+    if (copied->parents == NULL)
+    {
+        free(copied->nodes);
+        Class->destructor("CompactTree", (void **) & copied);
+        return NULL;
+    }
+#endif
+
+    memcpy(copied->nodes, this->nodes, this->used * sizeof(* copied->nodes));
+#if defined(TREE_PATH_STACKS)
+    memcpy(copied->colors, this->colors, (this->capacity / COLOR_BITS + 1) * sizeof(* copied->colors));
+#elif defined(TREE_HOT_COLD_NODES)
+    memcpy(copied->parents, this->parents, this->used * sizeof(* copied->parents));
+#endif
+
+    return copied;
+}
+
+
+static void destructor(_CompactTree ** this)
+{
+    if ((this == NULL) || (* this == NULL))
+        return;
+
+    free((* this)->nodes);
+#if defined(TREE_PATH_STACKS)
+    free((* this)->colors);
+#elif defined(TREE_HOT_COLD_NODES)
+    free((* this)->parents);
+#endif
+    Class->destructor("CompactTree", (void **) this);
+}
+
+
+static void const * value(_CompactTree const * const this, unsigned int node)
+{
+    if ((this == NULL) || (node == NO_NODE))
+        return NULL;
+    return this->nodes[node].value;
+}
+
+
+static unsigned int find(_CompactTree const * const this, void const * const value)
+{
+    unsigned int node;
+    int comparison;
+
+    if (this == NULL)
+        return NO_NODE;
+
+    for (node = this->root; node != NO_NODE; node = (comparison > 0) ? this->nodes[node].leftNode : this->nodes[node].rightNode)
+    {
+        comparison = this->compare(this->nodes[node].value, value);
+        if (comparison == 0)
+            return node;
+    }
+
+    return NO_NODE;
+}
+
+
+static int contains(_CompactTree const * const this, void const * const value)
+{
+    return find(this, value) != NO_NODE;
+}
+
+
+static unsigned int add(_CompactTree * const this, void const * const value)
+{
+    CompactTreePath path;
+    unsigned int parent = NO_NODE, node, leaf;
+    int goesLeft = 0;
+
+    if (this == NULL)
+        return NO_NODE;
+
+    path.depth = 0;
+    for (node = this->root; node != NO_NODE; node = goesLeft ? this->nodes[node].leftNode : this->nodes[node].rightNode)
+    {
+        path.nodes[path.depth++] = node;
+        parent = node;
+        goesLeft = this->compare(this->nodes[node].value, value) > 0;
+    }
+
+    /* the array may move as it grows, only indices are kept across it */
+    leaf = constructNode(this, value);
+    if (leaf == NO_NODE)
+        return NO_NODE;
+
+    setParent(this, leaf, parent);
+    setRed(this, leaf, 1);
+    if (parent == NO_NODE)
+        this->root = leaf;
+    else if (goesLeft)
+        this->nodes[parent].leftNode = leaf;
+    else
+        this->nodes[parent].rightNode = leaf;
+    this->size++;
+
+    path.nodes[path.depth++] = leaf;
+    repairAfterInsertion(this, & path);
+
+    return leaf;
+}
+
+
+static unsigned int size(_CompactTree const * const this)
+{
+    if (this == NULL)
+        return 0;
+    return this->size;
+}
+
+
+static unsigned int min(_CompactTree const * const this)
+{
+    if ((this == NULL) || (this->root == NO_NODE))
+        return NO_NODE;
+    return leftMostNode(this, this->root);
+}
+
+
+static unsigned int max(_CompactTree const * const this)
+{
+    if ((this == NULL) || (this->root == NO_NODE))
+        return NO_NODE;
+    return rightMostNode(this, this->root);
+}
+
+
+static unsigned int next(_CompactTree const * const this, unsigned int node)
+{
+#ifdef TREE_PATH_STACKS
+    CompactTreePath path;
+#else
+    unsigned int parent;
+#endif
+
+    if ((this == NULL) || (node == NO_NODE))
+        return NO_NODE;
+    if (this->nodes[node].rightNode != NO_NODE)
+        return leftMostNode(this, this->nodes[node].rightNode);
+
+#ifdef TREE_PATH_STACKS
+    path.depth = 0;
+    if (! pathTo(this, this->root, node, & path))
+        return NO_NODE;
+
+    while ((path.depth > 1) && (this->nodes[path.nodes[path.depth - 2]].rightNode == path.nodes[path.depth - 1]))
+        path.depth--;
+    return (path.depth > 1) ? path.nodes[path.depth - 2] : NO_NODE;
+#else
+    for (parent = parentOf(this, node); (parent != NO_NODE) && (this->nodes[parent].rightNode == node); parent = parentOf(this, node))
+        node = parent;
+    return parent;
+#endif
+}
+
+
+static unsigned int previous(_CompactTree const * const this, unsigned int node)
+{
+#ifdef TREE_PATH_STACKS
+    CompactTreePath path;
+#else
+    unsigned int parent;
+#endif
+
+    if ((this == NULL) || (node == NO_NODE))
+        return NO_NODE;
+    if (this->nodes[node].leftNode != NO_NODE)
+        return rightMostNode(this, this->nodes[node].leftNode);
+
+#ifdef TREE_PATH_STACKS
+    path.depth = 0;
+    if (! pathTo(this, this->root, node, & path))
+        return NO_NODE;
+
+    while ((path.depth > 1) && (this->nodes[path.nodes[path.depth - 2]].leftNode == path.nodes[path.depth - 1]))
+        path.depth--;
+    return (path.depth > 1) ? path.nodes[path.depth - 2] : NO_NODE;
+#else
+    for (parent = parentOf(this, node); (parent != NO_NODE) && (this->nodes[parent].leftNode == node); parent = parentOf(this, node))
+        node = parent;
+    return parent;
+#endif
+}
+
+
+static unsigned int height(_CompactTree const * const this)
+{
+    if (this == NULL)
+        return 0;
+    return branchHeight(this, this->root);
+}
+
+
+static void const * pop(_CompactTree * const this, void const * const value)
+{
+    CompactTreePath path;
+    unsigned int node;
+    void const * poppedValue;
+    int comparison = 1;
+
+    if (this == NULL)
+        return NULL;
+
+    /* stops on the first equal value met, as find does */
+    path.depth = 0;
+    for (node = this->root; node != NO_NODE; node = (comparison > 0) ? this->nodes[node].leftNode : this->nodes[node].rightNode)
+    {
+        path.nodes[path.depth++] = node;
+        comparison = this->compare(this->nodes[node].value, value);
+        if (comparison == 0)
+            break;
+    }
+    if (node == NO_NODE)
+        return NULL;
+
+    unlinkNode(this, & path);
+    this->size--;
+
+    poppedValue = this->nodes[node].value;
+    deleteNode(this, node);
+
+    return poppedValue;
+}
+
+
+static void map(_CompactTree const * const this, void (* callback)(void const * const value))
+{
+    CompactTreePath path;
+    unsigned int node;
+
+    if (this == NULL)
+        return;
+
+    /* the nodes whose left branch is being visited are stacked, so that no parent is needed */
+    path.depth = 0;
+    for (node = this->root; (node != NO_NODE) || (path.depth > 0); node = this->nodes[node].rightNode)
+    {
+        for (; node != NO_NODE; node = this->nodes[node].leftNode)
+            path.nodes[path.depth++] = node;
+
+        node = path.nodes[--path.depth];
+        callback(this->nodes[node].value);
+    }
+}
+
+
+
+
+static unsigned int constructNode(_CompactTree * const this, void const * const value)
+{
+    unsigned int node;
+
+    if (this->freeNodes != NO_NODE)
+    {
+        node = this->freeNodes;
+        this->freeNodes = this->nodes[node].rightNode;
+    }
+    else
+    {
+        if ((this->used >= this->capacity) && ! growNodes(this))
+            return NO_NODE;
+        node = this->used++;
+    }
+
+    this->nodes[node].value = value;
+    this->nodes[node].leftNode = NO_NODE;
+    this->nodes[node].rightNode = NO_NODE;
+#ifndef TREE_PATH_STACKS
+    PARENT_OF(this, node) = NO_NODE;
+#endif
+    setRed(this, node, 0);
+
+    return node;
+}
+
+
+static void deleteNode(_CompactTree * const this, unsigned int node)
+{
+    this->nodes[node].value = NULL;
+    this->nodes[node].rightNode = this->freeNodes;
+    this->freeNodes = node;
+}
+
+
+static int growNodes(_CompactTree * const this)
+{
+    CompactTreeNode * grownNodes;
+#if defined(TREE_PATH_STACKS)
+    unsigned int * grownColors;
+#elif defined(TREE_HOT_COLD_NODES)
+    unsigned int * grownParents;
+#endif
+    unsigned int grownCapacity;
+
+    if (this->capacity == RED_BIT)
+        return 0;
+    if (this->capacity == 0)
+        grownCapacity = INITIAL_CAPACITY;
+    else
+        grownCapacity = (this->capacity < RED_BIT / 2) ? 2 * this->capacity : RED_BIT;
+
+    grownNodes = realloc(this->nodes, grownCapacity * sizeof(* grownNodes));
+    if (grownNodes == NULL)
+        return 0;
+    this->nodes = grownNodes;
+
+    /* nodes may have grown alone, which only wastes their new room until the next try */
+#if defined(TREE_PATH_STACKS)
+    grownColors = realloc(this->colors, (grownCapacity / COLOR_BITS + 1) * sizeof(* grownColors));
+    if (grownColors == NULL)
+        return 0;
+    this->colors = grownColors;
+#elif defined(TREE_HOT_COLD_NODES)
+    grownParents = realloc(this->parents, grownCapacity * sizeof(* grownParents));
+    if (grownParents == NULL)
+        return 0;
+    this->parents = grownParents;
+#endif
+
+    this->capacity = grownCapacity;
+
+    return 1;
+}
+
+
+#ifndef TREE_PATH_STACKS
+static unsigned int parentOf(_CompactTree const * const this, unsigned int node)
+{
+    return PARENT_OF(this, node) & ~RED_BIT;
+}
+#else
+static int pathTo(_CompactTree const * const this, unsigned int branch, unsigned int node, CompactTreePath * const path)
+{
+    unsigned int depth = path->depth;
+    int comparison;
+
+    for (; branch != NO_NODE; branch = (comparison > 0) ? this->nodes[branch].leftNode : this->nodes[branch].rightNode)
+    {
+        path->nodes[path->depth++] = branch;
+        if (branch == node)
+            return 1;
+
+        /* rotations may have moved values equal to the one of the node on both sides */
+        comparison = this->compare(this->nodes[branch].value, this->nodes[node].value);
+        if ((comparison == 0) && pathTo(this, this->nodes[branch].leftNode, node, path))
+            return 1;
+    }
+
+    path->depth = depth;
+    return 0;
+}
+#endif
+
+
+static void setParent(_CompactTree * const this, unsigned int node, unsigned int parent)
+{
+#ifdef TREE_PATH_STACKS
+    (void) this;
+    (void) node;
+    (void) parent;
+#else
+    PARENT_OF(this, node) = (PARENT_OF(this, node) & RED_BIT) | parent;
+#endif
+}
+
+
+static int isRedNode(_CompactTree const * const this, unsigned int node)
+{
+#ifdef TREE_PATH_STACKS
+    return (node != NO_NODE) && (((this->colors[node / COLOR_BITS] >> (node % COLOR_BITS)) & 1U) != 0);
+#else
+    return (node != NO_NODE) && ((PARENT_OF(this, node) & RED_BIT) != 0);
+#endif
+}
+
+
+static void setRed(_CompactTree * const this, unsigned int node, int isRed)
+{
+#ifdef TREE_PATH_STACKS
+    if (isRed)
+        this->colors[node / COLOR_BITS] |= 1U << (node % COLOR_BITS);
+    else
+        this->colors[node / COLOR_BITS] &= ~(1U << (node % COLOR_BITS));
+#else
+    if (isRed)
+        PARENT_OF(this, node) |= RED_BIT;
+    else
+        PARENT_OF(this, node) &= ~RED_BIT;
+#endif
+}
+
+
+static unsigned int leftMostNode(_CompactTree const * const this, unsigned int node)
+{
+    while (this->nodes[node].leftNode != NO_NODE)
+        node = this->nodes[node].leftNode;
+
+    return node;
+}
+
+
+static unsigned int rightMostNode(_CompactTree const * const this, unsigned int node)
+{
+    while (this->nodes[node].rightNode != NO_NODE)
+        node = this->nodes[node].rightNode;
+
+    return node;
+}
+
+
+static void repairAfterInsertion(_CompactTree * const this, CompactTreePath const * const path)
+{
+    unsigned int depth = path->depth - 1, node, parent, grandParent, greatGrandParent, uncle;
+
+    /* a red parent is never the root, so the grandparent always exists */
+    while ((depth > 0) && isRedNode(this, path->nodes[depth - 1]))
+    {
+        node = path->nodes[depth];
+        parent = path->nodes[depth - 1];
+        grandParent = path->nodes[depth - 2];
+        greatGrandParent = (depth > 2) ? path->nodes[depth - 3] : NO_NODE;
+
+        uncle = (parent == this->nodes[grandParent].leftNode) ? this->nodes[grandParent].rightNode : this->nodes[grandParent].leftNode;
+        if (isRedNode(this, uncle))
+        {
+            setRed(this, parent, 0);
+            setRed(this, uncle, 0);
+            setRed(this, grandParent, 1);
+            depth -= 2;
+            continue;
+        }
+
+        /* the node takes the place of its parent, then both get the place of the grandparent */
+        if (parent == this->nodes[grandParent].leftNode)
+        {
+            if (node == this->nodes[parent].rightNode)
+            {
+                rotateLeft(this, parent, grandParent);
+                parent = node;
+            }
+            setRed(this, parent, 0);
+            setRed(this, grandParent, 1);
+            rotateRight(this, grandParent, greatGrandParent);
+        }
+        else
+        {
+            if (node == this->nodes[parent].leftNode)
+            {
+                rotateRight(this, parent, grandParent);
+                parent = node;
+            }
+            setRed(this, parent, 0);
+            setRed(this, grandParent, 1);
+            rotateLeft(this, grandParent, greatGrandParent);
+        }
+        break;
+    }
+
+    setRed(this, this->root, 0);
+}
+
+
+static void rotateLeft(_CompactTree * const this, unsigned int node, unsigned int parent)
+{
+    unsigned int pivot = this->nodes[node].rightNode;
+
+    this->nodes[node].rightNode = this->nodes[pivot].leftNode;
+    if (this->nodes[pivot].leftNode != NO_NODE)
+        setParent(this, this->nodes[pivot].leftNode, node);
+
+    replaceInParent(this, parent, node, pivot);
+
+    this->nodes[pivot].leftNode = node;
+    setParent(this, node, pivot);
+}
+
+
+static void rotateRight(_CompactTree * const this, unsigned int node, unsigned int parent)
+{
+    unsigned int pivot = this->nodes[node].leftNode;
+
+    this->nodes[node].leftNode = this->nodes[pivot].rightNode;
+    if (this->nodes[pivot].rightNode != NO_NODE)
+        setParent(this, this->nodes[pivot].rightNode, node);
+
+    replaceInParent(this, parent, node, pivot);
+
+    this->nodes[pivot].rightNode = node;
+    setParent(this, node, pivot);
+}
+
+
+static void replaceInParent(_CompactTree * const this, unsigned int parent, unsigned int node, unsigned int replacement)
+{
+    if (replacement != NO_NODE)
+        setParent(this, replacement, parent);
+
+    if (parent == NO_NODE)
+        this->root = replacement;
+    else if (this->nodes[parent].leftNode == node)
+        this->nodes[parent].leftNode = replacement;
+    else
+        this->nodes[parent].rightNode = replacement;
+}
+
+
+static void unlinkNode(_CompactTree * const this, CompactTreePath * const path)
+{
+    unsigned int depth = path->depth - 1, node = path->nodes[depth], successor, replacement, parent;
+    int removedRed = isRedNode(this, node);
+
+    parent = (depth > 0) ? path->nodes[depth - 1] : NO_NODE;
+    if ((this->nodes[node].leftNode == NO_NODE) || (this->nodes[node].rightNode == NO_NODE))
+    {
+        replacement = (this->nodes[node].leftNode != NO_NODE) ? this->nodes[node].leftNode : this->nodes[node].rightNode;
+        replaceInParent(this, parent, node, replacement);
+        path->depth = depth;
+    }
+    else
+    {
+        /* the path goes on down to the successor, which then takes the place of the node in it */
+        for (successor = this->nodes[node].rightNode; successor != NO_NODE; successor = this->nodes[successor].leftNode)
+            path->nodes[path->depth++] = successor;
+        successor = path->nodes[--path->depth];
+
+        removedRed = isRedNode(this, successor);
+        replacement = this->nodes[successor].rightNode;
+
+        if (path->nodes[path->depth - 1] != node)
+        {
+            replaceInParent(this, path->nodes[path->depth - 1], successor, replacement);
+            this->nodes[successor].rightNode = this->nodes[node].rightNode;
+            setParent(this, this->nodes[successor].rightNode, successor);
+        }
+
+        replaceInParent(this, parent, node, successor);
+        this->nodes[successor].leftNode = this->nodes[node].leftNode;
+        setParent(this, this->nodes[successor].leftNode, successor);
+        setRed(this, successor, isRedNode(this, node));
+        path->nodes[depth] = successor;
+    }
+
+    if (! removedRed)
+        repairAfterRemoval(this, replacement, path);
+}
+
+
+static void repairAfterRemoval(_CompactTree * const this, unsigned int node, CompactTreePath * const path)
+{
+    unsigned int parent, grandParent, sibling;
+
+    /* the branch holding the node misses a black node, the sibling branch can't be empty */
+    while ((path->depth > 0) && ! isRedNode(this, node))
+    {
+        parent = path->nodes[path->depth - 1];
+        grandParent = (path->depth > 1) ? path->nodes[path->depth - 2] : NO_NODE;
+
+        if (node == this->nodes[parent].leftNode)
+        {
+            sibling = this->nodes[parent].rightNode;
+            if (isRedNode(this, sibling))
+            {
+                /* the parent turns red under its sibling, so the loop ends before the path above is used again */
+                setRed(this, sibling, 0);
+                setRed(this, parent, 1);
+                rotateLeft(this, parent, grandParent);
+                grandParent = sibling;
+                sibling = this->nodes[parent].rightNode;
+            }
+
+            if (! isRedNode(this, this->nodes[sibling].leftNode) && ! isRedNode(this, this->nodes[sibling].rightNode))
+            {
+                setRed(this, sibling, 1);
+                node = parent;
+                path->depth--;
+                continue;
+            }
+
+            if (! isRedNode(this, this->nodes[sibling].rightNode))
+            {
+                setRed(this, this->nodes[sibling].leftNode, 0);
+                setRed(this, sibling, 1);
+                rotateRight(this, sibling, parent);
+                sibling = this->nodes[parent].rightNode;
+            }
+
+            setRed(this, sibling, isRedNode(this, parent));
+            setRed(this, parent, 0);
+            setRed(this, this->nodes[sibling].rightNode, 0);
+            rotateLeft(this, parent, grandParent);
+        }
+        else
+        {
+            sibling = this->nodes[parent].leftNode;
+            if (isRedNode(this, sibling))
+            {
+                setRed(this, sibling, 0);
+                setRed(this, parent, 1);
+                rotateRight(this, parent, grandParent);
+                grandParent = sibling;
+                sibling = this->nodes[parent].leftNode;
+            }
+
+            if (! isRedNode(this, this->nodes[sibling].leftNode) && ! isRedNode(this, this->nodes[sibling].rightNode))
+            {
+                setRed(this, sibling, 1);
+                node = parent;
+                path->depth--;
+                continue;
+            }
+
+            if (! isRedNode(this, this->nodes[sibling].leftNode))
+            {
+                setRed(this, this->nodes[sibling].rightNode, 0);
+                setRed(this, sibling, 1);
+                rotateLeft(this, sibling, parent);
+                sibling = this->nodes[parent].leftNode;
+            }
+
+            setRed(this, sibling, isRedNode(this, parent));
+            setRed(this, parent, 0);
+            setRed(this, this->nodes[sibling].leftNode, 0);
+            rotateRight(this, parent, grandParent);
+        }
+
+        return;
+    }
+
+    if (node != NO_NODE)
+        setRed(this, node, 0);
+}
+
+
+static unsigned int branchHeight(_CompactTree const * const this, unsigned int node)
+{
+    unsigned int leftHeight, rightHeight;
+
+    if (node == NO_NODE)
+        return 0;
+
+    leftHeight = branchHeight(this, this->nodes[node].leftNode);
+    rightHeight = branchHeight(this, this->nodes[node].rightNode);
+
+    return 1 + ((leftHeight > rightHeight) ? leftHeight : rightHeight);
+}
+
+
+
+
+/**
+ * Init CompactTree methods table
+ */
+static CompactTreeMethods methods = {
+    constructor,
+    copy,
+    destructor,
+    value,
+    find,
+    contains,
+    add,
+    size,
+    min,
+    max,
+    next,
+    previous,
+    height,
+    pop,
+    map
+};
+CompactTreeMethods const * const CompactTree = & methods;
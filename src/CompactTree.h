@@ -0,0 +1,139 @@
+#ifndef COMPACT_TREE_CLASS_HEADER
+#define COMPACT_TREE_CLASS_HEADER
+
+
+
+
+/**
+ * A red-black tree whose nodes live in a single growable array and link to each other by 32 bits indices,
+ * the color being packed into the parent index, so that a node takes half the memory of a balanced tree node
+ *
+ * Holding no pointer to itself, the whole tree can be moved around and copied as a block
+ *
+ * Nodes are designated by their index, 0 meaning no node, which stays valid until the node is popped
+ *
+ * Built with TREE_PATH_STACKS, nodes keep no parent, adding and popping remember the path they came down instead,
+ * while stepping from a node walks down to it from the root
+ */
+typedef struct _CompactTree _CompactTree;
+
+
+
+
+typedef struct
+{
+    /**
+     * @param compareCallback - the callback to compare elements with, should return :
+     *  < 0 if current value is smaller,
+     *  > 0 if other value is smaller,
+     *  = 0 if both are equal
+     *
+     * @return - an empty tree, or NULL if allocation failed
+     */
+    _CompactTree * (* constructor)(
+        int (* compareValuesCallback)(void const * const currentValue, void const * const otherValue)
+    );
+
+    /**
+     * Copies the tree by copying its array of nodes, indices of nodes designate the same values in the copy
+     *
+     * @return - a tree holding the same values, or NULL if allocation failed
+     */
+    _CompactTree * (* copy)(_CompactTree const * const this);
+
+    /**
+     * Destroys the tree and its array of nodes, and sets it to NULL
+     */
+    void (* destructor)(_CompactTree ** this);
+
+    /**
+     * @return - the value of the node, or NULL if node is 0
+     */
+    void const * (* value)(_CompactTree const * const this, unsigned int node);
+
+    /**
+     * @param value - the value to find in the tree
+     *
+     * @return - a node having the given value, or 0 if not found
+     */
+    unsigned int (* find)(_CompactTree const * const this, void const * const value);
+
+    /**
+     * @param value - the value to find in the tree
+     *
+     * @return - 1 if the value was found in the tree, 0 otherwise
+     */
+    int (* contains)(_CompactTree const * const this, void const * const value);
+
+    /**
+     * Adds the value after the equal ones already in the tree, growing the array of nodes if it's full
+     *
+     * @param value - the value to add in the tree
+     *
+     * @return - the newly created node, or 0 if tree is NULL, allocation failed or indices ran out
+     */
+    unsigned int (* add)(_CompactTree * const this, void const * const value);
+
+    /**
+     * @return - the number of values in the tree
+     */
+    unsigned int (* size)(_CompactTree const * const this);
+
+    /**
+     * @return - the node of the smallest value, or 0 if tree is empty
+     */
+    unsigned int (* min)(_CompactTree const * const this);
+
+    /**
+     * @return - the node of the greatest value, or 0 if tree is empty
+     */
+    unsigned int (* max)(_CompactTree const * const this);
+
+    /**
+     * Runs in logarithmic time with TREE_PATH_STACKS, plus the number of values equal to the one of the node
+     *
+     * @return - the node following the given one in order, or 0 if it's the last one
+     */
+    unsigned int (* next)(_CompactTree const * const this, unsigned int node);
+
+    /**
+     * Runs in logarithmic time with TREE_PATH_STACKS, plus the number of values equal to the one of the node
+     *
+     * @return - the node preceding the given one in order, or 0 if it's the first one
+     */
+    unsigned int (* previous)(_CompactTree const * const this, unsigned int node);
+
+    /**
+     * @return - the number of nodes from the root to the deepest one
+     */
+    unsigned int (* height)(_CompactTree const * const this);
+
+    /**
+     * Removes a value equal to the given one from the tree, its node being reused by a later add
+     *
+     * @param value - the value to pop from the tree
+     *
+     * @return - the value which was stored in the tree, or NULL if it was not found
+     */
+    void const * (* pop)(_CompactTree * const this, void const * const value);
+
+    /**
+     * Applies the callback on every value in the tree, in order
+     *
+     * @param callback - the callback to apply on each value
+     */
+    void (* map)(_CompactTree const * const this, void (* callback)(void const * const value));
+} CompactTreeMethods;
+
+
+
+
+/**
+ * CompactTree methods table
+ */
+extern CompactTreeMethods const * const CompactTree;
+
+
+
+
+#endif /* COMPACT_TREE_CLASS_HEADER */
@@ -0,0 +1,349 @@
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "Class.h"
+#include "FrozenTree.h"
+
+
+
+
+/**
+ * Greatest height of a snapshot, whose size is an unsigned int
+ */
+#define LARGEST_HEIGHT 32
+
+
+struct _FrozenTree
+{
+    int (* compare)(void const * const currentValue, void const * const otherValue);
+    unsigned int size;
+    FrozenTreeLayout layout;
+    void const ** values;
+    unsigned int height;
+    /* for each depth, the split of the van Emde Boas layout its nodes are the bottom roots of */
+    unsigned long topSizes[LARGEST_HEIGHT];
+    unsigned long bottomSizes[LARGEST_HEIGHT];
+    unsigned int topDepths[LARGEST_HEIGHT];
+};
+
+
+/**
+ * Values three levels below the one at index k are the 8 ones from index 8k, which share a cache line
+ */
+#define PREFETCHED_DESCENDANTS 8
+
+
+/**
+ * Asks for the memory holding the address to be loaded ahead, where the compiler offers it
+ */
+#ifdef __GNUC__
+#define PREFETCH(address) __builtin_prefetch(address)
+#else
+#define PREFETCH(address) ((void) (address))
+#endif
+
+
+
+
+/**
+ * Stores the sorted values in the order an in-order walk of the implicit tree meets its indexes,
+ * recursion goes as deep as the implicit tree is high, which is logarithmic
+ *
+ * @param values - the sorted values to store
+ * @param next - the index of the next sorted value to store
+ * @param index - the breadth-first index of the top-most value of the branch to fill, from 1
+ * @param laidOut - the array to store them in, in breadth-first order
+ */
+static void layOutBreadthFirst(
+    _FrozenTree const * const this,
+    void const * const * const values,
+    unsigned int * const next,
+    unsigned long index,
+    void const ** const laidOut
+);
+
+
+/**
+ * Records, for the depths of the bottom roots, how the branch is split, then splits both halves
+ *
+ * @param depth - the depth of the top-most node of the branch, from 0
+ * @param height - the height of the branch
+ */
+static void splitLevels(_FrozenTree * const this, unsigned int depth, unsigned int height);
+
+
+/**
+ * Copies a branch of values laid out breadth-first into the van Emde Boas layout,
+ * indexes beyond the size being holes
+ *
+ * @param breadthFirst - the values laid out breadth-first
+ * @param index - the breadth-first index of the top-most value of the branch, from 1
+ * @param height - the height of the branch
+ * @param position - where the branch starts in the van Emde Boas layout
+ */
+static void layOutVanEmdeBoas(
+    _FrozenTree * const this,
+    void const * const * const breadthFirst,
+    unsigned long index,
+    unsigned int height,
+    unsigned long position
+);
+
+
+/**
+ * @return - the first value which isn't lesser than the given one, or NULL if there is none
+ */
+static void const * seekBreadthFirst(_FrozenTree const * const this, void const * const value);
+
+
+/**
+ * @return - the first value which isn't lesser than the given one, or NULL if there is none
+ */
+static void const * seekVanEmdeBoas(_FrozenTree const * const this, void const * const value);
+
+
+
+
+static _FrozenTree * constructor(
+    int (* compareValuesCallback)(void const * const currentValue, void const * const otherValue),
+    void const * const * const values,
+    unsigned int count,
+    FrozenTreeLayout layout
+)
+{
+    _FrozenTree * this = Class->constructor("FrozenTree", sizeof(* this));
+    void const ** breadthFirst;
+    unsigned int next = 0;
+
+    if (this == NULL)
+        return NULL;
+
+    this->compare = compareValuesCallback;
+    this->size = count;
+    this->layout = layout;
+    for (this->height = 0; (this->height < LARGEST_HEIGHT) && ((count >> this->height) > 0); this->height++)
+        ;
+
+    /* index 0 is left unused, so that the sons of k are 2k and 2k + 1 */
+    breadthFirst = malloc((count + 1UL) * sizeof(* breadthFirst));
+    if (breadthFirst == NULL)
+    {
+        fprintf(stderr, "Memory allocation failed for class %s\n", "FrozenTree");
+        Class->destructor("FrozenTree", (void **) & this);
+        return NULL;
+    }
+    breadthFirst[0] = NULL;
+    layOutBreadthFirst(this, values, & next, 1, breadthFirst);
+
+    if (layout == BreadthFirstLayout)
+    {
+        this->values = breadthFirst;
+        return this;
+    }
+
+    /* every level is given its full width, so that positions can be computed */
+    this->values = malloc(((1UL << this->height) - 1 + (count == 0)) * sizeof(* this->values));
+    if (this->values == NULL)
+    {
+        fprintf(stderr, "Memory allocation failed for class %s\n", "FrozenTree");
+        free(breadthFirst);
+        Class->destructor("FrozenTree", (void **) & this);
+        return NULL;
+    }
+
+    splitLevels(this, 0, this->height);
+    layOutVanEmdeBoas(this, breadthFirst, 1, this->height, 0);
+    free(breadthFirst);
+
+    return this;
+}
+
+
+static void destructor(_FrozenTree ** this)
+{
+    if ((this == NULL) || (* this == NULL))
+        return;
+
+    free((* this)->values);
+    Class->destructor("FrozenTree", (void **) this);
+}
+
+
+static void const * seek(_FrozenTree const * const this, void const * const value)
+{
+    if ((this == NULL) || (this->size == 0))
+        return NULL;
+
+    if (this->layout == BreadthFirstLayout)
+        return seekBreadthFirst(this, value);
+    return seekVanEmdeBoas(this, value);
+}
+
+
+static void const * find(_FrozenTree const * const this, void const * const value)
+{
+    void const * found = seek(this, value);
+
+    if ((found == NULL) || (this->compare(found, value) != 0))
+        return NULL;
+
+    return found;
+}
+
+
+static int contains(_FrozenTree const * const this, void const * const value)
+{
+    return find(this, value) != NULL;
+}
+
+
+static unsigned int size(_FrozenTree const * const this)
+{
+    if (this == NULL)
+        return 0;
+
+    return this->size;
+}
+
+
+
+
+static void layOutBreadthFirst(
+    _FrozenTree const * const this,
+    void const * const * const values,
+    unsigned int * const next,
+    unsigned long index,
+    void const ** const laidOut
+)
+{
+    if (index > this->size)
+        return;
+
+    layOutBreadthFirst(this, values, next, 2 * index, laidOut);
+    laidOut[index] = values[(* next)++];
+    layOutBreadthFirst(this, values, next, 2 * index + 1, laidOut);
+}
+
+
+static void splitLevels(_FrozenTree * const this, unsigned int depth, unsigned int height)
+{
+    unsigned int topHeight = height / 2, bottomHeight = height - topHeight;
+
+    if (height <= 1)
+        return;
+
+    this->topSizes[depth + topHeight] = (1UL << topHeight) - 1;
+    this->bottomSizes[depth + topHeight] = (1UL << bottomHeight) - 1;
+    this->topDepths[depth + topHeight] = depth;
+
+    splitLevels(this, depth, topHeight);
+    splitLevels(this, depth + topHeight, bottomHeight);
+}
+
+
+static void layOutVanEmdeBoas(
+    _FrozenTree * const this,
+    void const * const * const breadthFirst,
+    unsigned long index,
+    unsigned int height,
+    unsigned long position
+)
+{
+    unsigned int topHeight = height / 2, bottomHeight = height - topHeight;
+    unsigned long bottom, bottoms = 1UL << topHeight;
+
+    if (height == 0)
+        return;
+
+    if (height == 1)
+    {
+        this->values[position] = (index <= this->size) ? breadthFirst[index] : NULL;
+        return;
+    }
+
+    layOutVanEmdeBoas(this, breadthFirst, index, topHeight, position);
+    for (bottom = 0; bottom < bottoms; bottom++)
+        layOutVanEmdeBoas(
+            this,
+            breadthFirst,
+            (index << topHeight) + bottom,
+            bottomHeight,
+            position + (bottoms - 1) + bottom * ((1UL << bottomHeight) - 1)
+        );
+}
+
+
+static void const * seekBreadthFirst(_FrozenTree const * const this, void const * const value)
+{
+    unsigned long index = 1;
+
+    /* the comparison picks the son instead of branching, so there is no misprediction to pay */
+    while (index <= this->size)
+    {
+        if (index * PREFETCHED_DESCENDANTS <= this->size)
+            PREFETCH(this->values + index * PREFETCHED_DESCENDANTS);
+        index = 2 * index + (this->compare(this->values[index], value) < 0);
+    }
+
+    /* the answer is where the walk last went left: undo the right steps taken since, then that left step */
+    while (index & 1)
+        index >>= 1;
+
+    return this->values[index >> 1];
+}
+
+
+static void const * seekVanEmdeBoas(_FrozenTree const * const this, void const * const value)
+{
+    unsigned long positions[LARGEST_HEIGHT];
+    unsigned long index = 1, bottom, next;
+    unsigned int depth = 0;
+
+    /* walks breadth-first indexes as seekBreadthFirst does, each position following from the one of its top root */
+    positions[0] = 0;
+    for (;;)
+    {
+        if (2 * index + 1 <= this->size)
+        {
+            /* both sons are roots of neighbouring bottom trees, loaded while comparing */
+            bottom = (2 * index) & this->topSizes[depth + 1];
+            next = positions[this->topDepths[depth + 1]] + this->topSizes[depth + 1] + bottom * this->bottomSizes[depth + 1];
+            PREFETCH(this->values + next);
+            PREFETCH(this->values + next + this->bottomSizes[depth + 1]);
+        }
+        index = 2 * index + (this->compare(this->values[positions[depth]], value) < 0);
+        depth++;
+        if (index > this->size)
+            break;
+
+        bottom = index & this->topSizes[depth];
+        positions[depth] = positions[this->topDepths[depth]] + this->topSizes[depth] + bottom * this->bottomSizes[depth];
+    }
+
+    while (index & 1)
+    {
+        index >>= 1;
+        depth--;
+    }
+
+    if (index == 0)
+        return NULL;
+    return this->values[positions[depth - 1]];
+}
+
+
+
+
+/**
+ * Init FrozenTree methods table
+ */
+static FrozenTreeMethods methods = {
+    constructor,
+    destructor,
+    find,
+    contains,
+    seek,
+    size
+};
+FrozenTreeMethods const * const FrozenTree = & methods;
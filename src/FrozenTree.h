@@ -0,0 +1,98 @@
+#ifndef FROZEN_TREE_CLASS_HEADER
+#define FROZEN_TREE_CLASS_HEADER
+
+
+
+
+/**
+ * A read-only snapshot of a tree, holding its values in a single array in the order of a layout,
+ * so there are no nodes to load, and a search always steps forward in the array
+ */
+typedef struct _FrozenTree _FrozenTree;
+
+
+/**
+ * Ways to lay values out in a snapshot
+ */
+typedef enum
+{
+    /**
+     * Level by level, the sons of index k being at 2k and 2k + 1
+     */
+    BreadthFirstLayout,
+
+    /**
+     * The top half of the levels first, then each of the trees hanging below, each of them laid out
+     * the same way, so that any path crosses few cache lines whatever their size (van Emde Boas layout),
+     * the last level being as wide as if it was full
+     */
+    VanEmdeBoasLayout
+} FrozenTreeLayout;
+
+
+
+
+typedef struct
+{
+    /**
+     * @param compareCallback - the callback to compare elements with, should return :
+     *  < 0 if current value is smaller,
+     *  > 0 if other value is smaller,
+     *  = 0 if both are equal
+     * @param values - the values to store, sorted according to the callback
+     * @param count - the number of values
+     * @param layout - the order to lay values out in
+     *
+     * @return - a snapshot holding the values, or NULL if allocation failed
+     */
+    _FrozenTree * (* constructor)(
+        int (* compareValuesCallback)(void const * const currentValue, void const * const otherValue),
+        void const * const * const values,
+        unsigned int count,
+        FrozenTreeLayout layout
+    );
+
+    /**
+     * Destroys the snapshot, and sets it to NULL
+     */
+    void (* destructor)(_FrozenTree ** this);
+
+    /**
+     * @param value - the value to find in the snapshot
+     *
+     * @return - the first value equal to the given one, or NULL if not found
+     */
+    void const * (* find)(_FrozenTree const * const this, void const * const value);
+
+    /**
+     * @param value - the value to find in the snapshot
+     *
+     * @return - 1 if the value was found in the snapshot, 0 otherwise
+     */
+    int (* contains)(_FrozenTree const * const this, void const * const value);
+
+    /**
+     * @param value - the value to step to
+     *
+     * @return - the first value which isn't lesser than the given one, or NULL if there is none
+     */
+    void const * (* seek)(_FrozenTree const * const this, void const * const value);
+
+    /**
+     * @return - the number of values in the snapshot
+     */
+    unsigned int (* size)(_FrozenTree const * const this);
+} FrozenTreeMethods;
+
+
+
+
+/**
+ * FrozenTree methods table
+ */
+extern FrozenTreeMethods const * const FrozenTree;
+
+
+
+
+#endif /* FROZEN_TREE_CLASS_HEADER */
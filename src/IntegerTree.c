@@ -0,0 +1,677 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "Class.h"
+#include "IntegerTree.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define VECTOR_INSTRUCTIONS_AVAILABLE
+#include <immintrin.h>
+#endif
+
+
+
+
+/**
+ * Least number of sons of a node other than the top-most one, which holds one key less
+ */
+#define INTEGER_TREE_MINIMUM_SONS 8
+
+
+/**
+ * Greatest number of keys of a node
+ */
+#define INTEGER_TREE_KEYS (2 * INTEGER_TREE_MINIMUM_SONS - 1)
+
+
+/**
+ * Number of keys compared at once, the last one being unused
+ */
+#define INTEGER_TREE_LANES (INTEGER_TREE_KEYS + 1)
+
+
+typedef struct _IntegerTreeNode _IntegerTreeNode;
+
+
+struct _IntegerTree
+{
+    _IntegerTreeNode * root;
+    unsigned int size;
+};
+
+
+/**
+ * Keys come first and fill a cache line, which vector instructions load at once,
+ * bottom-most nodes have no sons and are allocated without them
+ */
+struct _IntegerTreeNode
+{
+    int keys[INTEGER_TREE_LANES];
+    unsigned int count;
+    int isLeaf;
+    void const * values[INTEGER_TREE_KEYS];
+    _IntegerTreeNode * sons[INTEGER_TREE_KEYS + 1];
+};
+
+
+
+
+/**
+ * @return - the number of keys of the node lesser than the given one, the keys being sorted
+ */
+static unsigned int countLesserKeysOneByOne(int const * const keys, int key, unsigned int count);
+
+
+#ifdef VECTOR_INSTRUCTIONS_AVAILABLE
+/**
+ * Same as countLesserKeysOneByOne, comparing 4 keys at once
+ */
+static unsigned int countLesserKeysWithSse2(int const * const keys, int key, unsigned int count);
+
+
+/**
+ * Same as countLesserKeysOneByOne, comparing 8 keys at once
+ */
+static unsigned int countLesserKeysWithAvx2(int const * const keys, int key, unsigned int count);
+#endif
+
+
+/**
+ * @param isLeaf - 1 for a bottom-most node, allocated without sons, 0 otherwise
+ *
+ * @return - a node without keys, or NULL if allocation failed
+ */
+static _IntegerTreeNode * constructNode(int isLeaf);
+
+
+static void deleteNode(_IntegerTreeNode ** node);
+
+
+/**
+ * Deletes the node along with the nodes below it,
+ * recursion goes as deep as the tree is high, which is logarithmic
+ */
+static void destroyBranch(_IntegerTreeNode ** node);
+
+
+/**
+ * Moves the keys, values and sons of the node from the index on by one place, towards the end if shift is 1,
+ * towards the start if shift is -1, the son before the index staying in place
+ */
+static void shiftEntries(_IntegerTreeNode * const node, unsigned int index, int shift);
+
+
+/**
+ * Splits the full son in two halves, its middle key going up into the node
+ *
+ * @param index - the index of the son to split
+ *
+ * @return - 1 if the son was split, 0 if allocation failed
+ */
+static int splitSon(_IntegerTreeNode * const node, unsigned int index);
+
+
+/**
+ * Merges the son with its right brother, and the key between them
+ *
+ * @param index - the index of the left son
+ */
+static void mergeSons(_IntegerTreeNode * const node, unsigned int index);
+
+
+/**
+ * Makes sure the son holds more than the least number of keys, so that one can be popped below it,
+ * by taking one from a brother, or by merging with one
+ *
+ * @param index - the index of the son to fill
+ *
+ * @return - the index of the son holding the keys which were below the given one
+ */
+static unsigned int fillSon(_IntegerTreeNode * const node, unsigned int index);
+
+
+/**
+ * Moves the greatest key below the node, which holds more than the least number of keys, to the given place
+ */
+static void popGreatest(_IntegerTreeNode * node, int * const key, void const ** const value);
+
+
+/**
+ * Moves the smallest key below the node, which holds more than the least number of keys, to the given place
+ */
+static void popSmallest(_IntegerTreeNode * node, int * const key, void const ** const value);
+
+
+/**
+ * Applies the callback on every key below the node, in order,
+ * recursion goes as deep as the tree is high, which is logarithmic
+ */
+static void mapBranch(_IntegerTreeNode const * const node, void (* callback)(int key, void const * const value));
+
+
+
+
+/**
+ * Node search used by every tree, picked once the processor is known
+ */
+static unsigned int (* countLesserKeys)(int const * const keys, int key, unsigned int count) = NULL;
+
+
+
+
+static void useVectorInstructions(int enabled)
+{
+    countLesserKeys = countLesserKeysOneByOne;
+
+#ifdef VECTOR_INSTRUCTIONS_AVAILABLE
+    if (! enabled)
+        return;
+
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        countLesserKeys = countLesserKeysWithAvx2;
+    else if (__builtin_cpu_supports("sse2"))
+        countLesserKeys = countLesserKeysWithSse2;
+#else
+    (void) enabled;
+#endif
+}
+
+
+static _IntegerTree * constructor(void)
+{
+    _IntegerTree * this = Class->constructor("IntegerTree", sizeof(* this));
+
+    if (this == NULL)
+        return NULL;
+
+    if (countLesserKeys == NULL)
+        useVectorInstructions(1);
+
+    this->root = NULL;
+    this->size = 0;
+
+    return this;
+}
+
+
+static void destructor(_IntegerTree ** this)
+{
+    if ((this == NULL) || (* this == NULL))
+        return;
+
+    destroyBranch(& (* this)->root);
+    Class->destructor("IntegerTree", (void **) this);
+}
+
+
+static void const * find(_IntegerTree const * const this, int key)
+{
+    _IntegerTreeNode const * node;
+    unsigned int index;
+
+    if (this == NULL)
+        return NULL;
+
+    for (node = this->root; node != NULL; node = node->sons[index])
+    {
+        index = countLesserKeys(node->keys, key, node->count);
+        if ((index < node->count) && (node->keys[index] == key))
+            return node->values[index];
+        if (node->isLeaf)
+            return NULL;
+    }
+
+    return NULL;
+}
+
+
+static int contains(_IntegerTree const * const this, int key)
+{
+    _IntegerTreeNode const * node;
+    unsigned int index;
+
+    if (this == NULL)
+        return 0;
+
+    for (node = this->root; node != NULL; node = node->sons[index])
+    {
+        index = countLesserKeys(node->keys, key, node->count);
+        if ((index < node->count) && (node->keys[index] == key))
+            return 1;
+        if (node->isLeaf)
+            return 0;
+    }
+
+    return 0;
+}
+
+
+static int add(_IntegerTree * const this, int key, void const * const value)
+{
+    _IntegerTreeNode * node, * root;
+    unsigned int index;
+
+    if (this == NULL)
+        return 0;
+
+    if (this->root == NULL)
+    {
+        this->root = constructNode(1);
+        if (this->root == NULL)
+            return 0;
+    }
+
+    /* the tree grows from the top, full nodes are split on the way down so that there is room left below */
+    if (this->root->count == INTEGER_TREE_KEYS)
+    {
+        root = constructNode(0);
+        if (root == NULL)
+            return 0;
+
+        root->sons[0] = this->root;
+        if (! splitSon(root, 0))
+        {
+            deleteNode(& root);
+            return 0;
+        }
+        this->root = root;
+    }
+
+    node = this->root;
+    for (;;)
+    {
+        /* equal keys are passed, so that the key goes after them */
+        for (index = countLesserKeys(node->keys, key, node->count); (index < node->count) && (node->keys[index] == key); index++)
+            ;
+        if (node->isLeaf)
+            break;
+
+        if (node->sons[index]->count == INTEGER_TREE_KEYS)
+        {
+            if (! splitSon(node, index))
+                return 0;
+            if (node->keys[index] <= key)
+                index++;
+        }
+        node = node->sons[index];
+    }
+
+    shiftEntries(node, index, 1);
+    node->keys[index] = key;
+    node->values[index] = value;
+    node->count++;
+    this->size++;
+
+    return 1;
+}
+
+
+static unsigned int size(_IntegerTree const * const this)
+{
+    if (this == NULL)
+        return 0;
+
+    return this->size;
+}
+
+
+static unsigned int height(_IntegerTree const * const this)
+{
+    _IntegerTreeNode const * node;
+    unsigned int height = 0;
+
+    if (this == NULL)
+        return 0;
+
+    for (node = this->root; node != NULL; node = node->isLeaf ? NULL : node->sons[0])
+        height++;
+
+    return height;
+}
+
+
+static void const * pop(_IntegerTree * const this, int key)
+{
+    _IntegerTreeNode * node, * emptyRoot;
+    void const * popped = NULL;
+    int found = 0;
+    unsigned int index;
+
+    if ((this == NULL) || (this->root == NULL))
+        return NULL;
+
+    /* sons are filled on the way down, so that removing a key below them never leaves them too small */
+    node = this->root;
+    for (;;)
+    {
+        index = countLesserKeys(node->keys, key, node->count);
+
+        if ((index < node->count) && (node->keys[index] == key))
+        {
+            found = 1;
+            popped = node->values[index];
+
+            if (node->isLeaf)
+            {
+                shiftEntries(node, index + 1, -1);
+                node->count--;
+                break;
+            }
+
+            /* the key is replaced by its closest one below, or both sons are merged around it */
+            if (node->sons[index]->count >= INTEGER_TREE_MINIMUM_SONS)
+            {
+                popGreatest(node->sons[index], & node->keys[index], & node->values[index]);
+                break;
+            }
+            if (node->sons[index + 1]->count >= INTEGER_TREE_MINIMUM_SONS)
+            {
+                popSmallest(node->sons[index + 1], & node->keys[index], & node->values[index]);
+                break;
+            }
+
+            mergeSons(node, index);
+            node = node->sons[index];
+            continue;
+        }
+
+        if (node->isLeaf)
+            break;
+
+        node = node->sons[fillSon(node, index)];
+    }
+
+    if (this->root->count == 0)
+    {
+        emptyRoot = this->root;
+        this->root = emptyRoot->isLeaf ? NULL : emptyRoot->sons[0];
+        deleteNode(& emptyRoot);
+    }
+
+    if (found)
+        this->size--;
+
+    return popped;
+}
+
+
+static void map(_IntegerTree const * const this, void (* callback)(int key, void const * const value))
+{
+    if ((this == NULL) || (this->root == NULL))
+        return;
+
+    mapBranch(this->root, callback);
+}
+
+
+
+
+static unsigned int countLesserKeysOneByOne(int const * const keys, int key, unsigned int count)
+{
+    unsigned int lesser;
+
+    for (lesser = 0; (lesser < count) && (keys[lesser] < key); lesser++)
+        ;
+
+    return lesser;
+}
+
+
+#ifdef VECTOR_INSTRUCTIONS_AVAILABLE
+__attribute__((target("sse2")))
+static unsigned int countLesserKeysWithSse2(int const * const keys, int key, unsigned int count)
+{
+    __m128i wanted = _mm_set1_epi32(key);
+    unsigned int lesser = 0, i;
+
+    /* each comparison gives a bit per key, keys past the count are masked out */
+    for (i = 0; i < INTEGER_TREE_LANES; i += 4)
+        lesser |= (unsigned int) _mm_movemask_ps(
+            _mm_castsi128_ps(_mm_cmpgt_epi32(wanted, _mm_loadu_si128((__m128i const *) (keys + i))))
+        ) << i;
+
+    return __builtin_popcount(lesser & ((1U << count) - 1));
+}
+
+
+__attribute__((target("avx2")))
+static unsigned int countLesserKeysWithAvx2(int const * const keys, int key, unsigned int count)
+{
+    __m256i wanted = _mm256_set1_epi32(key);
+    unsigned int lesser;
+
+    lesser = (unsigned int) _mm256_movemask_ps(
+        _mm256_castsi256_ps(_mm256_cmpgt_epi32(wanted, _mm256_loadu_si256((__m256i const *) keys)))
+    );
+    lesser |= (unsigned int) _mm256_movemask_ps(
+        _mm256_castsi256_ps(_mm256_cmpgt_epi32(wanted, _mm256_loadu_si256((__m256i const *) (keys + 8))))
+    ) << 8;
+
+    return __builtin_popcount(lesser & ((1U << count) - 1));
+}
+#endif
+
+
+static _IntegerTreeNode * constructNode(int isLeaf)
+{
+    _IntegerTreeNode * node;
+
+    if (isLeaf)
+        node = Class->constructor("IntegerTreeLeaf", offsetof(_IntegerTreeNode, sons));
+    else
+        node = Class->constructor("IntegerTreeNode", sizeof(* node));
+
+    if (node == NULL)
+        return NULL;
+
+    /* unused keys are compared too, though masked out */
+    memset(node->keys, 0, sizeof(node->keys));
+    node->count = 0;
+    node->isLeaf = isLeaf;
+
+    return node;
+}
+
+
+static void deleteNode(_IntegerTreeNode ** node)
+{
+    if ((node == NULL) || (* node == NULL))
+        return;
+
+    Class->destructor((* node)->isLeaf ? "IntegerTreeLeaf" : "IntegerTreeNode", (void **) node);
+}
+
+
+static void destroyBranch(_IntegerTreeNode ** node)
+{
+    unsigned int i;
+
+    if ((node == NULL) || (* node == NULL))
+        return;
+
+    if (! (* node)->isLeaf)
+        for (i = 0; i <= (* node)->count; i++)
+            destroyBranch(& (* node)->sons[i]);
+
+    deleteNode(node);
+}
+
+
+static void shiftEntries(_IntegerTreeNode * const node, unsigned int index, int shift)
+{
+    unsigned int moved = node->count - index;
+
+    memmove(node->keys + index + shift, node->keys + index, moved * sizeof(* node->keys));
+    memmove(node->values + index + shift, node->values + index, moved * sizeof(* node->values));
+    if (! node->isLeaf)
+        memmove(node->sons + index + 1 + shift, node->sons + index + 1, moved * sizeof(* node->sons));
+}
+
+
+static int splitSon(_IntegerTreeNode * const node, unsigned int index)
+{
+    _IntegerTreeNode * son = node->sons[index];
+    _IntegerTreeNode * brother = constructNode(son->isLeaf);
+
+    if (brother == NULL)
+        return 0;
+
+    /* the son keeps the lesser half, its brother takes the greater one */
+    brother->count = INTEGER_TREE_MINIMUM_SONS - 1;
+    memcpy(brother->keys, son->keys + INTEGER_TREE_MINIMUM_SONS, brother->count * sizeof(* son->keys));
+    memcpy(brother->values, son->values + INTEGER_TREE_MINIMUM_SONS, brother->count * sizeof(* son->values));
+    if (! son->isLeaf)
+        memcpy(brother->sons, son->sons + INTEGER_TREE_MINIMUM_SONS, INTEGER_TREE_MINIMUM_SONS * sizeof(* son->sons));
+    son->count = INTEGER_TREE_MINIMUM_SONS - 1;
+
+    shiftEntries(node, index, 1);
+    node->keys[index] = son->keys[INTEGER_TREE_MINIMUM_SONS - 1];
+    node->values[index] = son->values[INTEGER_TREE_MINIMUM_SONS - 1];
+    node->sons[index + 1] = brother;
+    node->count++;
+
+    return 1;
+}
+
+
+static void mergeSons(_IntegerTreeNode * const node, unsigned int index)
+{
+    _IntegerTreeNode * son = node->sons[index];
+    _IntegerTreeNode * brother = node->sons[index + 1];
+
+    son->keys[son->count] = node->keys[index];
+    son->values[son->count] = node->values[index];
+    memcpy(son->keys + son->count + 1, brother->keys, brother->count * sizeof(* brother->keys));
+    memcpy(son->values + son->count + 1, brother->values, brother->count * sizeof(* brother->values));
+    if (! son->isLeaf)
+        memcpy(son->sons + son->count + 1, brother->sons, (brother->count + 1) * sizeof(* brother->sons));
+    son->count += brother->count + 1;
+
+    shiftEntries(node, index + 1, -1);
+    node->count--;
+
+    deleteNode(& brother);
+}
+
+
+static unsigned int fillSon(_IntegerTreeNode * const node, unsigned int index)
+{
+    _IntegerTreeNode * son = node->sons[index], * brother;
+
+    if (son->count >= INTEGER_TREE_MINIMUM_SONS)
+        return index;
+
+    if ((index > 0) && (node->sons[index - 1]->count >= INTEGER_TREE_MINIMUM_SONS))
+    {
+        /* the key between them goes down at the front of the son, the last one of the left brother goes up */
+        brother = node->sons[index - 1];
+        memmove(son->keys + 1, son->keys, son->count * sizeof(* son->keys));
+        memmove(son->values + 1, son->values, son->count * sizeof(* son->values));
+        son->keys[0] = node->keys[index - 1];
+        son->values[0] = node->values[index - 1];
+        if (! son->isLeaf)
+        {
+            memmove(son->sons + 1, son->sons, (son->count + 1) * sizeof(* son->sons));
+            son->sons[0] = brother->sons[brother->count];
+        }
+        son->count++;
+
+        brother->count--;
+        node->keys[index - 1] = brother->keys[brother->count];
+        node->values[index - 1] = brother->values[brother->count];
+
+        return index;
+    }
+
+    if ((index < node->count) && (node->sons[index + 1]->count >= INTEGER_TREE_MINIMUM_SONS))
+    {
+        /* the key between them goes down at the back of the son, the first one of the right brother goes up */
+        brother = node->sons[index + 1];
+        son->keys[son->count] = node->keys[index];
+        son->values[son->count] = node->values[index];
+        if (! son->isLeaf)
+            son->sons[son->count + 1] = brother->sons[0];
+        son->count++;
+
+        node->keys[index] = brother->keys[0];
+        node->values[index] = brother->values[0];
+        brother->count--;
+        memmove(brother->keys, brother->keys + 1, brother->count * sizeof(* brother->keys));
+        memmove(brother->values, brother->values + 1, brother->count * sizeof(* brother->values));
+        if (! brother->isLeaf)
+            memmove(brother->sons, brother->sons + 1, (brother->count + 1) * sizeof(* brother->sons));
+
+        return index;
+    }
+
+    if (index < node->count)
+    {
+        mergeSons(node, index);
+        return index;
+    }
+
+    mergeSons(node, index - 1);
+    return index - 1;
+}
+
+
+static void popGreatest(_IntegerTreeNode * node, int * const key, void const ** const value)
+{
+    while (! node->isLeaf)
+        node = node->sons[fillSon(node, node->count)];
+
+    node->count--;
+    * key = node->keys[node->count];
+    * value = node->values[node->count];
+}
+
+
+static void popSmallest(_IntegerTreeNode * node, int * const key, void const ** const value)
+{
+    while (! node->isLeaf)
+        node = node->sons[fillSon(node, 0)];
+
+    * key = node->keys[0];
+    * value = node->values[0];
+    shiftEntries(node, 1, -1);
+    node->count--;
+}
+
+
+static void mapBranch(_IntegerTreeNode const * const node, void (* callback)(int key, void const * const value))
+{
+    unsigned int i;
+
+    for (i = 0; i < node->count; i++)
+    {
+        if (! node->isLeaf)
+            mapBranch(node->sons[i], callback);
+        callback(node->keys[i], node->values[i]);
+    }
+
+    if (! node->isLeaf)
+        mapBranch(node->sons[node->count], callback);
+}
+
+
+
+
+/**
+ * Init IntegerTree methods table
+ */
+static IntegerTreeMethods methods = {
+    constructor,
+    destructor,
+    find,
+    contains,
+    add,
+    size,
+    height,
+    pop,
+    map,
+    useVectorInstructions
+};
+IntegerTreeMethods const * const IntegerTree = & methods;
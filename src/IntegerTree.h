@@ -0,0 +1,100 @@
+#ifndef INTEGER_TREE_CLASS_HEADER
+#define INTEGER_TREE_CLASS_HEADER
+
+
+
+
+/**
+ * A tree of values ordered by integer keys, whose nodes hold up to 15 keys compared all at once
+ * with vector instructions where the processor has them, one by one otherwise, AKA B-tree
+ *
+ * Keys of a node fill a cache line, which they start on when nodes are allocated from pools
+ */
+typedef struct _IntegerTree _IntegerTree;
+
+
+
+
+typedef struct
+{
+    /**
+     * @return - an empty tree, or NULL if allocation failed
+     */
+    _IntegerTree * (* constructor)(void);
+
+    /**
+     * Destroys the tree and all its nodes, and sets it to NULL
+     */
+    void (* destructor)(_IntegerTree ** this);
+
+    /**
+     * @param key - the key to find in the tree
+     *
+     * @return - the value of a key equal to the given one, or NULL if not found
+     */
+    void const * (* find)(_IntegerTree const * const this, int key);
+
+    /**
+     * @param key - the key to find in the tree
+     *
+     * @return - 1 if the key was found in the tree, 0 otherwise
+     */
+    int (* contains)(_IntegerTree const * const this, int key);
+
+    /**
+     * Adds the key after the equal ones already in the tree
+     *
+     * @param key - the key to order the value by
+     * @param value - the value to add in the tree
+     *
+     * @return - 1 if the key was added, 0 if tree is NULL or allocation failed
+     */
+    int (* add)(_IntegerTree * const this, int key, void const * const value);
+
+    /**
+     * @return - the number of keys in the tree
+     */
+    unsigned int (* size)(_IntegerTree const * const this);
+
+    /**
+     * @return - the number of nodes from the top-most one to any of the bottom-most ones
+     */
+    unsigned int (* height)(_IntegerTree const * const this);
+
+    /**
+     * Removes a key equal to the given one from the tree
+     *
+     * @param key - the key to pop from the tree
+     *
+     * @return - the value of the key, or NULL if it was not found
+     */
+    void const * (* pop)(_IntegerTree * const this, int key);
+
+    /**
+     * Applies the callback on every key in the tree, in order
+     *
+     * @param callback - the callback to apply on each key and its value
+     */
+    void (* map)(_IntegerTree const * const this, void (* callback)(int key, void const * const value));
+
+    /**
+     * Enables or disables vector instructions for every tree,
+     * they are enabled by default where the processor has them
+     *
+     * @param enabled - 1 to compare keys with vector instructions if the processor has them, 0 to compare them one by one
+     */
+    void (* useVectorInstructions)(int enabled);
+} IntegerTreeMethods;
+
+
+
+
+/**
+ * IntegerTree methods table
+ */
+extern IntegerTreeMethods const * const IntegerTree;
+
+
+
+
+#endif /* INTEGER_TREE_CLASS_HEADER */
@@ -0,0 +1,532 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "Class.h"
+#include "IntrusiveTree.h"
+
+
+
+
+struct _IntrusiveTree
+{
+    IntrusiveTreeLinks * root;
+    int (* compare)(IntrusiveTreeLinks const * const currentLinks, IntrusiveTreeLinks const * const otherLinks);
+    unsigned int size;
+};
+
+
+
+
+static int isRedNode(IntrusiveTreeLinks const * const this);
+
+
+static IntrusiveTreeLinks * leftMostNode(IntrusiveTreeLinks * this);
+
+
+static IntrusiveTreeLinks * rightMostNode(IntrusiveTreeLinks * this);
+
+
+/**
+ * Recolors and rotates nodes above the newly added one until no red node has a red son
+ */
+static void repairAfterInsertion(_IntrusiveTree * const this, IntrusiveTreeLinks * node);
+
+
+/**
+ * Makes the right son of the node take its place, the node becomes its left son
+ */
+static void rotateLeft(_IntrusiveTree * const this, IntrusiveTreeLinks * const node);
+
+
+/**
+ * Makes the left son of the node take its place, the node becomes its right son
+ */
+static void rotateRight(_IntrusiveTree * const this, IntrusiveTreeLinks * const node);
+
+
+/**
+ * Links the replacement to the parent of the node, or makes it the root
+ *
+ * @param replacement - the node taking the place, can be NULL
+ */
+static void replaceInParent(
+    _IntrusiveTree * const this,
+    IntrusiveTreeLinks const * const node,
+    IntrusiveTreeLinks * const replacement
+);
+
+
+/**
+ * Recolors and rotates nodes around the branch missing a black node,
+ * until every path from the root has the same number of black nodes again
+ *
+ * @param node - the node which took the place of the removed one, can be NULL
+ * @param parent - the parent of that node
+ */
+static void repairAfterRemoval(
+    _IntrusiveTree * const this,
+    IntrusiveTreeLinks * node,
+    IntrusiveTreeLinks * parent
+);
+
+
+/**
+ * Recursion goes as deep as the tree is high, which is logarithmic
+ *
+ * @return - the number of nodes from the node to the deepest one below it
+ */
+static unsigned int branchHeight(IntrusiveTreeLinks const * const this);
+
+
+
+
+static _IntrusiveTree * constructor(
+    int (* compareLinksCallback)(IntrusiveTreeLinks const * const currentLinks, IntrusiveTreeLinks const * const otherLinks)
+)
+{
+    _IntrusiveTree * this = Class->constructor("IntrusiveTree", sizeof(* this));
+
+    if (this == NULL)
+        return NULL;
+
+    this->root = NULL;
+    this->compare = compareLinksCallback;
+    this->size = 0;
+
+    return this;
+}
+
+
+static void destructor(_IntrusiveTree ** this)
+{
+    Class->destructor("IntrusiveTree", (void **) this);
+}
+
+
+static IntrusiveTreeLinks * find(_IntrusiveTree const * const this, IntrusiveTreeLinks const * const probe)
+{
+    IntrusiveTreeLinks * node;
+    int comparison;
+
+    if (this == NULL)
+        return NULL;
+
+    for (node = this->root; node != NULL; node = (comparison > 0) ? node->leftNode : node->rightNode)
+    {
+        comparison = this->compare(node, probe);
+        if (comparison == 0)
+            return node;
+    }
+
+    return NULL;
+}
+
+
+static int contains(_IntrusiveTree const * const this, IntrusiveTreeLinks const * const probe)
+{
+    return find(this, probe) != NULL;
+}
+
+
+static int add(_IntrusiveTree * const this, IntrusiveTreeLinks * const links)
+{
+    IntrusiveTreeLinks * parent = NULL, ** place;
+
+    if ((this == NULL) || (links == NULL))
+        return 0;
+
+    for (place = & this->root; * place != NULL; place = (this->compare(* place, links) > 0) ? & (* place)->leftNode : & (* place)->rightNode)
+        parent = * place;
+
+    links->parent = parent;
+    links->leftNode = NULL;
+    links->rightNode = NULL;
+    links->isRed = 1;
+    * place = links;
+    this->size++;
+
+    repairAfterInsertion(this, links);
+
+    return 1;
+}
+
+
+static void removeLinks(_IntrusiveTree * const this, IntrusiveTreeLinks * const links)
+{
+    IntrusiveTreeLinks * successor, * replacement, * replacementParent;
+    int removedRed;
+
+    if ((this == NULL) || (links == NULL))
+        return;
+
+    removedRed = links->isRed;
+
+    if ((links->leftNode == NULL) || (links->rightNode == NULL))
+    {
+        replacement = (links->leftNode != NULL) ? links->leftNode : links->rightNode;
+        replacementParent = links->parent;
+        replaceInParent(this, links, replacement);
+    }
+    else
+    {
+        successor = leftMostNode(links->rightNode);
+
+        removedRed = successor->isRed;
+        replacement = successor->rightNode;
+
+        if (successor->parent == links)
+            replacementParent = successor;
+        else
+        {
+            replacementParent = successor->parent;
+            replaceInParent(this, successor, replacement);
+            successor->rightNode = links->rightNode;
+            successor->rightNode->parent = successor;
+        }
+
+        replaceInParent(this, links, successor);
+        successor->leftNode = links->leftNode;
+        successor->leftNode->parent = successor;
+        successor->isRed = links->isRed;
+    }
+
+    if (! removedRed)
+        repairAfterRemoval(this, replacement, replacementParent);
+
+    links->parent = NULL;
+    links->leftNode = NULL;
+    links->rightNode = NULL;
+    this->size--;
+}
+
+
+static IntrusiveTreeLinks * pop(_IntrusiveTree * const this, IntrusiveTreeLinks const * const probe)
+{
+    IntrusiveTreeLinks * links = find(this, probe);
+
+    if (links != NULL)
+        removeLinks(this, links);
+
+    return links;
+}
+
+
+static unsigned int size(_IntrusiveTree const * const this)
+{
+    if (this == NULL)
+        return 0;
+    return this->size;
+}
+
+
+static IntrusiveTreeLinks * min(_IntrusiveTree const * const this)
+{
+    if ((this == NULL) || (this->root == NULL))
+        return NULL;
+    return leftMostNode(this->root);
+}
+
+
+static IntrusiveTreeLinks * max(_IntrusiveTree const * const this)
+{
+    if ((this == NULL) || (this->root == NULL))
+        return NULL;
+    return rightMostNode(this->root);
+}
+
+
+static IntrusiveTreeLinks * next(IntrusiveTreeLinks * const links)
+{
+    IntrusiveTreeLinks * node = links;
+
+    if (node == NULL)
+        return NULL;
+    if (node->rightNode != NULL)
+        return leftMostNode(node->rightNode);
+
+    while ((node->parent != NULL) && (node->parent->rightNode == node))
+        node = node->parent;
+    return node->parent;
+}
+
+
+static IntrusiveTreeLinks * previous(IntrusiveTreeLinks * const links)
+{
+    IntrusiveTreeLinks * node = links;
+
+    if (node == NULL)
+        return NULL;
+    if (node->leftNode != NULL)
+        return rightMostNode(node->leftNode);
+
+    while ((node->parent != NULL) && (node->parent->leftNode == node))
+        node = node->parent;
+    return node->parent;
+}
+
+
+static unsigned int height(_IntrusiveTree const * const this)
+{
+    if (this == NULL)
+        return 0;
+    return branchHeight(this->root);
+}
+
+
+static void map(_IntrusiveTree const * const this, void (* callback)(IntrusiveTreeLinks * const links))
+{
+    IntrusiveTreeLinks * node;
+
+    for (node = min(this); node != NULL; node = next(node))
+        callback(node);
+}
+
+
+
+
+static int isRedNode(IntrusiveTreeLinks const * const this)
+{
+    return (this != NULL) && this->isRed;
+}
+
+
+static IntrusiveTreeLinks * leftMostNode(IntrusiveTreeLinks * this)
+{
+    while (this->leftNode != NULL)
+        this = this->leftNode;
+
+    return this;
+}
+
+
+static IntrusiveTreeLinks * rightMostNode(IntrusiveTreeLinks * this)
+{
+    while (this->rightNode != NULL)
+        this = this->rightNode;
+
+    return this;
+}
+
+
+static void repairAfterInsertion(_IntrusiveTree * const this, IntrusiveTreeLinks * node)
+{
+    IntrusiveTreeLinks * parent, * grandParent, * uncle;
+
+    /* a red parent is never the root, so the grandparent always exists */
+    while (isRedNode(node->parent))
+    {
+        parent = node->parent;
+        grandParent = parent->parent;
+
+        if (parent == grandParent->leftNode)
+        {
+            uncle = grandParent->rightNode;
+            if (! isRedNode(uncle) && (node == parent->rightNode))
+            {
+                rotateLeft(this, parent);
+                node = parent;
+                parent = node->parent;
+            }
+        }
+        else
+        {
+            uncle = grandParent->leftNode;
+            if (! isRedNode(uncle) && (node == parent->leftNode))
+            {
+                rotateRight(this, parent);
+                node = parent;
+                parent = node->parent;
+            }
+        }
+
+        if (isRedNode(uncle))
+        {
+            parent->isRed = 0;
+            uncle->isRed = 0;
+            grandParent->isRed = 1;
+            node = grandParent;
+            continue;
+        }
+
+        parent->isRed = 0;
+        grandParent->isRed = 1;
+        if (parent == grandParent->leftNode)
+            rotateRight(this, grandParent);
+        else
+            rotateLeft(this, grandParent);
+    }
+
+    this->root->isRed = 0;
+}
+
+
+static void rotateLeft(_IntrusiveTree * const this, IntrusiveTreeLinks * const node)
+{
+    IntrusiveTreeLinks * pivot = node->rightNode;
+
+    node->rightNode = pivot->leftNode;
+    if (pivot->leftNode != NULL)
+        pivot->leftNode->parent = node;
+
+    replaceInParent(this, node, pivot);
+
+    pivot->leftNode = node;
+    node->parent = pivot;
+}
+
+
+static void rotateRight(_IntrusiveTree * const this, IntrusiveTreeLinks * const node)
+{
+    IntrusiveTreeLinks * pivot = node->leftNode;
+
+    node->leftNode = pivot->rightNode;
+    if (pivot->rightNode != NULL)
+        pivot->rightNode->parent = node;
+
+    replaceInParent(this, node, pivot);
+
+    pivot->rightNode = node;
+    node->parent = pivot;
+}
+
+
+static void replaceInParent(
+    _IntrusiveTree * const this,
+    IntrusiveTreeLinks const * const node,
+    IntrusiveTreeLinks * const replacement
+)
+{
+    IntrusiveTreeLinks * parent = node->parent;
+
+    if (replacement != NULL)
+        replacement->parent = parent;
+
+    if (parent == NULL)
+        this->root = replacement;
+    else if (parent->leftNode == node)
+        parent->leftNode = replacement;
+    else
+        parent->rightNode = replacement;
+}
+
+
+static void repairAfterRemoval(
+    _IntrusiveTree * const this,
+    IntrusiveTreeLinks * node,
+    IntrusiveTreeLinks * parent
+)
+{
+    IntrusiveTreeLinks * sibling;
+
+    /* the branch holding the node misses a black node, the sibling branch can't be empty */
+    while ((parent != NULL) && ! isRedNode(node))
+    {
+        if (node == parent->leftNode)
+        {
+            sibling = parent->rightNode;
+            if (isRedNode(sibling))
+            {
+                sibling->isRed = 0;
+                parent->isRed = 1;
+                rotateLeft(this, parent);
+                sibling = parent->rightNode;
+            }
+
+            if (! isRedNode(sibling->leftNode) && ! isRedNode(sibling->rightNode))
+            {
+                sibling->isRed = 1;
+                node = parent;
+                parent = node->parent;
+                continue;
+            }
+
+            if (! isRedNode(sibling->rightNode))
+            {
+                sibling->leftNode->isRed = 0;
+                sibling->isRed = 1;
+                rotateRight(this, sibling);
+                sibling = parent->rightNode;
+            }
+
+            sibling->isRed = parent->isRed;
+            parent->isRed = 0;
+            sibling->rightNode->isRed = 0;
+            rotateLeft(this, parent);
+        }
+        else
+        {
+            sibling = parent->leftNode;
+            if (isRedNode(sibling))
+            {
+                sibling->isRed = 0;
+                parent->isRed = 1;
+                rotateRight(this, parent);
+                sibling = parent->leftNode;
+            }
+
+            if (! isRedNode(sibling->leftNode) && ! isRedNode(sibling->rightNode))
+            {
+                sibling->isRed = 1;
+                node = parent;
+                parent = node->parent;
+                continue;
+            }
+
+            if (! isRedNode(sibling->leftNode))
+            {
+                sibling->rightNode->isRed = 0;
+                sibling->isRed = 1;
+                rotateLeft(this, sibling);
+                sibling = parent->leftNode;
+            }
+
+            sibling->isRed = parent->isRed;
+            parent->isRed = 0;
+            sibling->leftNode->isRed = 0;
+            rotateRight(this, parent);
+        }
+
+        return;
+    }
+
+    if (node != NULL)
+        node->isRed = 0;
+}
+
+
+static unsigned int branchHeight(IntrusiveTreeLinks const * const this)
+{
+    unsigned int leftHeight, rightHeight;
+
+    if (this == NULL)
+        return 0;
+
+    leftHeight = branchHeight(this->leftNode);
+    rightHeight = branchHeight(this->rightNode);
+
+    return 1 + ((leftHeight > rightHeight) ? leftHeight : rightHeight);
+}
+
+
+
+
+/**
+ * Init IntrusiveTree methods table
+ */
+static IntrusiveTreeMethods methods = {
+    constructor,
+    destructor,
+    find,
+    contains,
+    add,
+    removeLinks,
+    pop,
+    size,
+    min,
+    max,
+    next,
+    previous,
+    height,
+    map
+};
+IntrusiveTreeMethods const * const IntrusiveTree = & methods;
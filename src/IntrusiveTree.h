@@ -0,0 +1,155 @@
+#ifndef INTRUSIVE_TREE_CLASS_HEADER
+#define INTRUSIVE_TREE_CLASS_HEADER
+
+
+
+
+#include <stddef.h>
+
+
+
+
+/**
+ * Links of an entry to its neighbours in a tree, to embed in the structure of the entry
+ *
+ * The tree only reads and writes these fields, it never allocates nor deletes entries
+ */
+typedef struct IntrusiveTreeLinks IntrusiveTreeLinks;
+
+struct IntrusiveTreeLinks
+{
+    IntrusiveTreeLinks * parent;
+    IntrusiveTreeLinks * leftNode;
+    IntrusiveTreeLinks * rightNode;
+    int isRed;
+};
+
+
+/**
+ * @param links - the links embedded in an entry
+ * @param Type - the type of the entry
+ * @param member - the name of the links field in the type
+ *
+ * @return - the entry holding the links
+ */
+#define INTRUSIVE_TREE_ENTRY(links, Type, member) ((Type *) ((char *) (links) - offsetof(Type, member)))
+
+
+
+
+/**
+ * A red-black tree of entries linked through the links they embed, so that adding one allocates nothing
+ */
+typedef struct _IntrusiveTree _IntrusiveTree;
+
+
+
+
+typedef struct
+{
+    /**
+     * @param compareCallback - the callback to compare entries with, through their links, should return :
+     *  < 0 if current entry is smaller,
+     *  > 0 if other entry is smaller,
+     *  = 0 if both are equal
+     *
+     * @return - an empty tree, or NULL if allocation failed
+     */
+    _IntrusiveTree * (* constructor)(
+        int (* compareLinksCallback)(IntrusiveTreeLinks const * const currentLinks, IntrusiveTreeLinks const * const otherLinks)
+    );
+
+    /**
+     * Destroys the tree and sets it to NULL, entries are left as they are
+     */
+    void (* destructor)(_IntrusiveTree ** this);
+
+    /**
+     * @param probe - links embedded in an entry holding the key to find, which needs not be in the tree
+     *
+     * @return - the links of an entry equal to the probe, or NULL if not found
+     */
+    IntrusiveTreeLinks * (* find)(_IntrusiveTree const * const this, IntrusiveTreeLinks const * const probe);
+
+    /**
+     * @param probe - links embedded in an entry holding the key to find, which needs not be in the tree
+     *
+     * @return - 1 if an entry equal to the probe is in the tree, 0 otherwise
+     */
+    int (* contains)(_IntrusiveTree const * const this, IntrusiveTreeLinks const * const probe);
+
+    /**
+     * Links the entry into the tree, after the equal ones already in it
+     *
+     * @param links - the links embedded in the entry, which mustn't be in a tree already
+     *
+     * @return - 1 if the entry was added, 0 if tree or links are NULL
+     */
+    int (* add)(_IntrusiveTree * const this, IntrusiveTreeLinks * const links);
+
+    /**
+     * Unlinks the entry from the tree, its links are then free to be added in a tree again
+     *
+     * @param links - the links embedded in an entry of the tree
+     */
+    void (* remove)(_IntrusiveTree * const this, IntrusiveTreeLinks * const links);
+
+    /**
+     * Finds an entry equal to the probe, and unlinks it from the tree
+     *
+     * @param probe - links embedded in an entry holding the key to pop, which needs not be in the tree
+     *
+     * @return - the links of the unlinked entry, or NULL if not found
+     */
+    IntrusiveTreeLinks * (* pop)(_IntrusiveTree * const this, IntrusiveTreeLinks const * const probe);
+
+    /**
+     * @return - the number of entries in the tree
+     */
+    unsigned int (* size)(_IntrusiveTree const * const this);
+
+    /**
+     * @return - the links of the smallest entry, or NULL if tree is empty
+     */
+    IntrusiveTreeLinks * (* min)(_IntrusiveTree const * const this);
+
+    /**
+     * @return - the links of the greatest entry, or NULL if tree is empty
+     */
+    IntrusiveTreeLinks * (* max)(_IntrusiveTree const * const this);
+
+    /**
+     * @return - the links of the entry following the given one in order, or NULL if it's the last one
+     */
+    IntrusiveTreeLinks * (* next)(IntrusiveTreeLinks * const links);
+
+    /**
+     * @return - the links of the entry preceding the given one in order, or NULL if it's the first one
+     */
+    IntrusiveTreeLinks * (* previous)(IntrusiveTreeLinks * const links);
+
+    /**
+     * @return - the number of entries from the root to the deepest one
+     */
+    unsigned int (* height)(_IntrusiveTree const * const this);
+
+    /**
+     * Applies the callback on every entry in the tree, in order
+     *
+     * @param callback - the callback to apply on the links of each entry, which it mustn't unlink
+     */
+    void (* map)(_IntrusiveTree const * const this, void (* callback)(IntrusiveTreeLinks * const links));
+} IntrusiveTreeMethods;
+
+
+
+
+/**
+ * IntrusiveTree methods table
+ */
+extern IntrusiveTreeMethods const * const IntrusiveTree;
+
+
+
+
+#endif /* INTRUSIVE_TREE_CLASS_HEADER */
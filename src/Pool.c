@@ -0,0 +1,244 @@
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "Pool.h"
+
+
+
+
+/**
+ * Size of the chunks blocks are carved from
+ */
+#define POOL_CHUNK_SIZE 65536
+
+
+/**
+ * Blocks whose size is a multiple of this one start on a cache line
+ */
+#define POOL_CACHE_LINE_SIZE 64
+
+
+/**
+ * Blocks are aligned for any of these types
+ */
+typedef union
+{
+    void * pointer;
+    long integer;
+    double real;
+} PoolAlignment;
+
+
+/**
+ * Header of a chunk, its blocks follow it
+ */
+typedef union _PoolChunk
+{
+    union _PoolChunk * next;
+    PoolAlignment alignment;
+} PoolChunk;
+
+
+/**
+ * A released block, linked to the previously released one
+ */
+typedef struct _PoolBlock
+{
+    struct _PoolBlock * next;
+} PoolBlock;
+
+
+struct _Pool
+{
+    unsigned int blockSize;
+    unsigned int blocksPerChunk;
+    int alignsOnCacheLines;
+    PoolChunk * chunks;
+    char * freshBlocks;
+    char * freshBlocksEnd;
+    PoolBlock * releasedBlocks;
+    PoolStatistics statistics;
+};
+
+
+
+
+/**
+ * Requests a new chunk to the system, and makes its blocks the fresh ones
+ *
+ * @param blocks - the number of blocks the chunk holds
+ *
+ * @return - 1 if the chunk was allocated, 0 otherwise
+ */
+static int addChunk(_Pool * const this, unsigned long blocks);
+
+
+
+
+static _Pool * constructor(unsigned int blockSize)
+{
+    _Pool * this = malloc(sizeof(* this));
+
+    if (this == NULL)
+    {
+        fprintf(stderr, "Memory allocation failed for class %s\n", "Pool");
+        return NULL;
+    }
+
+    if (blockSize < sizeof(PoolBlock))
+        blockSize = sizeof(PoolBlock);
+    blockSize += sizeof(PoolAlignment) - 1;
+    blockSize -= blockSize % sizeof(PoolAlignment);
+
+    this->blockSize = blockSize;
+    this->alignsOnCacheLines = (blockSize % POOL_CACHE_LINE_SIZE == 0);
+    this->blocksPerChunk = (POOL_CHUNK_SIZE - sizeof(PoolChunk)) / blockSize;
+    if (this->blocksPerChunk == 0)
+        this->blocksPerChunk = 1;
+
+    this->chunks = NULL;
+    this->freshBlocks = NULL;
+    this->freshBlocksEnd = NULL;
+    this->releasedBlocks = NULL;
+    this->statistics.allocations = 0;
+    this->statistics.releases = 0;
+    this->statistics.reuses = 0;
+    this->statistics.chunks = 0;
+
+    return this;
+}
+
+
+static void destructor(_Pool ** this)
+{
+    PoolChunk * chunk;
+
+    if ((this == NULL) || (* this == NULL))
+        return;
+
+    while ((* this)->chunks != NULL)
+    {
+        chunk = (* this)->chunks;
+        (* this)->chunks = chunk->next;
+        free(chunk);
+    }
+
+    free(* this);
+    * this = NULL;
+}
+
+
+static void * allocate(_Pool * const this)
+{
+    void * block;
+
+    if (this == NULL)
+        return NULL;
+
+    if (this->releasedBlocks != NULL)
+    {
+        block = this->releasedBlocks;
+        this->releasedBlocks = this->releasedBlocks->next;
+        this->statistics.reuses++;
+    }
+    else
+    {
+        if ((this->freshBlocks == this->freshBlocksEnd) && ! addChunk(this, this->blocksPerChunk))
+            return NULL;
+
+        block = this->freshBlocks;
+        this->freshBlocks += this->blockSize;
+    }
+
+    this->statistics.allocations++;
+
+    return block;
+}
+
+
+static void release(_Pool * const this, void * const block)
+{
+    PoolBlock * released = block;
+
+    if ((this == NULL) || (block == NULL))
+        return;
+
+    released->next = this->releasedBlocks;
+    this->releasedBlocks = released;
+    this->statistics.releases++;
+}
+
+
+static int reserve(_Pool * const this, unsigned long count)
+{
+    if (this == NULL)
+        return 0;
+
+    if ((unsigned long) (this->freshBlocksEnd - this->freshBlocks) / this->blockSize >= count)
+        return 1;
+
+    /* the rest of the current chunk is left unused */
+    return addChunk(this, (count > this->blocksPerChunk) ? count : this->blocksPerChunk);
+}
+
+
+static unsigned int blockSize(_Pool const * const this)
+{
+    if (this == NULL)
+        return 0;
+    return this->blockSize;
+}
+
+
+static PoolStatistics statistics(_Pool const * const this)
+{
+    PoolStatistics none = { 0, 0, 0, 0 };
+
+    if (this == NULL)
+        return none;
+    return this->statistics;
+}
+
+
+
+
+static int addChunk(_Pool * const this, unsigned long blocks)
+{
+    unsigned long padding = this->alignsOnCacheLines ? POOL_CACHE_LINE_SIZE - 1 : 0;
+    PoolChunk * chunk = malloc(sizeof(PoolChunk) + padding + blocks * this->blockSize);
+
+    if (chunk == NULL)
+    {
+        fprintf(stderr, "Memory allocation failed for class %s\n", "Pool");
+        return 0;
+    }
+
+    chunk->next = this->chunks;
+    this->chunks = chunk;
+    this->statistics.chunks++;
+
+    this->freshBlocks = (char *) (chunk + 1);
+    if (this->alignsOnCacheLines)
+        this->freshBlocks += (POOL_CACHE_LINE_SIZE - (unsigned long) this->freshBlocks % POOL_CACHE_LINE_SIZE) % POOL_CACHE_LINE_SIZE;
+    this->freshBlocksEnd = this->freshBlocks + blocks * this->blockSize;
+
+    return 1;
+}
+
+
+
+
+/**
+ * Init Pool methods table
+ */
+static PoolMethods methods = {
+    constructor,
+    destructor,
+    allocate,
+    release,
+    reserve,
+    blockSize,
+    statistics
+};
+PoolMethods const * const Pool = & methods;
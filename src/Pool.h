@@ -0,0 +1,106 @@
+#ifndef POOL_CLASS_HEADER
+#define POOL_CLASS_HEADER
+
+
+
+
+/**
+ * Fixed-size blocks allocator, carving blocks from large chunks
+ * and reusing released ones before carving new ones
+ *
+ * Blocks whose size is a multiple of 64 bytes start on a cache line
+ */
+typedef struct _Pool _Pool;
+
+
+
+
+/**
+ * Counters of what a pool did since its creation
+ */
+typedef struct
+{
+    /**
+     * Number of blocks handed out
+     */
+    unsigned long allocations;
+
+    /**
+     * Number of blocks given back
+     */
+    unsigned long releases;
+
+    /**
+     * Number of allocations served by reusing a released block
+     */
+    unsigned long reuses;
+
+    /**
+     * Number of chunks requested to the system
+     */
+    unsigned long chunks;
+} PoolStatistics;
+
+
+
+
+typedef struct
+{
+    /**
+     * @param blockSize - the size of the blocks to hand out
+     *
+     * @return - an empty pool, or NULL if allocation failed
+     */
+    _Pool * (* constructor)(unsigned int blockSize);
+
+    /**
+     * Gives every chunk back to the system at once, blocks handed out become invalid,
+     * and sets the pool to NULL
+     */
+    void (* destructor)(_Pool ** this);
+
+    /**
+     * @return - a block of the size of the pool, or NULL if allocation failed
+     */
+    void * (* allocate)(_Pool * const this);
+
+    /**
+     * Makes the block available for later allocations
+     *
+     * @param block - a block handed out by this pool
+     */
+    void (* release)(_Pool * const this, void * const block);
+
+    /**
+     * Makes sure the next fresh blocks follow each other in a single chunk,
+     * released blocks are still handed out first
+     *
+     * @param count - the number of blocks to keep contiguous
+     *
+     * @return - 1 if the blocks are available, 0 if pool is NULL or allocation failed
+     */
+    int (* reserve)(_Pool * const this, unsigned long count);
+
+    /**
+     * @return - the size of the blocks handed out, aligned for any type
+     */
+    unsigned int (* blockSize)(_Pool const * const this);
+
+    /**
+     * @return - the counters of the pool, all 0 if pool is NULL
+     */
+    PoolStatistics (* statistics)(_Pool const * const this);
+} PoolMethods;
+
+
+
+
+/**
+ * Pool methods table
+ */
+extern PoolMethods const * const Pool;
+
+
+
+
+#endif /* POOL_CLASS_HEADER */
@@ -0,0 +1,106 @@
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Sort.h"
+
+
+
+
+/**
+ * Merges the sorted runs values[first, middle) and values[middle, last) into the sorted ones
+ */
+static void mergeRuns(
+    void const * const * const values,
+    void const ** const sorted,
+    unsigned int first,
+    unsigned int middle,
+    unsigned int last,
+    int (* compareValuesCallback)(void const * const currentValue, void const * const otherValue)
+);
+
+
+
+
+static int sortValues(
+    void const ** const values,
+    unsigned int count,
+    int (* compareValuesCallback)(void const * const currentValue, void const * const otherValue)
+)
+{
+    void const ** buffer, ** from, ** to, ** swapped;
+    unsigned int i, width, middle, last;
+
+    /* batches often come already sorted */
+    for (i = 1; i < count; i++)
+        if (compareValuesCallback(values[i - 1], values[i]) > 0)
+            break;
+    if (i >= count)
+        return 1;
+
+    buffer = malloc(count * sizeof(* buffer));
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Memory allocation failed for class %s\n", "Sort");
+        return 0;
+    }
+
+    /* bottom-up, runs double in width at each pass, going back and forth between both arrays */
+    from = values;
+    to = buffer;
+    for (width = 1; width < count; width *= 2)
+    {
+        for (i = 0; i < count; i += 2 * width)
+        {
+            middle = (count - i > width) ? i + width : count;
+            last = (count - middle > width) ? middle + width : count;
+            mergeRuns(from, to, i, middle, last, compareValuesCallback);
+        }
+
+        swapped = from;
+        from = to;
+        to = swapped;
+    }
+
+    if (from != values)
+        memcpy(values, from, count * sizeof(* values));
+
+    free(buffer);
+
+    return 1;
+}
+
+
+
+
+static void mergeRuns(
+    void const * const * const values,
+    void const ** const sorted,
+    unsigned int first,
+    unsigned int middle,
+    unsigned int last,
+    int (* compareValuesCallback)(void const * const currentValue, void const * const otherValue)
+)
+{
+    unsigned int left = first, right = middle, i;
+
+    for (i = first; i < last; i++)
+    {
+        if ((right == last) || ((left < middle) && (compareValuesCallback(values[left], values[right]) <= 0)))
+            sorted[i] = values[left++];
+        else
+            sorted[i] = values[right++];
+    }
+}
+
+
+
+
+/**
+ * Init Sort methods table
+ */
+static SortMethods methods = {
+    sortValues
+};
+SortMethods const * const Sort = & methods;
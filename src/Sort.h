@@ -0,0 +1,39 @@
+#ifndef SORT_HEADER
+#define SORT_HEADER
+
+
+
+
+typedef struct
+{
+    /**
+     * Sorts the values in place, equal values keep their order
+     *
+     * @param values - the values to sort
+     * @param count - the number of values
+     * @param compareValuesCallback - the callback to compare values with, should return :
+     *  < 0 if current value is smaller,
+     *  > 0 if other value is smaller,
+     *  = 0 if both are equal
+     *
+     * @return - 1 if the values are sorted, 0 if allocation failed
+     */
+    int (* values)(
+        void const ** const values,
+        unsigned int count,
+        int (* compareValuesCallback)(void const * const currentValue, void const * const otherValue)
+    );
+} SortMethods;
+
+
+
+
+/**
+ * Sort methods table
+ */
+extern SortMethods const * const Sort;
+
+
+
+
+#endif /* SORT_HEADER */
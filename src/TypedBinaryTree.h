@@ -0,0 +1,374 @@
+#ifndef TYPED_BINARY_TREE_HEADER
+#define TYPED_BINARY_TREE_HEADER
+
+
+
+
+#include <stddef.h>
+
+#include "Class.h"
+
+
+
+
+/**
+ * Compares two numbers of any type, as comparison macros should :
+ *  < 0 if current key is smaller,
+ *  > 0 if other key is smaller,
+ *  = 0 if both are equal
+ */
+#define COMPARE_NUMBERS(current, other) (((current) > (other)) - ((current) < (other)))
+
+
+
+
+/**
+ * Declares a tree class whose nodes hold keys of the given type inline, to be put in a header
+ *
+ * Along with the opaque _name and _nameNode types, it declares the nameMethods table,
+ * whose methods mirror the ones of BinaryTree with keys passed by value :
+ *  - constructor(void), destructor(& tree)
+ *  - key(node), find(tree, key), contains(tree, key), add(tree, key), pop(tree, key)
+ *  - size(tree), min(tree), max(tree), height(tree)
+ *  - map(tree, callback), calling back with each key in order
+ *  - next(node), previous(node)
+ *
+ * @param name - the name of the class, such as IntegerBinaryTree
+ * @param KeyType - the type of the keys, copied into nodes with =
+ */
+#define DECLARE_BINARY_TREE(name, KeyType) \
+    typedef struct _##name _##name; \
+    typedef struct _##name##Node _##name##Node; \
+    \
+    typedef struct \
+    { \
+        _##name * (* constructor)(void); \
+        void (* destructor)(_##name ** this); \
+        KeyType (* key)(_##name##Node const * const node); \
+        _##name##Node * (* find)(_##name * const this, KeyType key); \
+        int (* contains)(_##name * const this, KeyType key); \
+        _##name##Node * (* add)(_##name * const this, KeyType key); \
+        unsigned int (* size)(_##name const * const this); \
+        _##name##Node * (* min)(_##name const * const this); \
+        _##name##Node * (* max)(_##name const * const this); \
+        unsigned int (* height)(_##name const * const this); \
+        int (* pop)(_##name * const this, KeyType key); \
+        void (* map)(_##name const * const this, void (* callback)(KeyType key)); \
+        _##name##Node * (* next)(_##name##Node * const node); \
+        _##name##Node * (* previous)(_##name##Node * const node); \
+    } name##Methods; \
+    \
+    extern name##Methods const * const name
+
+
+/**
+ * Defines the tree class declared with DECLARE_BINARY_TREE, to be put in a single source file
+ *
+ * Keys are compared by the macro itself rather than through a callback, so that the compiler inlines it,
+ * and are read from the node without following a pointer to a value
+ *
+ * As with BinaryTree, the tree isn't balanced, and equal keys are added after the ones already in it
+ *
+ * @param name - the name given to DECLARE_BINARY_TREE
+ * @param KeyType - the type given to DECLARE_BINARY_TREE
+ * @param COMPARE - a macro or function taking two keys, current one then other one, and returning as COMPARE_NUMBERS
+ */
+#define DEFINE_BINARY_TREE(name, KeyType, COMPARE) \
+    struct _##name \
+    { \
+        _##name##Node * root; \
+        unsigned int size; \
+    }; \
+    \
+    struct _##name##Node \
+    { \
+        KeyType key; \
+        _##name##Node * parent; \
+        _##name##Node * leftNode; \
+        _##name##Node * rightNode; \
+    }; \
+    \
+    \
+    static _##name##Node * name##LeftMostNode(_##name##Node * node) \
+    { \
+        if (node != NULL) \
+            while (node->leftNode != NULL) \
+                node = node->leftNode; \
+        return node; \
+    } \
+    \
+    static _##name##Node * name##RightMostNode(_##name##Node * node) \
+    { \
+        if (node != NULL) \
+            while (node->rightNode != NULL) \
+                node = node->rightNode; \
+        return node; \
+    } \
+    \
+    static void name##ReplaceInParent(_##name * const this, _##name##Node const * const node, _##name##Node * const replacement) \
+    { \
+        if (replacement != NULL) \
+            replacement->parent = node->parent; \
+        if (node->parent == NULL) \
+            this->root = replacement; \
+        else if (node->parent->leftNode == node) \
+            node->parent->leftNode = replacement; \
+        else \
+            node->parent->rightNode = replacement; \
+    } \
+    \
+    static void name##DestroyBranch(_##name##Node * node) \
+    { \
+        _##name##Node * parent; \
+        \
+        /* sons are cut off on the way up, so that no stack is needed however deep the branch is */ \
+        while (node != NULL) \
+        { \
+            if (node->leftNode != NULL) \
+                node = node->leftNode; \
+            else if (node->rightNode != NULL) \
+                node = node->rightNode; \
+            else \
+            { \
+                parent = node->parent; \
+                if (parent != NULL) \
+                { \
+                    if (parent->leftNode == node) \
+                        parent->leftNode = NULL; \
+                    else \
+                        parent->rightNode = NULL; \
+                } \
+                Class->destructor(#name "Node", (void **) & node); \
+                node = parent; \
+            } \
+        } \
+    } \
+    \
+    \
+    static _##name * name##Constructor(void) \
+    { \
+        _##name * this = Class->constructor(#name, sizeof(* this)); \
+        \
+        if (this == NULL) \
+            return NULL; \
+        \
+        this->root = NULL; \
+        this->size = 0; \
+        \
+        return this; \
+    } \
+    \
+    static void name##Destructor(_##name ** this) \
+    { \
+        if ((this == NULL) || (* this == NULL)) \
+            return; \
+        \
+        name##DestroyBranch((* this)->root); \
+        Class->destructor(#name, (void **) this); \
+    } \
+    \
+    static KeyType name##Key(_##name##Node const * const node) \
+    { \
+        return node->key; \
+    } \
+    \
+    static _##name##Node * name##Find(_##name * const this, KeyType key) \
+    { \
+        _##name##Node * node; \
+        int comparison; \
+        \
+        if (this == NULL) \
+            return NULL; \
+        \
+        for (node = this->root; node != NULL; node = (comparison > 0) ? node->leftNode : node->rightNode) \
+        { \
+            comparison = COMPARE(node->key, key); \
+            if (comparison == 0) \
+                return node; \
+        } \
+        \
+        return NULL; \
+    } \
+    \
+    static int name##Contains(_##name * const this, KeyType key) \
+    { \
+        return name##Find(this, key) != NULL; \
+    } \
+    \
+    static _##name##Node * name##Add(_##name * const this, KeyType key) \
+    { \
+        _##name##Node * parent = NULL, ** place, * leaf; \
+        \
+        if (this == NULL) \
+            return NULL; \
+        \
+        for (place = & this->root; * place != NULL; place = (COMPARE((* place)->key, key) > 0) ? & (* place)->leftNode : & (* place)->rightNode) \
+            parent = * place; \
+        \
+        leaf = Class->constructor(#name "Node", sizeof(* leaf)); \
+        if (leaf == NULL) \
+            return NULL; \
+        \
+        leaf->key = key; \
+        leaf->parent = parent; \
+        leaf->leftNode = NULL; \
+        leaf->rightNode = NULL; \
+        * place = leaf; \
+        this->size++; \
+        \
+        return leaf; \
+    } \
+    \
+    static unsigned int name##Size(_##name const * const this) \
+    { \
+        if (this == NULL) \
+            return 0; \
+        return this->size; \
+    } \
+    \
+    static _##name##Node * name##Min(_##name const * const this) \
+    { \
+        if (this == NULL) \
+            return NULL; \
+        return name##LeftMostNode(this->root); \
+    } \
+    \
+    static _##name##Node * name##Max(_##name const * const this) \
+    { \
+        if (this == NULL) \
+            return NULL; \
+        return name##RightMostNode(this->root); \
+    } \
+    \
+    static unsigned int name##Height(_##name const * const this) \
+    { \
+        _##name##Node const * node, * previous = NULL; \
+        unsigned int depth = 1, height = 0; \
+        \
+        if ((this == NULL) || (this->root == NULL)) \
+            return 0; \
+        \
+        /* walks down and up the parent links, knowing where it comes from, so that no stack is needed */ \
+        node = this->root; \
+        while (node != NULL) \
+        { \
+            if (depth > height) \
+                height = depth; \
+            \
+            if ((previous == node->parent) && (node->leftNode != NULL)) \
+            { \
+                previous = node; \
+                node = node->leftNode; \
+                depth++; \
+            } \
+            else if (((previous == node->parent) || (previous == node->leftNode)) && (node->rightNode != NULL)) \
+            { \
+                previous = node; \
+                node = node->rightNode; \
+                depth++; \
+            } \
+            else \
+            { \
+                previous = node; \
+                node = node->parent; \
+                depth--; \
+            } \
+        } \
+        \
+        return height; \
+    } \
+    \
+    static int name##Pop(_##name * const this, KeyType key) \
+    { \
+        _##name##Node * node = name##Find(this, key), * successor; \
+        \
+        if (node == NULL) \
+            return 0; \
+        \
+        if (node->leftNode == NULL) \
+            name##ReplaceInParent(this, node, node->rightNode); \
+        else if (node->rightNode == NULL) \
+            name##ReplaceInParent(this, node, node->leftNode); \
+        else \
+        { \
+            /* the successor leaves its place to its right son, and takes the one of the node */ \
+            successor = name##LeftMostNode(node->rightNode); \
+            if (successor->parent != node) \
+            { \
+                name##ReplaceInParent(this, successor, successor->rightNode); \
+                successor->rightNode = node->rightNode; \
+                successor->rightNode->parent = successor; \
+            } \
+            name##ReplaceInParent(this, node, successor); \
+            successor->leftNode = node->leftNode; \
+            successor->leftNode->parent = successor; \
+        } \
+        \
+        this->size--; \
+        Class->destructor(#name "Node", (void **) & node); \
+        \
+        return 1; \
+    } \
+    \
+    static _##name##Node * name##Next(_##name##Node * const node) \
+    { \
+        _##name##Node * current = node; \
+        \
+        if (current == NULL) \
+            return NULL; \
+        if (current->rightNode != NULL) \
+            return name##LeftMostNode(current->rightNode); \
+        \
+        while ((current->parent != NULL) && (current->parent->rightNode == current)) \
+            current = current->parent; \
+        return current->parent; \
+    } \
+    \
+    static _##name##Node * name##Previous(_##name##Node * const node) \
+    { \
+        _##name##Node * current = node; \
+        \
+        if (current == NULL) \
+            return NULL; \
+        if (current->leftNode != NULL) \
+            return name##RightMostNode(current->leftNode); \
+        \
+        while ((current->parent != NULL) && (current->parent->leftNode == current)) \
+            current = current->parent; \
+        return current->parent; \
+    } \
+    \
+    static void name##Map(_##name const * const this, void (* callback)(KeyType key)) \
+    { \
+        _##name##Node * node; \
+        \
+        if (this == NULL) \
+            return; \
+        \
+        for (node = name##LeftMostNode(this->root); node != NULL; node = name##Next(node)) \
+            callback(node->key); \
+    } \
+    \
+    \
+    static name##Methods name##MethodsTable = { \
+        name##Constructor, \
+        name##Destructor, \
+        name##Key, \
+        name##Find, \
+        name##Contains, \
+        name##Add, \
+        name##Size, \
+        name##Min, \
+        name##Max, \
+        name##Height, \
+        name##Pop, \
+        name##Map, \
+        name##Next, \
+        name##Previous \
+    }; \
+    name##Methods const * const name = & name##MethodsTable
+
+
+
+
+#endif /* TYPED_BINARY_TREE_HEADER */
@@ -0,0 +1,357 @@
+
+#include <stdio.h>
+#include <string.h>
+#include <criterion/criterion.h>
+#include <criterion/redirect.h>
+
+#include "../../src/BTree.h"
+
+#define TREE_NODE_COMPARISON_CALLBACK_TYPE int (*)(void const * const, void const * const)
+#define TO_NODE_COMPARISON_CALLBACK(function) ((TREE_NODE_COMPARISON_CALLBACK_TYPE) function)
+#define STRING_NODE_COMPARISON_CALLBACK TO_NODE_COMPARISON_CALLBACK(strcmp)
+
+
+
+
+static int integerComparisonCallback(int const * const current, int const * const other)
+{
+    return (* current > * other) - (* current < * other);
+}
+
+
+/**
+ * Orders values by their address, so that NULL can be stored
+ */
+static int addressComparisonCallback(void const * const current, void const * const other)
+{
+    return ((size_t) current > (size_t) other) - ((size_t) current < (size_t) other);
+}
+
+
+static int previousMappedInteger;
+static int mappedIntegersAreInOrder;
+static unsigned int mappedIntegers;
+
+
+static void checkIntegerOrderCallback(void const * const value)
+{
+    if ((mappedIntegers > 0) && (* (int const *) value < previousMappedInteger))
+        mappedIntegersAreInOrder = 0;
+
+    previousMappedInteger = * (int const *) value;
+    mappedIntegers++;
+}
+
+
+/**
+ * @return - 1 if mapping the tree meets count values in order, 0 otherwise
+ */
+static int integersAreInOrder(_BTree const * const tree, unsigned int count)
+{
+    mappedIntegersAreInOrder = 1;
+    mappedIntegers = 0;
+
+    BTree->map(tree, checkIntegerOrderCallback);
+
+    return mappedIntegersAreInOrder && (mappedIntegers == count);
+}
+
+
+
+
+Test(b_tree, constructor_allocates_memory)
+{
+    // when creating an instance
+    _BTree * instance = BTree->constructor(NULL);
+
+    // then it shouldn't be null
+    cr_assert_not_null(
+        instance,
+        "Constructor should allocate memory"
+    );
+}
+
+
+Test(b_tree, constructor_creates_an_empty_tree)
+{
+    // when creating an instance
+    _BTree * instance = BTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+
+    // then it should have no value
+    cr_assert_eq(
+        0,
+        BTree->size(instance),
+        "Tree should be empty"
+    );
+    cr_assert_eq(
+        0,
+        BTree->height(instance),
+        "Empty tree should have no height"
+    );
+    cr_assert_null(
+        BTree->min(instance),
+        "Empty tree should have no min"
+    );
+}
+
+
+Test(b_tree, destructor_sets_to_null)
+{
+    // given a tree holding values
+    _BTree * tree = BTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BTree->add(tree, "a");
+    BTree->add(tree, "b");
+
+    // when destroying it
+    BTree->destructor(& tree);
+
+    // then it should be set to null
+    cr_assert_null(
+        tree,
+        "Destructor should set the tree to NULL"
+    );
+}
+
+
+Test(b_tree, finds_added_values)
+{
+    // given a tree of 1000 shuffled values
+    static int values[1000];
+    int i;
+    _BTree * tree = BTree->constructor(TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback));
+    for (i = 0; i < 1000; i++)
+    {
+        values[i] = 2 * ((i * 379) % 1000);
+        BTree->add(tree, & values[i]);
+    }
+
+    // when finding each of them
+    for (i = 0; i < 1000; i++)
+        if (BTree->find(tree, & values[i]) != & values[i])
+            break;
+
+    // then they should all be found, in order
+    cr_assert_eq(
+        1000,
+        i,
+        "Every added value should be found"
+    );
+    cr_assert_eq(
+        1,
+        integersAreInOrder(tree, 1000),
+        "Values should be mapped in order"
+    );
+}
+
+
+Test(b_tree, doesnt_find_missing_value)
+{
+    // given a tree of even values
+    static int values[100];
+    int i, odd = 51;
+    _BTree * tree = BTree->constructor(TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback));
+    for (i = 0; i < 100; i++)
+    {
+        values[i] = 2 * i;
+        BTree->add(tree, & values[i]);
+    }
+
+    // when finding an odd value
+    int found = BTree->contains(tree, & odd);
+
+    // then it shouldn't be found
+    cr_assert_eq(
+        0,
+        found,
+        "Missing value shouldn't be found"
+    );
+}
+
+
+Test(b_tree, keeps_equal_values)
+{
+    // given a tree
+    _BTree * tree = BTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    int i;
+
+    // when adding the same value many times
+    for (i = 0; i < 100; i++)
+        BTree->add(tree, "a");
+
+    // then they should all be kept
+    cr_assert_eq(
+        100,
+        BTree->size(tree),
+        "Equal values should all be added"
+    );
+}
+
+
+Test(b_tree, nodes_are_wide)
+{
+    // given a tree
+    static int values[10000];
+    int i;
+    _BTree * tree = BTree->constructor(TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback));
+
+    // when adding sorted values
+    for (i = 0; i < 10000; i++)
+    {
+        values[i] = i;
+        BTree->add(tree, & values[i]);
+    }
+
+    // then the tree should be far lower than a binary one, even with half full nodes
+    cr_assert_leq(
+        BTree->height(tree),
+        5,
+        "10000 values should fit in 5 levels of nodes"
+    );
+}
+
+
+Test(b_tree, min_and_max_are_the_bounds)
+{
+    // given a tree of shuffled values
+    static int values[500];
+    int i;
+    _BTree * tree = BTree->constructor(TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback));
+    for (i = 0; i < 500; i++)
+    {
+        values[i] = (i * 37) % 500;
+        BTree->add(tree, & values[i]);
+    }
+
+    // when getting its bounds
+    int const * min = BTree->min(tree);
+    int const * max = BTree->max(tree);
+
+    // then they should be the smallest and greatest values
+    cr_assert_eq(
+        0,
+        * min,
+        "Min should be the smallest value"
+    );
+    cr_assert_eq(
+        499,
+        * max,
+        "Max should be the greatest value"
+    );
+}
+
+
+Test(b_tree, pop_removes_values)
+{
+    // given a tree of 1000 shuffled values
+    static int values[1000];
+    int i, popped;
+    _BTree * tree = BTree->constructor(TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback));
+    for (i = 0; i < 1000; i++)
+    {
+        values[i] = (i * 379) % 1000;
+        BTree->add(tree, & values[i]);
+    }
+
+    // when popping every other value, in another order
+    for (i = 0, popped = 0; i < 1000; i++)
+        if ((values[(i * 37) % 1000] % 2 == 0) && (BTree->pop(tree, & values[(i * 37) % 1000]) == & values[(i * 37) % 1000]))
+            popped++;
+
+    // then only the other values should be left, in order
+    for (i = 0; i < 1000; i++)
+        if (BTree->contains(tree, & values[i]) != (values[i] % 2))
+            break;
+    cr_assert_eq(
+        500,
+        popped,
+        "Every popped value should be returned"
+    );
+    cr_assert_eq(
+        1000,
+        i,
+        "Only values which weren't popped should be left"
+    );
+    cr_assert_eq(
+        1,
+        integersAreInOrder(tree, 500),
+        "Values left should be mapped in order"
+    );
+}
+
+
+Test(b_tree, popping_every_value_empties_the_tree)
+{
+    // given a tree of 300 values
+    static int values[300];
+    int i;
+    _BTree * tree = BTree->constructor(TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback));
+    for (i = 0; i < 300; i++)
+    {
+        values[i] = i;
+        BTree->add(tree, & values[i]);
+    }
+
+    // when popping them all
+    for (i = 0; i < 300; i++)
+        BTree->pop(tree, & values[(i * 7) % 300]);
+
+    // then the tree should be empty
+    cr_assert_eq(
+        0,
+        BTree->size(tree),
+        "Tree should be empty"
+    );
+    cr_assert_eq(
+        0,
+        BTree->height(tree),
+        "Empty tree should have no height"
+    );
+}
+
+
+Test(b_tree, popping_missing_value_returns_null)
+{
+    // given a tree
+    _BTree * tree = BTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BTree->add(tree, "a");
+
+    // when popping a value which isn't in it
+    void const * popped = BTree->pop(tree, "b");
+
+    // then nothing should be popped
+    cr_assert_null(
+        popped,
+        "Missing value shouldn't be popped"
+    );
+    cr_assert_eq(
+        1,
+        BTree->size(tree),
+        "Size shouldn't change"
+    );
+}
+
+
+Test(b_tree, popping_null_value_updates_size)
+{
+    // given a tree holding a NULL value among others
+    static int values[2];
+    _BTree * tree = BTree->constructor(addressComparisonCallback);
+    BTree->add(tree, & values[0]);
+    BTree->add(tree, NULL);
+    BTree->add(tree, & values[1]);
+
+    // when popping the NULL value
+    BTree->pop(tree, NULL);
+
+    // then it should be counted out of the tree
+    cr_assert_eq(
+        2,
+        BTree->size(tree),
+        "Popping a stored NULL value should decrease the size"
+    );
+    cr_assert_eq(
+        0,
+        BTree->contains(tree, NULL),
+        "Popped NULL value shouldn't be found anymore"
+    );
+}
@@ -1,5 +1,5 @@
-
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <criterion/criterion.h>
 #include <criterion/redirect.h>
@@ -14,22 +14,88 @@
 
 
 
-static int nodeColor(_BalancedBinaryTree const * const node)
+#ifdef TREE_PACKED_COLORS
+static int isRedNode(_BalancedBinaryTreeNode const * const node)
+{
+    return (* ((size_t *) ((char *) node + 8)) & 1) == 1;
+}
+
+
+static int isBlackNode(_BalancedBinaryTreeNode const * const node)
+{
+    return (* ((size_t *) ((char *) node + 8)) & 1) == 0;
+}
+#else
+#ifdef TREE_ORDER_STATISTICS
+#define NODE_COLOR_OFFSET 36
+#else
+#define NODE_COLOR_OFFSET 32
+#endif
+
+
+static int nodeColor(_BalancedBinaryTreeNode const * const node)
 {
-    return * ((int *) ((char *) node + 40));
+    return * ((int *) ((char *) node + NODE_COLOR_OFFSET));
 }
 
 
-static int isRedNode(_BalancedBinaryTree const * const node)
+static int isRedNode(_BalancedBinaryTreeNode const * const node)
 {
     return nodeColor(node) == ~('R' << 16 | 'E' << 8 | 'D') + 1;
 }
 
 
-static int isBlackNode(_BalancedBinaryTree const * const node)
+static int isBlackNode(_BalancedBinaryTreeNode const * const node)
 {
     return nodeColor(node) == ~('B' << 16 | 'L' << 8 | 'K') + 1;
 }
+#endif
+
+
+static _BalancedBinaryTreeNode * leftSon(_BalancedBinaryTreeNode const * const node)
+{
+    return * ((_BalancedBinaryTreeNode **) ((char *) node + 16));
+}
+
+
+static _BalancedBinaryTreeNode * rightSon(_BalancedBinaryTreeNode const * const node)
+{
+    return * ((_BalancedBinaryTreeNode **) ((char *) node + 24));
+}
+
+
+/**
+ * @return - the number of black nodes on every path down to the leaves,
+ *  or -1 if paths differ or if a red node has a red son
+ */
+static int blackHeight(_BalancedBinaryTreeNode const * const node)
+{
+    int leftHeight, rightHeight;
+
+    if (node == NULL)
+        return 0;
+
+    if (isRedNode(node))
+    {
+        if ((leftSon(node) != NULL) && isRedNode(leftSon(node)))
+            return -1;
+        if ((rightSon(node) != NULL) && isRedNode(rightSon(node)))
+            return -1;
+    }
+
+    leftHeight = blackHeight(leftSon(node));
+    rightHeight = blackHeight(rightSon(node));
+    if ((leftHeight == -1) || (leftHeight != rightHeight))
+        return -1;
+
+    return leftHeight + isBlackNode(node);
+}
+
+
+static int integerComparisonCallback(int const * const current, int const * const other)
+{
+    return (* current > * other) - (* current < * other);
+}
 
 
 
@@ -37,7 +103,7 @@ static int isBlackNode(_BalancedBinaryTree const * const node)
 Test(balanced_binary_tree, constructor_allocates_memory)
 {
     // when creating an instance
-    _BalancedBinaryTree * instance = BalancedBinaryTree->constructor(NULL, NULL);
+    _BalancedBinaryTree * instance = BalancedBinaryTree->constructor(NULL);
 
     // then it shouldn't be null
     cr_assert_not_null(
@@ -47,17 +113,36 @@ Test(balanced_binary_tree, constructor_allocates_memory)
 }
 
 
-Test(balanced_binary_tree, constructor_stores_given_value)
+Test(balanced_binary_tree, constructor_creates_an_empty_tree)
+{
+    // when creating an instance
+    _BalancedBinaryTree * instance = BalancedBinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+
+    // then it should have no node
+    cr_assert_eq(
+        0,
+        BalancedBinaryTree->size(instance),
+        "Constructor should create an empty tree"
+    );
+    cr_assert_null(
+        BalancedBinaryTree->root(instance),
+        "Constructor should create a tree without root"
+    );
+}
+
+
+Test(balanced_binary_tree, adding_stores_given_value)
 {
-    // when storing a value in an element
+    // when storing a value in a tree
     char * value = "root";
-    _BalancedBinaryTree * instance = BalancedBinaryTree->constructor(value, NULL);
+    _BalancedBinaryTree * instance = BalancedBinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    _BalancedBinaryTreeNode * node = BalancedBinaryTree->add(instance, value);
 
     // then the stored value should be the given one
     cr_assert_eq(
-        BalancedBinaryTree->value(instance),
+        BalancedBinaryTree->value(node),
         value,
-        "Constructor should store the given value"
+        "Added node should store the given value"
     );
 }
 
@@ -77,7 +162,7 @@ Test(balanced_binary_tree, destructor_doesnt_crash_when_tree_is_null)
 Test(balanced_binary_tree, destructor_frees_memory)
 {
     // given an instance
-    _BalancedBinaryTree * instance = BalancedBinaryTree->constructor(NULL, NULL);
+    _BalancedBinaryTree * instance = BalancedBinaryTree->constructor(NULL);
 
     // when deleting it
     BalancedBinaryTree->destructor(& instance);
@@ -96,7 +181,8 @@ Test(balanced_binary_tree, destructor_doesnt_affect_stored_value)
     char * value = "some important data";
 
     // when putting it in a tree and deleting it
-    _BalancedBinaryTree * instance = BalancedBinaryTree->constructor(value, NULL);
+    _BalancedBinaryTree * instance = BalancedBinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BalancedBinaryTree->add(instance, value);
     BalancedBinaryTree->destructor(& instance);
 
     // then value should remain intact
@@ -127,7 +213,8 @@ Test(balanced_binary_tree, null_trees_dont_contain_values)
 Test(balanced_binary_tree, finds_node_by_value_when_its_root)
 {
     // given a tree with a value
-    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor("root", STRING_NODE_COMPARISON_CALLBACK);
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BalancedBinaryTree->add(tree, "root");
 
     // when checking if the value is stored
     int isStored = BalancedBinaryTree->contains(tree, "root");
@@ -144,7 +231,8 @@ Test(balanced_binary_tree, finds_node_by_value_when_its_root)
 Test(balanced_binary_tree, finds_node_by_value_when_its_lesser)
 {
     // given a tree with a value added in a later node
-    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor("42", STRING_NODE_COMPARISON_CALLBACK);
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BalancedBinaryTree->add(tree, "42");
     BalancedBinaryTree->add(tree, "41");
 
     // when looking for the latest value
@@ -162,7 +250,8 @@ Test(balanced_binary_tree, finds_node_by_value_when_its_lesser)
 Test(balanced_binary_tree, finds_node_by_value_when_its_greater)
 {
     // given a tree with a value added in a later node
-    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor("42", STRING_NODE_COMPARISON_CALLBACK);
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BalancedBinaryTree->add(tree, "42");
     BalancedBinaryTree->add(tree, "43");
 
     // when looking for the latest value
@@ -180,7 +269,8 @@ Test(balanced_binary_tree, finds_node_by_value_when_its_greater)
 Test(balanced_binary_tree, finds_nothing_when_value_is_not_in_tree)
 {
     // given a tree with differents values
-    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor("root", STRING_NODE_COMPARISON_CALLBACK);
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BalancedBinaryTree->add(tree, "root");
     BalancedBinaryTree->add(tree, "added");
 
     // when checking if another value is stored
@@ -215,10 +305,11 @@ Test(balanced_binary_tree, null_trees_have_no_height)
 Test(balanced_binary_tree, initial_height_is_1)
 {
     // given a tree made of only its root
-    _BalancedBinaryTree * root = BalancedBinaryTree->constructor("root", STRING_NODE_COMPARISON_CALLBACK);
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BalancedBinaryTree->add(tree, "root");
 
     // when checking the height of the tree
-    int height = BalancedBinaryTree->height(root);
+    int height = BalancedBinaryTree->height(tree);
 
     // then it should be 1
     cr_assert_eq(
@@ -232,11 +323,12 @@ Test(balanced_binary_tree, initial_height_is_1)
 Test(balanced_binary_tree, computes_height_from_lesser_value_nodes)
 {
     // given a tree with an added lesser value
-    _BalancedBinaryTree * root = BalancedBinaryTree->constructor("42", STRING_NODE_COMPARISON_CALLBACK);
-    BalancedBinaryTree->add(root, "41");
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BalancedBinaryTree->add(tree, "42");
+    BalancedBinaryTree->add(tree, "41");
 
     // when checking its height
-    int height = BalancedBinaryTree->height(root);
+    int height = BalancedBinaryTree->height(tree);
 
     // then it should be 2
     cr_assert_eq(
@@ -250,11 +342,12 @@ Test(balanced_binary_tree, computes_height_from_lesser_value_nodes)
 Test(balanced_binary_tree, computes_height_from_greater_value_nodes)
 {
     // given a tree with an added greater value
-    _BalancedBinaryTree * root = BalancedBinaryTree->constructor("42", STRING_NODE_COMPARISON_CALLBACK);
-    BalancedBinaryTree->add(root, "43");
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BalancedBinaryTree->add(tree, "42");
+    BalancedBinaryTree->add(tree, "43");
 
     // when checking its height
-    int height = BalancedBinaryTree->height(root);
+    int height = BalancedBinaryTree->height(tree);
 
     // then it should be 2
     cr_assert_eq(
@@ -268,13 +361,14 @@ Test(balanced_binary_tree, computes_height_from_greater_value_nodes)
 Test(balanced_binary_tree, computes_biggest_height_when_its_lesser_than_root)
 {
     // given a tree with a root, a chain of "lesser-values" of length 2, a chain of "greater-values" of length 1
-    _BalancedBinaryTree * root = BalancedBinaryTree->constructor("3", STRING_NODE_COMPARISON_CALLBACK);
-    BalancedBinaryTree->add(root, "2");
-    BalancedBinaryTree->add(root, "1");
-    BalancedBinaryTree->add(root, "4 is greater than the root value");
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BalancedBinaryTree->add(tree, "3");
+    BalancedBinaryTree->add(tree, "4 is greater than the root value");
+    BalancedBinaryTree->add(tree, "2");
+    BalancedBinaryTree->add(tree, "1");
 
     // when checking its height
-    int height = BalancedBinaryTree->height(root);
+    int height = BalancedBinaryTree->height(tree);
 
     // then it should be 3
     cr_assert_eq(
@@ -288,13 +382,14 @@ Test(balanced_binary_tree, computes_biggest_height_when_its_lesser_than_root)
 Test(balanced_binary_tree, computes_biggest_height_when_its_greater_than_root)
 {
     // given a tree with a root, a chain of "greater-values" of length 2, a chain of "lesser-values" of length 1
-    _BalancedBinaryTree * root = BalancedBinaryTree->constructor("1", STRING_NODE_COMPARISON_CALLBACK);
-    BalancedBinaryTree->add(root, "2");
-    BalancedBinaryTree->add(root, "3");
-    BalancedBinaryTree->add(root, "0 is lesser than the root value");
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BalancedBinaryTree->add(tree, "1");
+    BalancedBinaryTree->add(tree, "0 is lesser than the root value");
+    BalancedBinaryTree->add(tree, "2");
+    BalancedBinaryTree->add(tree, "3");
 
     // when checking its height
-    int height = BalancedBinaryTree->height(root);
+    int height = BalancedBinaryTree->height(tree);
 
     // then it should be 3
     cr_assert_eq(
@@ -311,7 +406,7 @@ Test(balanced_binary_tree, finds_nothing_in_null_tree)
     _BalancedBinaryTree * tree = NULL;
 
     // when trying to find any node in it
-    _BalancedBinaryTree * node = BalancedBinaryTree->find(tree, "any value");
+    _BalancedBinaryTreeNode * node = BalancedBinaryTree->find(tree, "any value");
 
     // then it should be NULL
     cr_assert_null(
@@ -324,14 +419,15 @@ Test(balanced_binary_tree, finds_nothing_in_null_tree)
 Test(balanced_binary_tree, finds_root_node)
 {
     // given a tree made of only its root
-    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor("root node", STRING_NODE_COMPARISON_CALLBACK);
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BalancedBinaryTree->add(tree, "root node");
 
     // when trying to find the root node from its value
-    _BalancedBinaryTree * node = BalancedBinaryTree->find(tree, "root node");
+    _BalancedBinaryTreeNode * node = BalancedBinaryTree->find(tree, "root node");
 
     // then the found node should be the root one
     cr_assert_eq(
-        tree,
+        BalancedBinaryTree->root(tree),
         node,
         "Root node should be found when it's the only one in the tree"
     );
@@ -341,11 +437,12 @@ Test(balanced_binary_tree, finds_root_node)
 Test(balanced_binary_tree, finds_lesser_value)
 {
     // given a tree with an added lesser value
-    _BalancedBinaryTree * root = BalancedBinaryTree->constructor("root node", STRING_NODE_COMPARISON_CALLBACK);
-    _BalancedBinaryTree * lesser = BalancedBinaryTree->add(root, "lesser value");
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BalancedBinaryTree->add(tree, "root node");
+    _BalancedBinaryTreeNode * lesser = BalancedBinaryTree->add(tree, "lesser value");
 
     // when trying to find the added lesser value
-    _BalancedBinaryTree * found = BalancedBinaryTree->find(root, "lesser value");
+    _BalancedBinaryTreeNode * found = BalancedBinaryTree->find(tree, "lesser value");
 
     // then it should be the added node
     cr_assert_eq(
@@ -359,11 +456,12 @@ Test(balanced_binary_tree, finds_lesser_value)
 Test(balanced_binary_tree, finds_greater_value)
 {
     // given a tree with an added greater value
-    _BalancedBinaryTree * root = BalancedBinaryTree->constructor("root", STRING_NODE_COMPARISON_CALLBACK);
-    _BalancedBinaryTree * greater = BalancedBinaryTree->add(root, "superior value");
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BalancedBinaryTree->add(tree, "root");
+    _BalancedBinaryTreeNode * greater = BalancedBinaryTree->add(tree, "superior value");
 
     // when trying to find the added greater value
-    _BalancedBinaryTree * found = BalancedBinaryTree->find(root, "superior value");
+    _BalancedBinaryTreeNode * found = BalancedBinaryTree->find(tree, "superior value");
 
     // then it should be the added node
     cr_assert_eq(
@@ -380,21 +478,31 @@ Test(balanced_binary_tree, detaches_nothing_in_null_tree)
     _BalancedBinaryTree * tree = NULL;
 
     // when trying to detach it
-    BalancedBinaryTree->detach(tree);
+    BalancedBinaryTree->detach(tree, NULL);
 
     // then it shouldn't crash
 }
 
 
-Test(balanced_binary_tree, detaching_has_no_effect_on_root)
+Test(balanced_binary_tree, detaching_root_empties_the_tree)
 {
     // given a tree made of only its root
-    _BalancedBinaryTree * root = BalancedBinaryTree->constructor("root", STRING_NODE_COMPARISON_CALLBACK);
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BalancedBinaryTree->add(tree, "root");
 
     // when trying to detach it
-    BalancedBinaryTree->detach(root);
+    _BalancedBinaryTree * branch = BalancedBinaryTree->detach(tree, BalancedBinaryTree->root(tree));
 
-    // then it shouldn't crash
+    // then the tree should be empty, and the branch should hold the root
+    cr_assert_null(
+        BalancedBinaryTree->root(tree),
+        "Detaching the root should leave an empty tree"
+    );
+    cr_assert_eq(
+        1,
+        BalancedBinaryTree->size(branch),
+        "Detaching the root should move it to the branch"
+    );
 }
 
 
@@ -404,7 +512,7 @@ Test(balanced_binary_tree, null_tree_has_no_root)
     _BalancedBinaryTree * tree = NULL;
 
     // when trying to find its root
-    _BalancedBinaryTree * root = BalancedBinaryTree->root(tree);
+    _BalancedBinaryTreeNode * root = BalancedBinaryTree->root(tree);
 
     // then there should be none
     cr_assert_null(
@@ -414,18 +522,19 @@ Test(balanced_binary_tree, null_tree_has_no_root)
 }
 
 
-Test(balanced_binary_tree, finds_root_from_any_node)
+Test(balanced_binary_tree, first_added_value_is_the_root)
 {
     // given a tree with more than 1 value
-    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor("root", STRING_NODE_COMPARISON_CALLBACK);
-    _BalancedBinaryTree * leaf = BalancedBinaryTree->add(tree, "leaf");
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    _BalancedBinaryTreeNode * first = BalancedBinaryTree->add(tree, "root");
+    BalancedBinaryTree->add(tree, "leaf");
 
-    // when trying to find its root from any leaf
-    _BalancedBinaryTree * root = BalancedBinaryTree->root(leaf);
+    // when trying to find its root
+    _BalancedBinaryTreeNode * root = BalancedBinaryTree->root(tree);
 
     // then it should be the right one
     cr_assert_eq(
-        tree,
+        first,
         root,
         "Expected to get the top-most node"
     );
@@ -435,11 +544,12 @@ Test(balanced_binary_tree, finds_root_from_any_node)
 Test(balanced_binary_tree, detached_node_is_not_in_tree_anymore)
 {
     // given a tree with 2 values
-    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor("root", STRING_NODE_COMPARISON_CALLBACK);
-    _BalancedBinaryTree * son = BalancedBinaryTree->add(tree, "son");
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BalancedBinaryTree->add(tree, "root");
+    _BalancedBinaryTreeNode * son = BalancedBinaryTree->add(tree, "son");
 
     // when detaching a non-root node from the tree
-    BalancedBinaryTree->detach(son);
+    BalancedBinaryTree->detach(tree, son);
 
     // then the detached node is not in the tree anymore
     cr_assert_null(
@@ -449,20 +559,31 @@ Test(balanced_binary_tree, detached_node_is_not_in_tree_anymore)
 }
 
 
-Test(balanced_binary_tree, detached_node_has_no_parent_anymore)
+Test(balanced_binary_tree, detached_node_becomes_root_of_a_new_tree)
 {
     // given a tree with 2 values
-    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor("root", STRING_NODE_COMPARISON_CALLBACK);
-    _BalancedBinaryTree * son = BalancedBinaryTree->add(tree, "son");
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BalancedBinaryTree->add(tree, "root");
+    _BalancedBinaryTreeNode * son = BalancedBinaryTree->add(tree, "son");
 
     // when detaching a non-root node from the tree
-    BalancedBinaryTree->detach(son);
+    _BalancedBinaryTree * branch = BalancedBinaryTree->detach(tree, son);
 
     // then the detached node should be the root of a new tree
     cr_assert_eq(
         son,
-        BalancedBinaryTree->root(son),
-        "Detached node shouldn't have parent anymore"
+        BalancedBinaryTree->root(branch),
+        "Detached node should be the root of the new tree"
+    );
+    cr_assert_eq(
+        1,
+        BalancedBinaryTree->size(branch),
+        "Detached branch should only count its own nodes"
+    );
+    cr_assert_eq(
+        1,
+        BalancedBinaryTree->size(tree),
+        "Tree shouldn't count detached nodes anymore"
     );
 }
 
@@ -481,9 +602,11 @@ Test(balanced_binary_tree, null_tree_cant_be_popped)
 Test(balanced_binary_tree, popping_node_with_only_left_son_removes_it_from_the_tree)
 {
     // given a tree containing a node with no right son
-    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor("root", STRING_NODE_COMPARISON_CALLBACK);
-    _BalancedBinaryTree * node = BalancedBinaryTree->add(tree, "node with only left son");
-    _BalancedBinaryTree * leaf = BalancedBinaryTree->add(tree, "leaf");
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BalancedBinaryTree->add(tree, "root");
+    _BalancedBinaryTreeNode * node = BalancedBinaryTree->add(tree, "node with only left son");
+    _BalancedBinaryTreeNode * sibling = BalancedBinaryTree->add(tree, "sibling");
+    _BalancedBinaryTreeNode * leaf = BalancedBinaryTree->add(tree, "leaf");
 
     // when popping that node
     BalancedBinaryTree->pop(tree, "node with only left son");
@@ -497,40 +620,46 @@ Test(balanced_binary_tree, popping_node_with_only_left_son_removes_it_from_the_t
 }
 
 
-Test(balanced_binary_tree, popping_node_with_only_left_son_becomes_a_root)
+Test(balanced_binary_tree, popping_node_with_only_left_son_returns_its_value)
 {
     // given a tree containing a node with no right son
-    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor("root", STRING_NODE_COMPARISON_CALLBACK);
-    _BalancedBinaryTree * node = BalancedBinaryTree->add(tree, "node with only left son");
-    _BalancedBinaryTree * leaf = BalancedBinaryTree->add(tree, "leaf");
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BalancedBinaryTree->add(tree, "root");
+    _BalancedBinaryTreeNode * node = BalancedBinaryTree->add(tree, "node with only left son");
+    _BalancedBinaryTreeNode * sibling = BalancedBinaryTree->add(tree, "sibling");
+    _BalancedBinaryTreeNode * leaf = BalancedBinaryTree->add(tree, "leaf");
+
+    void const * value = BalancedBinaryTree->value(node);
 
     // when popping that node
-    BalancedBinaryTree->pop(tree, "node with only left son");
+    void const * popped = BalancedBinaryTree->pop(tree, "node with only left son");
 
-    // then it should be its own root afterwards
+    // then the stored value should be returned
     cr_assert_eq(
-        node,
-        BalancedBinaryTree->root(node),
-        "Popped node should be its own root"
+        value,
+        popped,
+        "Popping should return the stored value"
     );
 }
 
 
-Test(balanced_binary_tree, popping_node_with_only_left_son_makes_a_single_node_tree)
+Test(balanced_binary_tree, popping_node_with_only_left_son_decrements_size)
 {
     // given a tree containing a node with no right son
-    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor("root", STRING_NODE_COMPARISON_CALLBACK);
-    _BalancedBinaryTree * node = BalancedBinaryTree->add(tree, "node with only left son");
-    _BalancedBinaryTree * leaf = BalancedBinaryTree->add(tree, "leaf");
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BalancedBinaryTree->add(tree, "root");
+    _BalancedBinaryTreeNode * node = BalancedBinaryTree->add(tree, "node with only left son");
+    _BalancedBinaryTreeNode * sibling = BalancedBinaryTree->add(tree, "sibling");
+    _BalancedBinaryTreeNode * leaf = BalancedBinaryTree->add(tree, "leaf");
 
     // when popping that node
     BalancedBinaryTree->pop(tree, "node with only left son");
 
-    // the the node should become a tree of height 1
+    // then the tree should have 1 node less
     cr_assert_eq(
-        1,
-        BalancedBinaryTree->height(node),
-        "Popped node should become a tree of height 1"
+        3,
+        BalancedBinaryTree->size(tree),
+        "Popping should decrement the size of the tree"
     );
 }
 
@@ -538,9 +667,11 @@ Test(balanced_binary_tree, popping_node_with_only_left_son_makes_a_single_node_t
 Test(balanced_binary_tree, popping_node_with_only_left_son_lets_sons_in_tree)
 {
     // given a tree containing a node with no right son
-    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor("root", STRING_NODE_COMPARISON_CALLBACK);
-    _BalancedBinaryTree * node = BalancedBinaryTree->add(tree, "node with only left son");
-    _BalancedBinaryTree * leaf = BalancedBinaryTree->add(tree, "leaf");
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BalancedBinaryTree->add(tree, "root");
+    _BalancedBinaryTreeNode * node = BalancedBinaryTree->add(tree, "node with only left son");
+    _BalancedBinaryTreeNode * sibling = BalancedBinaryTree->add(tree, "sibling");
+    _BalancedBinaryTreeNode * leaf = BalancedBinaryTree->add(tree, "leaf");
 
     // when popping that node
     BalancedBinaryTree->pop(tree, "node with only left son");
@@ -557,9 +688,11 @@ Test(balanced_binary_tree, popping_node_with_only_left_son_lets_sons_in_tree)
 Test(balanced_binary_tree, popping_node_with_only_right_son_removes_it_from_the_tree)
 {
     // given a tree containing a node with no left son
-    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor("n1=root", STRING_NODE_COMPARISON_CALLBACK);
-    _BalancedBinaryTree * node = BalancedBinaryTree->add(tree, "n2=node with only right son");
-    _BalancedBinaryTree * leaf = BalancedBinaryTree->add(tree, "n3=leaf");
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BalancedBinaryTree->add(tree, "n1=root");
+    _BalancedBinaryTreeNode * sibling = BalancedBinaryTree->add(tree, "n0=sibling");
+    _BalancedBinaryTreeNode * node = BalancedBinaryTree->add(tree, "n2=node with only right son");
+    _BalancedBinaryTreeNode * leaf = BalancedBinaryTree->add(tree, "n3=leaf");
 
     // when popping that node
     BalancedBinaryTree->pop(tree, "n2=node with only right son");
@@ -573,40 +706,46 @@ Test(balanced_binary_tree, popping_node_with_only_right_son_removes_it_from_the_
 }
 
 
-Test(balanced_binary_tree, popping_node_with_only_right_son_becomes_a_root)
+Test(balanced_binary_tree, popping_node_with_only_right_son_returns_its_value)
 {
     // given a tree containing a node with no left son
-    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor("n1=root", STRING_NODE_COMPARISON_CALLBACK);
-    _BalancedBinaryTree * node = BalancedBinaryTree->add(tree, "n2=node with only right son");
-    _BalancedBinaryTree * leaf = BalancedBinaryTree->add(tree, "n3=leaf");
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BalancedBinaryTree->add(tree, "n1=root");
+    _BalancedBinaryTreeNode * sibling = BalancedBinaryTree->add(tree, "n0=sibling");
+    _BalancedBinaryTreeNode * node = BalancedBinaryTree->add(tree, "n2=node with only right son");
+    _BalancedBinaryTreeNode * leaf = BalancedBinaryTree->add(tree, "n3=leaf");
+
+    void const * value = BalancedBinaryTree->value(node);
 
     // when popping that node
-    BalancedBinaryTree->pop(tree, "n2=node with only right son");
+    void const * popped = BalancedBinaryTree->pop(tree, "n2=node with only right son");
 
-    // then it should be its own root afterwards
+    // then the stored value should be returned
     cr_assert_eq(
-        node,
-        BalancedBinaryTree->root(node),
-        "Popped node should be its own root"
+        value,
+        popped,
+        "Popping should return the stored value"
     );
 }
 
 
-Test(balanced_binary_tree, popping_node_with_only_right_son_makes_a_single_node_tree)
+Test(balanced_binary_tree, popping_node_with_only_right_son_decrements_size)
 {
     // given a tree containing a node with no left son
-    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor("n1=root", STRING_NODE_COMPARISON_CALLBACK);
-    _BalancedBinaryTree * node = BalancedBinaryTree->add(tree, "n2=node with only right son");
-    _BalancedBinaryTree * leaf = BalancedBinaryTree->add(tree, "n3=leaf");
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BalancedBinaryTree->add(tree, "n1=root");
+    _BalancedBinaryTreeNode * sibling = BalancedBinaryTree->add(tree, "n0=sibling");
+    _BalancedBinaryTreeNode * node = BalancedBinaryTree->add(tree, "n2=node with only right son");
+    _BalancedBinaryTreeNode * leaf = BalancedBinaryTree->add(tree, "n3=leaf");
 
     // when popping that node
     BalancedBinaryTree->pop(tree, "n2=node with only right son");
 
-    // the the node should become a tree of height 1
+    // then the tree should have 1 node less
     cr_assert_eq(
-        1,
-        BalancedBinaryTree->height(node),
-        "Popped node should become a tree of height 1"
+        3,
+        BalancedBinaryTree->size(tree),
+        "Popping should decrement the size of the tree"
     );
 }
 
@@ -614,9 +753,11 @@ Test(balanced_binary_tree, popping_node_with_only_right_son_makes_a_single_node_
 Test(balanced_binary_tree, popping_node_with_only_right_son_lets_sons_in_tree)
 {
     // given a tree containing a node with no left son
-    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor("n1=root", STRING_NODE_COMPARISON_CALLBACK);
-    _BalancedBinaryTree * node = BalancedBinaryTree->add(tree, "n2=node with only right son");
-    _BalancedBinaryTree * leaf = BalancedBinaryTree->add(tree, "n3=leaf");
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BalancedBinaryTree->add(tree, "n1=root");
+    _BalancedBinaryTreeNode * sibling = BalancedBinaryTree->add(tree, "n0=sibling");
+    _BalancedBinaryTreeNode * node = BalancedBinaryTree->add(tree, "n2=node with only right son");
+    _BalancedBinaryTreeNode * leaf = BalancedBinaryTree->add(tree, "n3=leaf");
 
     // when popping that node
     BalancedBinaryTree->pop(tree, "n2=node with only right son");
@@ -633,10 +774,12 @@ Test(balanced_binary_tree, popping_node_with_only_right_son_lets_sons_in_tree)
 Test(balanced_binary_tree, popping_node_with_2_sons_removes_it_from_the_tree)
 {
     // given a tree containing a node with 2 sons
-    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor("root", STRING_NODE_COMPARISON_CALLBACK);
-    _BalancedBinaryTree * node = BalancedBinaryTree->add(tree, "node with 2 sons");
-    _BalancedBinaryTree * leftLeaf = BalancedBinaryTree->add(tree, "left leaf");
-    _BalancedBinaryTree * rightLeaf  = BalancedBinaryTree->add(tree, "right leaf");
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BalancedBinaryTree->add(tree, "root");
+    _BalancedBinaryTreeNode * node = BalancedBinaryTree->add(tree, "node with 2 sons");
+    _BalancedBinaryTreeNode * sibling = BalancedBinaryTree->add(tree, "sibling");
+    _BalancedBinaryTreeNode * leftLeaf = BalancedBinaryTree->add(tree, "left leaf");
+    _BalancedBinaryTreeNode * rightLeaf  = BalancedBinaryTree->add(tree, "right leaf");
 
     // when popping that node
     BalancedBinaryTree->pop(tree, "node with 2 sons");
@@ -650,42 +793,48 @@ Test(balanced_binary_tree, popping_node_with_2_sons_removes_it_from_the_tree)
 }
 
 
-Test(balanced_binary_tree, popping_node_with_2_sons_becomes_a_root)
+Test(balanced_binary_tree, popping_node_with_2_sons_returns_its_value)
 {
     // given a tree containing a node with 2 sons
-    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor("root", STRING_NODE_COMPARISON_CALLBACK);
-    _BalancedBinaryTree * node = BalancedBinaryTree->add(tree, "node with 2 sons");
-    _BalancedBinaryTree * leftLeaf = BalancedBinaryTree->add(tree, "left leaf");
-    _BalancedBinaryTree * rightLeaf  = BalancedBinaryTree->add(tree, "right leaf");
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BalancedBinaryTree->add(tree, "root");
+    _BalancedBinaryTreeNode * node = BalancedBinaryTree->add(tree, "node with 2 sons");
+    _BalancedBinaryTreeNode * sibling = BalancedBinaryTree->add(tree, "sibling");
+    _BalancedBinaryTreeNode * leftLeaf = BalancedBinaryTree->add(tree, "left leaf");
+    _BalancedBinaryTreeNode * rightLeaf  = BalancedBinaryTree->add(tree, "right leaf");
+
+    void const * value = BalancedBinaryTree->value(node);
 
     // when popping that node
-    BalancedBinaryTree->pop(tree, "node with 2 sons");
+    void const * popped = BalancedBinaryTree->pop(tree, "node with 2 sons");
 
-    // then it should be its own root afterwards
+    // then the stored value should be returned
     cr_assert_eq(
-        node,
-        BalancedBinaryTree->root(node),
-        "Popped node should be its own root"
+        value,
+        popped,
+        "Popping should return the stored value"
     );
 }
 
 
-Test(balanced_binary_tree, popping_node_with_2_sons_makes_a_single_node_tree)
+Test(balanced_binary_tree, popping_node_with_2_sons_decrements_size)
 {
     // given a tree containing a node with 2 sons
-    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor("root", STRING_NODE_COMPARISON_CALLBACK);
-    _BalancedBinaryTree * node = BalancedBinaryTree->add(tree, "node with 2 sons");
-    _BalancedBinaryTree * leftLeaf = BalancedBinaryTree->add(tree, "left leaf");
-    _BalancedBinaryTree * rightLeaf  = BalancedBinaryTree->add(tree, "right leaf");
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BalancedBinaryTree->add(tree, "root");
+    _BalancedBinaryTreeNode * node = BalancedBinaryTree->add(tree, "node with 2 sons");
+    _BalancedBinaryTreeNode * sibling = BalancedBinaryTree->add(tree, "sibling");
+    _BalancedBinaryTreeNode * leftLeaf = BalancedBinaryTree->add(tree, "left leaf");
+    _BalancedBinaryTreeNode * rightLeaf  = BalancedBinaryTree->add(tree, "right leaf");
 
     // when popping that node
     BalancedBinaryTree->pop(tree, "node with 2 sons");
 
-    // the the node should become a tree of height 1
+    // then the tree should have 1 node less
     cr_assert_eq(
-        1,
-        BalancedBinaryTree->height(node),
-        "Popped node should become a tree of height 1"
+        4,
+        BalancedBinaryTree->size(tree),
+        "Popping should decrement the size of the tree"
     );
 }
 
@@ -693,10 +842,12 @@ Test(balanced_binary_tree, popping_node_with_2_sons_makes_a_single_node_tree)
 Test(balanced_binary_tree, popping_node_with_2_sons_lets_sons_in_tree)
 {
     // given a tree containing a node with 2 sons
-    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor("root", STRING_NODE_COMPARISON_CALLBACK);
-    _BalancedBinaryTree * node = BalancedBinaryTree->add(tree, "node with 2 sons");
-    _BalancedBinaryTree * leftLeaf = BalancedBinaryTree->add(tree, "left leaf");
-    _BalancedBinaryTree * rightLeaf  = BalancedBinaryTree->add(tree, "right leaf");
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BalancedBinaryTree->add(tree, "root");
+    _BalancedBinaryTreeNode * node = BalancedBinaryTree->add(tree, "node with 2 sons");
+    _BalancedBinaryTreeNode * sibling = BalancedBinaryTree->add(tree, "sibling");
+    _BalancedBinaryTreeNode * leftLeaf = BalancedBinaryTree->add(tree, "left leaf");
+    _BalancedBinaryTreeNode * rightLeaf  = BalancedBinaryTree->add(tree, "right leaf");
 
     // when popping that node
     BalancedBinaryTree->pop(tree, "node with 2 sons");
@@ -717,13 +868,14 @@ Test(balanced_binary_tree, popping_node_with_2_sons_lets_sons_in_tree)
 
 // Visited nodes order will be written here
 static int visitedNodesBufferIndex;
-static char visitedNodesBuffer[9];
+static char visitedNodesBuffer[16];
 
 
 static void addVisitedNodeCallbackSetup(void)
 {
     extern int visitedNodesBufferIndex;
     visitedNodesBufferIndex = 0;
+    memset(visitedNodesBuffer, 0, sizeof(visitedNodesBuffer));
 }
 
 
@@ -738,7 +890,8 @@ static void addVisitedNodeCallback(void const * const value)
 Test(balanced_binary_tree, mapping_with_pre_order_visits_node_with_pre_order, .init=addVisitedNodeCallbackSetup)
 {
     // given a tree with several nodes
-    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor("F", STRING_NODE_COMPARISON_CALLBACK);
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BalancedBinaryTree->add(tree, "F");
     BalancedBinaryTree->add(tree, "B");
     BalancedBinaryTree->add(tree, "G");
     BalancedBinaryTree->add(tree, "A");
@@ -753,7 +906,7 @@ Test(balanced_binary_tree, mapping_with_pre_order_visits_node_with_pre_order, .i
 
     // then nodes should be visited in pre-order
     cr_assert_str_eq(
-        "FBADCEGIH",
+        "FBADCEHGI",
         visitedNodesBuffer,
         "Wrong nodes order, got %s", visitedNodesBuffer
     );
@@ -763,7 +916,8 @@ Test(balanced_binary_tree, mapping_with_pre_order_visits_node_with_pre_order, .i
 Test(balanced_binary_tree, mapping_with_in_order_visits_node_with_in_order, .init=addVisitedNodeCallbackSetup)
 {
     // given a tree with several nodes
-    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor("F", STRING_NODE_COMPARISON_CALLBACK);
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BalancedBinaryTree->add(tree, "F");
     BalancedBinaryTree->add(tree, "B");
     BalancedBinaryTree->add(tree, "G");
     BalancedBinaryTree->add(tree, "A");
@@ -788,7 +942,8 @@ Test(balanced_binary_tree, mapping_with_in_order_visits_node_with_in_order, .ini
 Test(balanced_binary_tree, mapping_with_post_order_visits_node_with_post_order, .init=addVisitedNodeCallbackSetup)
 {
     // given a tree with several nodes
-    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor("F", STRING_NODE_COMPARISON_CALLBACK);
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BalancedBinaryTree->add(tree, "F");
     BalancedBinaryTree->add(tree, "B");
     BalancedBinaryTree->add(tree, "G");
     BalancedBinaryTree->add(tree, "A");
@@ -803,7 +958,7 @@ Test(balanced_binary_tree, mapping_with_post_order_visits_node_with_post_order,
 
     // then nodes should be visited with post-order
     cr_assert_str_eq(
-        "ACEDBHIGF",
+        "ACEDBGIHF",
         visitedNodesBuffer,
         "Wrong nodes order, got %s", visitedNodesBuffer
     );
@@ -813,7 +968,8 @@ Test(balanced_binary_tree, mapping_with_post_order_visits_node_with_post_order,
 Test(balanced_binary_tree, root_is_black)
 {
     // given a tree made only of its root
-    _BalancedBinaryTree * root = BalancedBinaryTree->constructor("root", STRING_NODE_COMPARISON_CALLBACK);
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    _BalancedBinaryTreeNode * root = BalancedBinaryTree->add(tree, "root");
 
     // then the root should be black
     cr_assert_neq(
@@ -822,3 +978,1320 @@ Test(balanced_binary_tree, root_is_black)
         "Root node should be black"
     );
 }
+
+
+Test(balanced_binary_tree, added_node_is_red)
+{
+    // given a tree made only of its root
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BalancedBinaryTree->add(tree, "root");
+
+    // when adding a value below it
+    _BalancedBinaryTreeNode * son = BalancedBinaryTree->add(tree, "son");
+
+    // then the new node should be red
+    cr_assert_neq(
+        0,
+        isRedNode(son),
+        "Added node should be red"
+    );
+}
+
+
+Test(balanced_binary_tree, adding_keeps_track_of_rotated_root)
+{
+    // given a tree whose root will be rotated down by the next insertion
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BalancedBinaryTree->add(tree, "1");
+    BalancedBinaryTree->add(tree, "2");
+
+    // when adding a value making a chain of 3 nodes
+    BalancedBinaryTree->add(tree, "3");
+
+    // then the root should be the middle value
+    cr_assert_str_eq(
+        "2",
+        BalancedBinaryTree->value(BalancedBinaryTree->root(tree)),
+        "Tree should keep track of its root when rotations move it"
+    );
+}
+
+
+Test(balanced_binary_tree, adding_sorted_values_keeps_tree_balanced)
+{
+    // given sorted values
+    static int values[1023];
+    int i;
+    for (i = 0; i < 1023; i++)
+        values[i] = i;
+
+    // when adding them in order
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback));
+    for (i = 0; i < 1023; i++)
+        BalancedBinaryTree->add(tree, & values[i]);
+
+    // then the height should stay within the red/black bound of 2 * log2(n + 1)
+    cr_assert_neq(
+        0,
+        BalancedBinaryTree->height(tree) <= 20,
+        "Sorted insertions shouldn't degenerate, got height %u", BalancedBinaryTree->height(tree)
+    );
+}
+
+
+Test(balanced_binary_tree, adding_keeps_red_black_invariants)
+{
+    // given shuffled values
+    static int values[500];
+    int i;
+    for (i = 0; i < 500; i++)
+        values[i] = (i * 7919) % 500;
+
+    // when adding them
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback));
+    for (i = 0; i < 500; i++)
+        BalancedBinaryTree->add(tree, & values[i]);
+
+    // then the root should be black and every path should have the same black height
+    cr_assert_neq(
+        0,
+        isBlackNode(BalancedBinaryTree->root(tree)),
+        "Root node should be black"
+    );
+    cr_assert_neq(
+        -1,
+        blackHeight(BalancedBinaryTree->root(tree)),
+        "Red/black invariants should hold after insertions"
+    );
+}
+
+
+Test(balanced_binary_tree, popping_root_keeps_track_of_new_root)
+{
+    // given a tree with 3 values
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BalancedBinaryTree->add(tree, "2");
+    BalancedBinaryTree->add(tree, "1");
+    BalancedBinaryTree->add(tree, "3");
+
+    // when popping the root value
+    BalancedBinaryTree->pop(tree, "2");
+
+    // then the new root should be black and hold one of the remaining values
+    cr_assert_neq(
+        0,
+        BalancedBinaryTree->contains(tree, "1") && BalancedBinaryTree->contains(tree, "3"),
+        "Remaining values should still be in the tree"
+    );
+    cr_assert_neq(
+        0,
+        isBlackNode(BalancedBinaryTree->root(tree)),
+        "New root should be black"
+    );
+}
+
+
+Test(balanced_binary_tree, popping_random_values_keeps_red_black_invariants)
+{
+    // given a tree of shuffled values
+    static int values[512];
+    static int order[512];
+    int i, remaining;
+    for (i = 0; i < 512; i++)
+    {
+        values[i] = (i * 7919) % 512;
+        order[i] = i;
+    }
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback));
+    for (i = 0; i < 512; i++)
+        BalancedBinaryTree->add(tree, & values[i]);
+
+    // when popping them in random order
+    srand(42);
+    for (remaining = 512; remaining > 0; remaining--)
+    {
+        int index = rand() % remaining;
+        int poppedIndex = order[index];
+        order[index] = order[remaining - 1];
+
+        void const * popped = BalancedBinaryTree->pop(tree, & values[poppedIndex]);
+
+        // then every removal should keep the invariants
+        cr_assert_eq(
+            & values[poppedIndex],
+            popped,
+            "Stored value %d should be popped", values[poppedIndex]
+        );
+        cr_assert_neq(
+            -1,
+            blackHeight(BalancedBinaryTree->root(tree)),
+            "Red/black invariants should hold after popping %d", values[poppedIndex]
+        );
+        cr_assert_neq(
+            0,
+            (remaining == 1) || isBlackNode(BalancedBinaryTree->root(tree)),
+            "Root node should stay black"
+        );
+    }
+    cr_assert_null(
+        BalancedBinaryTree->root(tree),
+        "Tree should be empty once every value is popped"
+    );
+}
+
+
+Test(balanced_binary_tree, mixed_additions_and_pops_keep_tree_balanced)
+{
+    // given a pool of values
+    static int values[4096];
+    int i;
+    for (i = 0; i < 4096; i++)
+        values[i] = i;
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback));
+
+    // when randomly adding and popping them
+    srand(1337);
+    for (i = 0; i < 20000; i++)
+    {
+        int * value = & values[rand() % 4096];
+        if (BalancedBinaryTree->contains(tree, value))
+            BalancedBinaryTree->pop(tree, value);
+        else
+            BalancedBinaryTree->add(tree, value);
+    }
+
+    // then the invariants should still hold
+    _BalancedBinaryTreeNode * root = BalancedBinaryTree->root(tree);
+    cr_assert_neq(
+        -1,
+        blackHeight(root),
+        "Red/black invariants should hold after additions and pops"
+    );
+    cr_assert_neq(
+        0,
+        BalancedBinaryTree->height(tree) <= 2 * blackHeight(root),
+        "Height should stay within twice the black height"
+    );
+}
+
+
+Test(balanced_binary_tree, size_counts_added_values)
+{
+    // given a tree with 3 values
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BalancedBinaryTree->add(tree, "B");
+    BalancedBinaryTree->add(tree, "A");
+    BalancedBinaryTree->add(tree, "C");
+
+    // when checking its size
+    unsigned int size = BalancedBinaryTree->size(tree);
+
+    // then it should be 3
+    cr_assert_eq(
+        3,
+        size,
+        "Size should count every added value"
+    );
+}
+
+
+Test(balanced_binary_tree, min_and_max_track_added_values)
+{
+    // given a tree with several values
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BalancedBinaryTree->add(tree, "D");
+    _BalancedBinaryTreeNode * smallest = BalancedBinaryTree->add(tree, "A");
+    BalancedBinaryTree->add(tree, "C");
+    _BalancedBinaryTreeNode * greatest = BalancedBinaryTree->add(tree, "F");
+    BalancedBinaryTree->add(tree, "E");
+
+    // then the bounds should be the smallest and greatest values
+    cr_assert_eq(
+        smallest,
+        BalancedBinaryTree->min(tree),
+        "Min should be the node having the smallest value"
+    );
+    cr_assert_eq(
+        greatest,
+        BalancedBinaryTree->max(tree),
+        "Max should be the node having the greatest value"
+    );
+}
+
+
+Test(balanced_binary_tree, popping_bounds_updates_min_and_max)
+{
+    // given a tree with several values
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BalancedBinaryTree->add(tree, "D");
+    BalancedBinaryTree->add(tree, "A");
+    _BalancedBinaryTreeNode * secondSmallest = BalancedBinaryTree->add(tree, "C");
+    BalancedBinaryTree->add(tree, "F");
+    _BalancedBinaryTreeNode * secondGreatest = BalancedBinaryTree->add(tree, "E");
+
+    // when popping the smallest and greatest values
+    BalancedBinaryTree->pop(tree, "A");
+    BalancedBinaryTree->pop(tree, "F");
+
+    // then the bounds should be the next ones
+    cr_assert_eq(
+        secondSmallest,
+        BalancedBinaryTree->min(tree),
+        "Min should be updated when popping the smallest value"
+    );
+    cr_assert_eq(
+        secondGreatest,
+        BalancedBinaryTree->max(tree),
+        "Max should be updated when popping the greatest value"
+    );
+}
+
+
+Test(balanced_binary_tree, popping_root_lets_other_values_in_tree)
+{
+    // given a tree with a root and 2 sons
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BalancedBinaryTree->add(tree, "B");
+    BalancedBinaryTree->add(tree, "A");
+    BalancedBinaryTree->add(tree, "C");
+
+    // when popping the root
+    BalancedBinaryTree->pop(tree, "B");
+
+    // then its sons should remain in the tree
+    cr_assert_neq(
+        0,
+        BalancedBinaryTree->contains(tree, "A") && BalancedBinaryTree->contains(tree, "C"),
+        "Popping the root should let its sons in the tree"
+    );
+    cr_assert_eq(
+        2,
+        BalancedBinaryTree->size(tree),
+        "Popping the root should decrement the size of the tree"
+    );
+}
+
+
+Test(balanced_binary_tree, popping_last_value_empties_the_tree)
+{
+    // given a tree made of only its root
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BalancedBinaryTree->add(tree, "root");
+
+    // when popping its only value
+    BalancedBinaryTree->pop(tree, "root");
+
+    // then the tree should be empty
+    cr_assert_null(
+        BalancedBinaryTree->root(tree),
+        "Tree should have no root once its last value is popped"
+    );
+    cr_assert_null(
+        BalancedBinaryTree->min(tree),
+        "Tree should have no min once its last value is popped"
+    );
+    cr_assert_null(
+        BalancedBinaryTree->max(tree),
+        "Tree should have no max once its last value is popped"
+    );
+}
+
+
+Test(balanced_binary_tree, arena_tree_finds_added_values)
+{
+    // given an arena-backed tree with several values
+    _BalancedBinaryTree * tree = BalancedBinaryTree->arenaConstructor(STRING_NODE_COMPARISON_CALLBACK);
+    BalancedBinaryTree->add(tree, "B");
+    _BalancedBinaryTreeNode * added = BalancedBinaryTree->add(tree, "A");
+    BalancedBinaryTree->add(tree, "C");
+
+    // when looking for one of them
+    _BalancedBinaryTreeNode * found = BalancedBinaryTree->find(tree, "A");
+
+    // then it should be the added node
+    cr_assert_eq(
+        added,
+        found,
+        "Arena-backed trees should find added values"
+    );
+}
+
+
+Test(balanced_binary_tree, arena_tree_reuses_popped_nodes)
+{
+    // given an arena-backed tree from which a value was popped
+    _BalancedBinaryTree * tree = BalancedBinaryTree->arenaConstructor(STRING_NODE_COMPARISON_CALLBACK);
+    BalancedBinaryTree->add(tree, "A");
+    _BalancedBinaryTreeNode * popped = BalancedBinaryTree->add(tree, "B");
+    BalancedBinaryTree->pop(tree, "B");
+
+    // when adding another value
+    _BalancedBinaryTreeNode * added = BalancedBinaryTree->add(tree, "C");
+
+    // then the memory of the popped node should be reused
+    cr_assert_eq(
+        popped,
+        added,
+        "Popped nodes should be reused by later additions"
+    );
+}
+
+
+Test(balanced_binary_tree, arena_tree_destructor_frees_memory)
+{
+    // given an arena-backed tree with a detached branch
+    _BalancedBinaryTree * tree = BalancedBinaryTree->arenaConstructor(STRING_NODE_COMPARISON_CALLBACK);
+    BalancedBinaryTree->add(tree, "B");
+    _BalancedBinaryTreeNode * son = BalancedBinaryTree->add(tree, "A");
+    _BalancedBinaryTree * branch = BalancedBinaryTree->detach(tree, son);
+
+    // when deleting the branch, then the tree
+    BalancedBinaryTree->destructor(& branch);
+    BalancedBinaryTree->destructor(& tree);
+
+    // then both should be null
+    cr_assert_null(
+        branch,
+        "Destructor should free the branch memory"
+    );
+    cr_assert_null(
+        tree,
+        "Destructor should free the tree memory"
+    );
+}
+
+
+Test(balanced_binary_tree, stepping_forward_from_min_visits_values_in_order)
+{
+    // given a tree with shuffled values
+    static int values[] = { 5, 2, 8, 1, 3, 7, 9, 4, 6, 0 };
+    int i;
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback));
+    for (i = 0; i < 10; i++)
+        BalancedBinaryTree->add(tree, & values[i]);
+
+    // when stepping forward from the smallest value
+    _BalancedBinaryTreeNode * node = BalancedBinaryTree->min(tree);
+    for (i = 0; (node != NULL) && (* (int const *) BalancedBinaryTree->value(node) == i); i++)
+        node = BalancedBinaryTree->next(node);
+
+    // then every value should be met in order
+    cr_assert_eq(
+        10,
+        i,
+        "Stepping forward should meet values in order"
+    );
+}
+
+
+Test(balanced_binary_tree, stepping_backward_from_max_visits_values_in_reverse_order)
+{
+    // given a tree with shuffled values
+    static int values[] = { 5, 2, 8, 1, 3, 7, 9, 4, 6, 0 };
+    int i;
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback));
+    for (i = 0; i < 10; i++)
+        BalancedBinaryTree->add(tree, & values[i]);
+
+    // when stepping backward from the greatest value
+    _BalancedBinaryTreeNode * node = BalancedBinaryTree->max(tree);
+    for (i = 9; (node != NULL) && (* (int const *) BalancedBinaryTree->value(node) == i); i--)
+        node = BalancedBinaryTree->previous(node);
+
+    // then every value should be met in reverse order
+    cr_assert_eq(
+        -1,
+        i,
+        "Stepping backward should meet values in reverse order"
+    );
+}
+
+
+Test(balanced_binary_tree, stepping_past_bounds_gives_nothing)
+{
+    // given a tree with some values
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BalancedBinaryTree->add(tree, "b");
+    BalancedBinaryTree->add(tree, "a");
+    BalancedBinaryTree->add(tree, "c");
+
+    // when stepping after the greatest value, and before the smallest one
+    _BalancedBinaryTreeNode * afterMax = BalancedBinaryTree->next(BalancedBinaryTree->max(tree));
+    _BalancedBinaryTreeNode * beforeMin = BalancedBinaryTree->previous(BalancedBinaryTree->min(tree));
+
+    // then no node should be found
+    cr_assert_null(
+        afterMax,
+        "Nothing should follow the greatest value"
+    );
+    cr_assert_null(
+        beforeMin,
+        "Nothing should precede the smallest value"
+    );
+    cr_assert_null(
+        BalancedBinaryTree->next(NULL),
+        "Nothing should follow a null node"
+    );
+}
+
+
+Test(balanced_binary_tree, seeking_stored_value_gives_its_node)
+{
+    // given a tree with some values
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BalancedBinaryTree->add(tree, "b");
+    BalancedBinaryTree->add(tree, "d");
+    _BalancedBinaryTreeNode * node = BalancedBinaryTree->add(tree, "f");
+
+    // when seeking a stored value
+    _BalancedBinaryTreeNode * found = BalancedBinaryTree->seek(tree, "f");
+
+    // then the node holding it should be found
+    cr_assert_eq(
+        node,
+        found,
+        "Seeking a stored value should give its node"
+    );
+}
+
+
+Test(balanced_binary_tree, seeking_missing_value_gives_next_greater_one)
+{
+    // given a tree with some values
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BalancedBinaryTree->add(tree, "b");
+    _BalancedBinaryTreeNode * node = BalancedBinaryTree->add(tree, "d");
+    BalancedBinaryTree->add(tree, "f");
+
+    // when seeking a value which isn't stored
+    _BalancedBinaryTreeNode * found = BalancedBinaryTree->seek(tree, "c");
+
+    // then the node holding the next greater value should be found
+    cr_assert_eq(
+        node,
+        found,
+        "Seeking a missing value should give the next greater one"
+    );
+    cr_assert_null(
+        BalancedBinaryTree->seek(tree, "g"),
+        "Nothing should be found past the greatest value"
+    );
+}
+
+
+Test(balanced_binary_tree, stepping_resumes_after_adding_values)
+{
+    // given a tree walked up to some value
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BalancedBinaryTree->add(tree, "a");
+    BalancedBinaryTree->add(tree, "c");
+    BalancedBinaryTree->add(tree, "e");
+    _BalancedBinaryTreeNode * node = BalancedBinaryTree->seek(tree, "c");
+
+    // when adding values around it, then stepping again
+    BalancedBinaryTree->add(tree, "b");
+    BalancedBinaryTree->add(tree, "d");
+    _BalancedBinaryTreeNode * following = BalancedBinaryTree->next(node);
+
+    // then the walk should meet the newly added value
+    cr_assert_str_eq(
+        BalancedBinaryTree->value(following),
+        "d",
+        "Stepping should resume from where it stopped"
+    );
+}
+
+
+Test(balanced_binary_tree, upper_bound_gives_first_greater_value)
+{
+    // given a tree with some values
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BalancedBinaryTree->add(tree, "b");
+    BalancedBinaryTree->add(tree, "d");
+    BalancedBinaryTree->add(tree, "f");
+
+    // when looking for the values following a stored one, and a missing one
+    _BalancedBinaryTreeNode * afterStored = BalancedBinaryTree->upperBound(tree, "d");
+    _BalancedBinaryTreeNode * afterMissing = BalancedBinaryTree->upperBound(tree, "c");
+
+    // then the next greater values should be found
+    cr_assert_str_eq(
+        BalancedBinaryTree->value(afterStored),
+        "f",
+        "Upper bound of a stored value should be the next one"
+    );
+    cr_assert_str_eq(
+        BalancedBinaryTree->value(afterMissing),
+        "d",
+        "Upper bound of a missing value should be the next greater one"
+    );
+    cr_assert_null(
+        BalancedBinaryTree->upperBound(tree, "f"),
+        "Nothing should be found past the greatest value"
+    );
+}
+
+
+Test(balanced_binary_tree, floor_gives_last_value_not_greater)
+{
+    // given a tree with some values
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BalancedBinaryTree->add(tree, "b");
+    BalancedBinaryTree->add(tree, "d");
+    BalancedBinaryTree->add(tree, "f");
+
+    // when looking for the values preceding a stored one, and a missing one
+    _BalancedBinaryTreeNode * atStored = BalancedBinaryTree->floor(tree, "d");
+    _BalancedBinaryTreeNode * beforeMissing = BalancedBinaryTree->floor(tree, "e");
+
+    // then the stored value, and the previous lesser value should be found
+    cr_assert_str_eq(
+        BalancedBinaryTree->value(atStored),
+        "d",
+        "Floor of a stored value should be itself"
+    );
+    cr_assert_str_eq(
+        BalancedBinaryTree->value(beforeMissing),
+        "d",
+        "Floor of a missing value should be the previous lesser one"
+    );
+    cr_assert_null(
+        BalancedBinaryTree->floor(tree, "a"),
+        "Nothing should be found before the smallest value"
+    );
+}
+
+
+static int rangeVisitedIntegersCount;
+static int rangeVisitedIntegersSum;
+
+
+static void sumRangeIntegersCallback(void const * const value)
+{
+    rangeVisitedIntegersCount++;
+    rangeVisitedIntegersSum += * (int const *) value;
+}
+
+
+Test(balanced_binary_tree, mapping_range_visits_values_between_bounds)
+{
+    // given a tree with 100 values
+    static int values[100];
+    int i;
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback));
+    for (i = 0; i < 100; i++)
+    {
+        values[i] = (i * 37) % 100;
+        BalancedBinaryTree->add(tree, & values[i]);
+    }
+
+    // when applying the callback to values from 20 to 29
+    int lowest = 20, greatest = 29;
+    rangeVisitedIntegersCount = 0;
+    rangeVisitedIntegersSum = 0;
+    BalancedBinaryTree->mapRange(tree, & lowest, & greatest, sumRangeIntegersCallback);
+
+    // then only values between the bounds should be visited
+    cr_assert_eq(
+        10,
+        rangeVisitedIntegersCount,
+        "Every value between the bounds should be visited"
+    );
+    cr_assert_eq(
+        245,
+        rangeVisitedIntegersSum,
+        "Only values between the bounds should be visited"
+    );
+}
+
+
+Test(balanced_binary_tree, mapping_empty_range_visits_nothing)
+{
+    // given a tree with even values
+    static int values[] = { 0, 2, 4, 6, 8 };
+    int i;
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback));
+    for (i = 0; i < 5; i++)
+        BalancedBinaryTree->add(tree, & values[i]);
+
+    // when applying the callback between two consecutive values
+    int lowest = 3, greatest = 3;
+    rangeVisitedIntegersCount = 0;
+    BalancedBinaryTree->mapRange(tree, & lowest, & greatest, sumRangeIntegersCallback);
+
+    // then nothing should be visited
+    cr_assert_eq(
+        0,
+        rangeVisitedIntegersCount,
+        "No value should be visited"
+    );
+}
+
+
+Test(balanced_binary_tree, ranking_counts_lesser_values)
+{
+    // given a tree with even values from 0 to 98, shuffled
+    static int values[50];
+    int i;
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback));
+    for (i = 0; i < 50; i++)
+    {
+        values[i] = ((i * 17) % 50) * 2;
+        BalancedBinaryTree->add(tree, & values[i]);
+    }
+
+    // when ranking a stored value, a missing one, and values past the bounds
+    int stored = 40, missing = 41, smallest = -1, greatest = 1000;
+
+    // then the number of lesser values should be given
+    cr_assert_eq(
+        20,
+        BalancedBinaryTree->rank(tree, & stored),
+        "Rank of a stored value should count the values before it"
+    );
+    cr_assert_eq(
+        21,
+        BalancedBinaryTree->rank(tree, & missing),
+        "Rank of a missing value should count the values before its place"
+    );
+    cr_assert_eq(
+        0,
+        BalancedBinaryTree->rank(tree, & smallest),
+        "No value should be lesser than a value below the smallest one"
+    );
+    cr_assert_eq(
+        50,
+        BalancedBinaryTree->rank(tree, & greatest),
+        "Every value should be lesser than a value above the greatest one"
+    );
+}
+
+
+Test(balanced_binary_tree, selecting_gives_values_by_order)
+{
+    // given a tree with values from 0 to 99, shuffled
+    static int values[100];
+    int i;
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback));
+    for (i = 0; i < 100; i++)
+    {
+        values[i] = (i * 37) % 100;
+        BalancedBinaryTree->add(tree, & values[i]);
+    }
+
+    // when selecting every index
+    for (i = 0; i < 100; i++)
+        if (* (int const *) BalancedBinaryTree->value(BalancedBinaryTree->select(tree, i)) != i)
+            break;
+
+    // then each value should be found at its place, and nothing past the size
+    cr_assert_eq(
+        100,
+        i,
+        "Selecting an index should give the value having that many lesser values"
+    );
+    cr_assert_null(
+        BalancedBinaryTree->select(tree, 100),
+        "Nothing should be selected past the size of the tree"
+    );
+}
+
+
+Test(balanced_binary_tree, selecting_after_popping_skips_popped_values)
+{
+    // given a tree with values from 0 to 99, from which even values are popped
+    static int values[100];
+    int i;
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback));
+    for (i = 0; i < 100; i++)
+    {
+        values[i] = (i * 37) % 100;
+        BalancedBinaryTree->add(tree, & values[i]);
+    }
+    for (i = 0; i < 100; i += 2)
+        BalancedBinaryTree->pop(tree, & i);
+
+    // when selecting every index, and ranking every odd value
+    for (i = 0; i < 50; i++)
+    {
+        int oddValue = 2 * i + 1;
+        if (* (int const *) BalancedBinaryTree->value(BalancedBinaryTree->select(tree, i)) != oddValue)
+            break;
+        if (BalancedBinaryTree->rank(tree, & oddValue) != (unsigned int) i)
+            break;
+    }
+
+    // then only remaining values should be counted
+    cr_assert_eq(
+        50,
+        i,
+        "Popped values should not be selected nor ranked"
+    );
+}
+
+
+Test(balanced_binary_tree, selecting_after_detaching_skips_detached_values)
+{
+    // given a tree with values from 0 to 99, shuffled, from which the branch of the smallest value is detached
+    static int values[100];
+    int i;
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback));
+    for (i = 0; i < 100; i++)
+    {
+        values[i] = (i * 37) % 100;
+        BalancedBinaryTree->add(tree, & values[i]);
+    }
+    _BalancedBinaryTree * branch = BalancedBinaryTree->detach(tree, BalancedBinaryTree->min(tree));
+
+    // when selecting every remaining index, and ranking the selected values
+    unsigned int index;
+    for (index = 0; index < BalancedBinaryTree->size(tree); index++)
+    {
+        _BalancedBinaryTreeNode * node = BalancedBinaryTree->select(tree, index);
+        if ((index > 0) && (BalancedBinaryTree->previous(node) != BalancedBinaryTree->select(tree, index - 1)))
+            break;
+        if (BalancedBinaryTree->rank(tree, BalancedBinaryTree->value(node)) != index)
+            break;
+    }
+
+    // then only the values left in the tree should be counted
+    cr_assert_eq(
+        100 - BalancedBinaryTree->size(branch),
+        index,
+        "Detached values should not be selected nor ranked"
+    );
+    cr_assert_eq(
+        BalancedBinaryTree->min(tree),
+        BalancedBinaryTree->select(tree, 0),
+        "The smallest remaining value should be selected first"
+    );
+}
+
+
+Test(balanced_binary_tree, sorted_constructor_stores_every_value)
+{
+    // given 100 sorted values
+    static int values[100];
+    static void const * sortedValues[100];
+    int i;
+    for (i = 0; i < 100; i++)
+    {
+        values[i] = i;
+        sortedValues[i] = & values[i];
+    }
+
+    // when building a tree out of them
+    _BalancedBinaryTree * tree = BalancedBinaryTree->sortedConstructor(TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback), sortedValues, 100);
+
+    // then every value should be found, between the bounds
+    for (i = 0; i < 100; i++)
+        if (BalancedBinaryTree->value(BalancedBinaryTree->find(tree, & values[i])) != & values[i])
+            break;
+    cr_assert_eq(
+        100,
+        i,
+        "Every value should be found"
+    );
+    cr_assert_eq(
+        100,
+        BalancedBinaryTree->size(tree),
+        "Size should be the number of values"
+    );
+    cr_assert_eq(
+        & values[0],
+        BalancedBinaryTree->value(BalancedBinaryTree->min(tree)),
+        "Min should be the first value"
+    );
+    cr_assert_eq(
+        & values[99],
+        BalancedBinaryTree->value(BalancedBinaryTree->max(tree)),
+        "Max should be the last value"
+    );
+}
+
+
+Test(balanced_binary_tree, sorted_constructor_builds_tree_of_least_height)
+{
+    // given 1000 sorted values
+    static int values[1000];
+    static void const * sortedValues[1000];
+    int i;
+    for (i = 0; i < 1000; i++)
+    {
+        values[i] = i;
+        sortedValues[i] = & values[i];
+    }
+
+    // when building a tree out of them
+    _BalancedBinaryTree * tree = BalancedBinaryTree->sortedConstructor(TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback), sortedValues, 1000);
+
+    // then its height should be the least one holding them
+    cr_assert_eq(
+        10,
+        BalancedBinaryTree->height(tree),
+        "1000 values should fit in 10 levels"
+    );
+}
+
+
+Test(balanced_binary_tree, sorted_constructor_without_values_builds_empty_tree)
+{
+    // when building a tree out of no value
+    _BalancedBinaryTree * tree = BalancedBinaryTree->sortedConstructor(STRING_NODE_COMPARISON_CALLBACK, NULL, 0);
+
+    // then it should be empty
+    cr_assert_not_null(
+        tree,
+        "Tree should be allocated"
+    );
+    cr_assert_null(
+        BalancedBinaryTree->root(tree),
+        "Tree should have no root"
+    );
+}
+
+
+Test(balanced_binary_tree, sorted_tree_accepts_additions_and_pops)
+{
+    // given a tree built out of sorted values
+    static void const * sortedValues[] = { "b", "d", "f", "h" };
+    _BalancedBinaryTree * tree = BalancedBinaryTree->sortedConstructor(STRING_NODE_COMPARISON_CALLBACK, sortedValues, 4);
+
+    // when adding and popping values
+    BalancedBinaryTree->add(tree, "a");
+    BalancedBinaryTree->add(tree, "e");
+    BalancedBinaryTree->pop(tree, "d");
+    BalancedBinaryTree->pop(tree, "h");
+
+    // then the tree should hold the remaining values
+    cr_assert_eq(
+        4,
+        BalancedBinaryTree->size(tree),
+        "Size should follow additions and pops"
+    );
+    cr_assert_str_eq(
+        BalancedBinaryTree->value(BalancedBinaryTree->next(BalancedBinaryTree->seek(tree, "b"))),
+        "e",
+        "Values should stay in order"
+    );
+    cr_assert_str_eq(
+        BalancedBinaryTree->value(BalancedBinaryTree->max(tree)),
+        "f",
+        "Max should follow pops"
+    );
+}
+
+
+Test(balanced_binary_tree, sorted_constructor_keeps_red_black_invariants)
+{
+    // given up to 100 sorted values
+    static int values[100];
+    static void const * sortedValues[100];
+    int i, count;
+    for (i = 0; i < 100; i++)
+    {
+        values[i] = i;
+        sortedValues[i] = & values[i];
+    }
+
+    // when building trees out of every number of them
+    for (count = 1; count <= 100; count++)
+    {
+        _BalancedBinaryTree * tree = BalancedBinaryTree->sortedConstructor(
+            TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback),
+            sortedValues,
+            count
+        );
+        _BalancedBinaryTreeNode * root = BalancedBinaryTree->root(tree);
+        int isValid = isBlackNode(root) && (blackHeight(root) != -1);
+        BalancedBinaryTree->destructor(& tree);
+
+        // then every tree should be a valid red-black tree
+        cr_assert_eq(
+            1,
+            isValid,
+            "Tree of %d sorted values should have a black root and the same black height on every path",
+            count
+        );
+    }
+}
+
+
+/**
+ * @return - 1 if stepping from the smallest value meets every one of them in order, 0 otherwise
+ */
+static int balanced_binary_tree_integersAreInOrder(_BalancedBinaryTree * const tree, unsigned int count)
+{
+    _BalancedBinaryTreeNode * node = BalancedBinaryTree->min(tree);
+    unsigned int met = 0;
+
+    for (; node != NULL; node = BalancedBinaryTree->next(node))
+    {
+        if ((BalancedBinaryTree->next(node) != NULL) && (* (int const *) BalancedBinaryTree->value(node) > * (int const *) BalancedBinaryTree->value(BalancedBinaryTree->next(node))))
+            return 0;
+        met++;
+    }
+
+    return met == count;
+}
+
+
+Test(balanced_binary_tree, adding_many_values_to_empty_tree_stores_them)
+{
+    // given 100 shuffled values
+    static int values[100];
+    static void const * batch[100];
+    int i;
+    for (i = 0; i < 100; i++)
+    {
+        values[i] = (i * 37) % 100;
+        batch[i] = & values[i];
+    }
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback));
+
+    // when adding them all at once to an empty tree
+    unsigned int added = BalancedBinaryTree->addMany(tree, batch, 100);
+
+    // then they should all be stored in order, in a tree of the least height
+    cr_assert_eq(
+        100,
+        added,
+        "Every value should be added"
+    );
+    cr_assert_eq(
+        1,
+        balanced_binary_tree_integersAreInOrder(tree, 100),
+        "Values should be stored in order"
+    );
+    cr_assert_eq(
+        7,
+        BalancedBinaryTree->height(tree),
+        "Tree should be rebuilt with the least height"
+    );
+    cr_assert_eq(
+        0,
+        * (int const *) BalancedBinaryTree->value(BalancedBinaryTree->min(tree)),
+        "Min should be the smallest value of the batch"
+    );
+}
+
+
+Test(balanced_binary_tree, adding_small_batch_to_large_tree_stores_it)
+{
+    // given a tree with 500 even values, and a batch of 50 odd ones
+    static int values[550];
+    static void const * batch[50];
+    int i;
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback));
+    for (i = 0; i < 500; i++)
+    {
+        values[i] = 2 * ((i * 379) % 500);
+        BalancedBinaryTree->add(tree, & values[i]);
+    }
+    for (i = 0; i < 50; i++)
+    {
+        values[500 + i] = 2 * ((i * 17) % 500) + 1;
+        batch[i] = & values[500 + i];
+    }
+
+    // when adding the batch
+    unsigned int added = BalancedBinaryTree->addMany(tree, batch, 50);
+
+    // then every value should be stored in order
+    for (i = 0; i < 550; i++)
+        if (BalancedBinaryTree->find(tree, & values[i]) == NULL)
+            break;
+    cr_assert_eq(
+        50,
+        added,
+        "Every value of the batch should be added"
+    );
+    cr_assert_eq(
+        550,
+        i,
+        "Every value should be found"
+    );
+    cr_assert_eq(
+        1,
+        balanced_binary_tree_integersAreInOrder(tree, 550),
+        "Values should be stored in order"
+    );
+}
+
+
+Test(balanced_binary_tree, adding_many_equal_values_keeps_them_all)
+{
+    // given a tree holding a value, and a batch holding it again
+    static void const * batch[] = { "b", "a", "b" };
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BalancedBinaryTree->add(tree, "b");
+
+    // when adding the batch
+    BalancedBinaryTree->addMany(tree, batch, 3);
+
+    // then every value should be kept
+    cr_assert_eq(
+        4,
+        BalancedBinaryTree->size(tree),
+        "Equal values should all be added"
+    );
+    cr_assert_str_eq(
+        BalancedBinaryTree->value(BalancedBinaryTree->next(BalancedBinaryTree->next(BalancedBinaryTree->next(BalancedBinaryTree->min(tree))))),
+        "b",
+        "Equal values should follow each other"
+    );
+}
+
+
+Test(balanced_binary_tree, adding_no_values_adds_nothing)
+{
+    // given a tree
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BalancedBinaryTree->add(tree, "b");
+
+    // when adding an empty batch
+    unsigned int added = BalancedBinaryTree->addMany(tree, NULL, 0);
+
+    // then nothing should be added
+    cr_assert_eq(
+        0,
+        added,
+        "Nothing should be added"
+    );
+    cr_assert_eq(
+        1,
+        BalancedBinaryTree->size(tree),
+        "Size should not change"
+    );
+}
+
+
+Test(balanced_binary_tree, adding_many_values_keeps_red_black_invariants)
+{
+    // given trees of up to 60 values, and batches of up to 60 other values
+    static int values[120];
+    static void const * batch[60];
+    int i, size, count;
+    for (i = 0; i < 120; i++)
+        values[i] = (i * 53) % 120;
+    for (i = 0; i < 60; i++)
+        batch[i] = & values[60 + i];
+
+    for (size = 0; size <= 60; size += 4)
+        for (count = 1; count <= 60; count += 3)
+        {
+            _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(
+                TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback)
+            );
+            for (i = 0; i < size; i++)
+                BalancedBinaryTree->add(tree, & values[i]);
+
+            // when adding a batch, merged into a rebuilt tree or added one by one
+            BalancedBinaryTree->addMany(tree, batch, count);
+            _BalancedBinaryTreeNode * root = BalancedBinaryTree->root(tree);
+            int isValid = isBlackNode(root) && (blackHeight(root) != -1)
+                && (BalancedBinaryTree->size(tree) == (unsigned int) (size + count));
+            BalancedBinaryTree->destructor(& tree);
+
+            // then every tree should be a valid red-black tree
+            cr_assert_eq(
+                1,
+                isValid,
+                "Tree of %d values given a batch of %d should be a valid red-black tree",
+                size,
+                count
+            );
+        }
+}
+
+
+Test(balanced_binary_tree, finding_many_values_finds_each_of_them)
+{
+    // given a tree of 100 values, and 200 values to find
+    static int values[200];
+    static void const * queries[200];
+    static _BalancedBinaryTreeNode * results[200];
+    int i;
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback));
+    for (i = 0; i < 200; i++)
+    {
+        values[i] = (i * 37) % 200;
+        queries[i] = & values[i];
+        if (values[i] % 2 == 0)
+            BalancedBinaryTree->add(tree, & values[i]);
+    }
+
+    // when finding them all at once
+    unsigned int found = BalancedBinaryTree->findMany(tree, queries, 200, results);
+
+    // then each result should be the node found alone
+    for (i = 0; i < 200; i++)
+        if (results[i] != BalancedBinaryTree->find(tree, queries[i]))
+            break;
+    cr_assert_eq(
+        200,
+        i,
+        "Each result should be the node holding the value, or NULL"
+    );
+    cr_assert_eq(
+        100,
+        found,
+        "Only values in the tree should be found"
+    );
+}
+
+
+Test(balanced_binary_tree, finding_many_values_in_empty_tree_finds_nothing)
+{
+    // given an empty tree
+    static void const * queries[] = { "a", "b" };
+    _BalancedBinaryTreeNode * results[] = { (void *) queries, (void *) queries };
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+
+    // when finding values
+    unsigned int found = BalancedBinaryTree->findMany(tree, queries, 2, results);
+
+    // then nothing should be found
+    cr_assert_eq(
+        0,
+        found,
+        "Nothing should be found in an empty tree"
+    );
+    cr_assert_null(
+        results[1],
+        "Results should be NULL"
+    );
+}
+
+
+Test(balanced_binary_tree, freezing_tree_keeps_every_value)
+{
+    // given a tree of 100 shuffled values
+    static int values[100];
+    int i;
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback));
+    for (i = 0; i < 100; i++)
+    {
+        values[i] = (i * 37) % 100;
+        BalancedBinaryTree->add(tree, & values[i]);
+    }
+
+    // when freezing it, then destroying it
+    _FrozenTree * frozen = BalancedBinaryTree->freeze(tree, VanEmdeBoasLayout);
+    BalancedBinaryTree->destructor(& tree);
+
+    // then the snapshot should hold every value
+    for (i = 0; i < 100; i++)
+        if (FrozenTree->find(frozen, & values[i]) != & values[i])
+            break;
+    cr_assert_eq(
+        100,
+        i,
+        "Snapshot should hold every value of the tree"
+    );
+    cr_assert_eq(
+        100,
+        FrozenTree->size(frozen),
+        "Snapshot should have the size of the tree"
+    );
+}
+
+
+Test(balanced_binary_tree, freezing_empty_tree_gives_empty_snapshot)
+{
+    // given an empty tree
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+
+    // when freezing it
+    _FrozenTree * frozen = BalancedBinaryTree->freeze(tree, BreadthFirstLayout);
+
+    // then the snapshot should be empty
+    cr_assert_eq(
+        0,
+        FrozenTree->size(frozen),
+        "Snapshot of an empty tree should be empty"
+    );
+    cr_assert_eq(
+        0,
+        FrozenTree->contains(frozen, "a"),
+        "Snapshot of an empty tree should hold nothing"
+    );
+}
+
+
+Test(balanced_binary_tree, insert_or_get_keeps_values_unique_and_balanced)
+{
+    // given shuffled values, each one given twice
+    static int values[1000];
+    int i, insertions = 0, inserted;
+    for (i = 0; i < 1000; i++)
+        values[i] = (i * 7919) % 500;
+
+    // when inserting them unless they're already in the tree
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback));
+    for (i = 0; i < 1000; i++)
+        if (BalancedBinaryTree->insertOrGet(tree, & values[i], & inserted) != NULL)
+            insertions += inserted;
+
+    // then each value should be stored once, and red/black invariants should hold
+    cr_assert_eq(
+        500,
+        insertions,
+        "Each value should be inserted once"
+    );
+    cr_assert_eq(
+        500,
+        BalancedBinaryTree->size(tree),
+        "Tree should hold each value once"
+    );
+    cr_assert_eq(
+        & values[250],
+        BalancedBinaryTree->value(BalancedBinaryTree->find(tree, & values[750])),
+        "Equal values should get the node of the first one"
+    );
+    cr_assert_neq(
+        -1,
+        blackHeight(BalancedBinaryTree->root(tree)),
+        "Red/black invariants should hold after insertions"
+    );
+}
+
+
+Test(balanced_binary_tree, popping_every_value_after_a_detach_keeps_red_black_invariants)
+{
+    // given a tree of shuffled values from which an inner branch was detached
+    static int values[300];
+    int i, invariantsHold = 1;
+    _BalancedBinaryTree * tree = BalancedBinaryTree->constructor(TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback));
+    for (i = 0; i < 300; i++)
+    {
+        values[i] = (i * 7919) % 300;
+        BalancedBinaryTree->add(tree, & values[i]);
+    }
+    _BalancedBinaryTree * branch = BalancedBinaryTree->detach(tree, rightSon(leftSon(BalancedBinaryTree->root(tree))));
+    cr_assert_neq(
+        -1,
+        blackHeight(BalancedBinaryTree->root(branch)),
+        "Red/black invariants should hold in the detached branch"
+    );
+    BalancedBinaryTree->destructor(& branch);
+
+    // when popping every value left, smallest first
+    while (BalancedBinaryTree->size(tree) > 0)
+    {
+        if (blackHeight(BalancedBinaryTree->root(tree)) == -1)
+            invariantsHold = 0;
+        BalancedBinaryTree->pop(tree, BalancedBinaryTree->value(BalancedBinaryTree->min(tree)));
+    }
+
+    // then invariants should have held at every step, and the tree should be empty
+    cr_assert_eq(
+        1,
+        invariantsHold,
+        "Red/black invariants should hold after a detach and every pop"
+    );
+    cr_assert_null(
+        BalancedBinaryTree->root(tree),
+        "Popping every value should empty the tree"
+    );
+}
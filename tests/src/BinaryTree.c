@@ -16,7 +16,7 @@
 Test(binary_tree, constructor_allocates_memory)
 {
     // when creating an instance
-    _BinaryTree * instance = BinaryTree->constructor(NULL, NULL);
+    _BinaryTree * instance = BinaryTree->constructor(NULL);
 
     // then it shouldn't be null
     cr_assert_not_null(
@@ -26,17 +26,36 @@ Test(binary_tree, constructor_allocates_memory)
 }
 
 
-Test(binary_tree, constructor_stores_given_value)
+Test(binary_tree, constructor_creates_an_empty_tree)
 {
-    // when storing a value in an element
+    // when creating an instance
+    _BinaryTree * instance = BinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+
+    // then it should have no node
+    cr_assert_eq(
+        0,
+        BinaryTree->size(instance),
+        "Constructor should create an empty tree"
+    );
+    cr_assert_null(
+        BinaryTree->root(instance),
+        "Constructor should create a tree without root"
+    );
+}
+
+
+Test(binary_tree, adding_stores_given_value)
+{
+    // when storing a value in a tree
     char * value = "root";
-    _BinaryTree * instance = BinaryTree->constructor(value, NULL);
+    _BinaryTree * instance = BinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    _BinaryTreeNode * node = BinaryTree->add(instance, value);
 
     // then the stored value should be the given one
     cr_assert_eq(
-        BinaryTree->value(instance),
+        BinaryTree->value(node),
         value,
-        "Constructor should store the given value"
+        "Added node should store the given value"
     );
 }
 
@@ -56,7 +75,7 @@ Test(binary_tree, destructor_doesnt_crash_when_tree_is_null)
 Test(binary_tree, destructor_frees_memory)
 {
     // given an instance
-    _BinaryTree * instance = BinaryTree->constructor(NULL, NULL);
+    _BinaryTree * instance = BinaryTree->constructor(NULL);
 
     // when deleting it
     BinaryTree->destructor(& instance);
@@ -75,7 +94,8 @@ Test(binary_tree, destructor_doesnt_affect_stored_value)
     char * value = "some important data";
 
     // when putting it in a tree and deleting it
-    _BinaryTree * instance = BinaryTree->constructor(value, NULL);
+    _BinaryTree * instance = BinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BinaryTree->add(instance, value);
     BinaryTree->destructor(& instance);
 
     // then value should remain intact
@@ -106,7 +126,8 @@ Test(binary_tree, null_trees_dont_contain_values)
 Test(binary_tree, finds_value_when_its_root)
 {
     // given a tree with a value
-    _BinaryTree * tree = BinaryTree->constructor("root", STRING_NODE_COMPARISON_CALLBACK);
+    _BinaryTree * tree = BinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BinaryTree->add(tree, "root");
 
     // when checking if the value is stored
     int isStored = BinaryTree->contains(tree, "root");
@@ -123,7 +144,8 @@ Test(binary_tree, finds_value_when_its_root)
 Test(binary_tree, finds_value_when_its_lesser_than_root)
 {
     // given a tree with a value added in a later node
-    _BinaryTree * tree = BinaryTree->constructor("42", STRING_NODE_COMPARISON_CALLBACK);
+    _BinaryTree * tree = BinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BinaryTree->add(tree, "42");
     BinaryTree->add(tree, "41");
 
     // when looking for the latest value
@@ -141,7 +163,8 @@ Test(binary_tree, finds_value_when_its_lesser_than_root)
 Test(binary_tree, finds_value_when_its_greater_than_root)
 {
     // given a tree with a value added in a later node
-    _BinaryTree * tree = BinaryTree->constructor("42", STRING_NODE_COMPARISON_CALLBACK);
+    _BinaryTree * tree = BinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BinaryTree->add(tree, "42");
     BinaryTree->add(tree, "43");
 
     // when looking for the latest value
@@ -159,7 +182,8 @@ Test(binary_tree, finds_value_when_its_greater_than_root)
 Test(binary_tree, doesnt_find_non_stored_value)
 {
     // given a tree with differents values
-    _BinaryTree * tree = BinaryTree->constructor("root", STRING_NODE_COMPARISON_CALLBACK);
+    _BinaryTree * tree = BinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BinaryTree->add(tree, "root");
     BinaryTree->add(tree, "added");
 
     // when checking if another value is stored
@@ -194,10 +218,11 @@ Test(binary_tree, null_trees_have_no_height)
 Test(binary_tree, initial_height_is_1)
 {
     // given a tree made of only its root
-    _BinaryTree * root = BinaryTree->constructor("root", STRING_NODE_COMPARISON_CALLBACK);
+    _BinaryTree * tree = BinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BinaryTree->add(tree, "root");
 
     // when checking the height of the tree
-    int height = BinaryTree->height(root);
+    int height = BinaryTree->height(tree);
 
     // then it should be 1
     cr_assert_eq(
@@ -211,11 +236,12 @@ Test(binary_tree, initial_height_is_1)
 Test(binary_tree, computes_height_from_lesser_value_nodes)
 {
     // given a tree with an added lesser value
-    _BinaryTree * root = BinaryTree->constructor("42", STRING_NODE_COMPARISON_CALLBACK);
-    BinaryTree->add(root, "41");
+    _BinaryTree * tree = BinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BinaryTree->add(tree, "42");
+    BinaryTree->add(tree, "41");
 
     // when checking its height
-    int height = BinaryTree->height(root);
+    int height = BinaryTree->height(tree);
 
     // then it should be 2
     cr_assert_eq(
@@ -229,11 +255,12 @@ Test(binary_tree, computes_height_from_lesser_value_nodes)
 Test(binary_tree, computes_height_from_greater_value_nodes)
 {
     // given a tree with an added greater value
-    _BinaryTree * root = BinaryTree->constructor("42", STRING_NODE_COMPARISON_CALLBACK);
-    BinaryTree->add(root, "43");
+    _BinaryTree * tree = BinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BinaryTree->add(tree, "42");
+    BinaryTree->add(tree, "43");
 
     // when checking its height
-    int height = BinaryTree->height(root);
+    int height = BinaryTree->height(tree);
 
     // then it should be 2
     cr_assert_eq(
@@ -247,13 +274,14 @@ Test(binary_tree, computes_height_from_greater_value_nodes)
 Test(binary_tree, computes_biggest_height_when_its_lesser_than_root)
 {
     // given a tree with a root, a chain of "lesser-values" of length 2, a chain of "greater-values" of length 1
-    _BinaryTree * root = BinaryTree->constructor("3", STRING_NODE_COMPARISON_CALLBACK);
-    BinaryTree->add(root, "2");
-    BinaryTree->add(root, "1");
-    BinaryTree->add(root, "4 is greater than the root value");
+    _BinaryTree * tree = BinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BinaryTree->add(tree, "3");
+    BinaryTree->add(tree, "2");
+    BinaryTree->add(tree, "1");
+    BinaryTree->add(tree, "4 is greater than the root value");
 
     // when checking its height
-    int height = BinaryTree->height(root);
+    int height = BinaryTree->height(tree);
 
     // then it should be 3
     cr_assert_eq(
@@ -267,13 +295,14 @@ Test(binary_tree, computes_biggest_height_when_its_lesser_than_root)
 Test(binary_tree, computes_biggest_height_when_its_greater_than_root)
 {
     // given a tree with a root, a chain of "greater-values" of length 2, a chain of "lesser-values" of length 1
-    _BinaryTree * root = BinaryTree->constructor("1", STRING_NODE_COMPARISON_CALLBACK);
-    BinaryTree->add(root, "2");
-    BinaryTree->add(root, "3");
-    BinaryTree->add(root, "0 is lesser than the root value");
+    _BinaryTree * tree = BinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BinaryTree->add(tree, "1");
+    BinaryTree->add(tree, "2");
+    BinaryTree->add(tree, "3");
+    BinaryTree->add(tree, "0 is lesser than the root value");
 
     // when checking its height
-    int height = BinaryTree->height(root);
+    int height = BinaryTree->height(tree);
 
     // then it should be 3
     cr_assert_eq(
@@ -290,7 +319,7 @@ Test(binary_tree, finds_nothing_in_null_tree)
     _BinaryTree * tree = NULL;
 
     // when trying to find any node in it
-    _BinaryTree * node = BinaryTree->find(tree, "any value");
+    _BinaryTreeNode * node = BinaryTree->find(tree, "any value");
 
     // then it should be NULL
     cr_assert_null(
@@ -303,14 +332,15 @@ Test(binary_tree, finds_nothing_in_null_tree)
 Test(binary_tree, finds_root_node)
 {
     // given a tree made of only its root
-    _BinaryTree * tree = BinaryTree->constructor("root node", STRING_NODE_COMPARISON_CALLBACK);
+    _BinaryTree * tree = BinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BinaryTree->add(tree, "root node");
 
     // when trying to find the root node from its value
-    _BinaryTree * node = BinaryTree->find(tree, "root node");
+    _BinaryTreeNode * node = BinaryTree->find(tree, "root node");
 
     // then the found node should be the root one
     cr_assert_eq(
-        tree,
+        BinaryTree->root(tree),
         node,
         "Root node should be found when it's the only one in the tree"
     );
@@ -320,11 +350,12 @@ Test(binary_tree, finds_root_node)
 Test(binary_tree, finds_lesser_value)
 {
     // given a tree with an added lesser value
-    _BinaryTree * root = BinaryTree->constructor("root node", STRING_NODE_COMPARISON_CALLBACK);
-    _BinaryTree * lesser = BinaryTree->add(root, "lesser value");
+    _BinaryTree * tree = BinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BinaryTree->add(tree, "root node");
+    _BinaryTreeNode * lesser = BinaryTree->add(tree, "lesser value");
 
     // when trying to find the added lesser value
-    _BinaryTree * found = BinaryTree->find(root, "lesser value");
+    _BinaryTreeNode * found = BinaryTree->find(tree, "lesser value");
 
     // then it should be the added node
     cr_assert_eq(
@@ -338,11 +369,12 @@ Test(binary_tree, finds_lesser_value)
 Test(binary_tree, finds_greater_value)
 {
     // given a tree with an added greater value
-    _BinaryTree * root = BinaryTree->constructor("root", STRING_NODE_COMPARISON_CALLBACK);
-    _BinaryTree * greater = BinaryTree->add(root, "superior value");
+    _BinaryTree * tree = BinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BinaryTree->add(tree, "root");
+    _BinaryTreeNode * greater = BinaryTree->add(tree, "superior value");
 
     // when trying to find the added greater value
-    _BinaryTree * found = BinaryTree->find(root, "superior value");
+    _BinaryTreeNode * found = BinaryTree->find(tree, "superior value");
 
     // then it should be the added node
     cr_assert_eq(
@@ -359,21 +391,31 @@ Test(binary_tree, detaches_nothing_in_null_tree)
     _BinaryTree * tree = NULL;
 
     // when trying to detach it
-    BinaryTree->detach(tree);
+    BinaryTree->detach(tree, NULL);
 
     // then it shouldn't crash
 }
 
 
-Test(binary_tree, detaching_has_no_effect_on_root)
+Test(binary_tree, detaching_root_empties_the_tree)
 {
     // given a tree made of only its root
-    _BinaryTree * root = BinaryTree->constructor("root", STRING_NODE_COMPARISON_CALLBACK);
+    _BinaryTree * tree = BinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BinaryTree->add(tree, "root");
 
     // when trying to detach it
-    BinaryTree->detach(root);
+    _BinaryTree * branch = BinaryTree->detach(tree, BinaryTree->root(tree));
 
-    // then it shouldn't crash
+    // then the tree should be empty, and the branch should hold the root
+    cr_assert_null(
+        BinaryTree->root(tree),
+        "Detaching the root should leave an empty tree"
+    );
+    cr_assert_eq(
+        1,
+        BinaryTree->size(branch),
+        "Detaching the root should move it to the branch"
+    );
 }
 
 
@@ -383,7 +425,7 @@ Test(binary_tree, null_tree_has_no_root)
     _BinaryTree * tree = NULL;
 
     // when trying to find its root
-    _BinaryTree * root = BinaryTree->root(tree);
+    _BinaryTreeNode * root = BinaryTree->root(tree);
 
     // then there should be none
     cr_assert_null(
@@ -393,18 +435,19 @@ Test(binary_tree, null_tree_has_no_root)
 }
 
 
-Test(binary_tree, finds_root_from_any_node)
+Test(binary_tree, first_added_value_is_the_root)
 {
     // given a tree with more than 1 value
-    _BinaryTree * tree = BinaryTree->constructor("root", STRING_NODE_COMPARISON_CALLBACK);
-    _BinaryTree * leaf = BinaryTree->add(tree, "leaf");
+    _BinaryTree * tree = BinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    _BinaryTreeNode * first = BinaryTree->add(tree, "root");
+    BinaryTree->add(tree, "leaf");
 
-    // when trying to find its root from any leaf
-    _BinaryTree * root = BinaryTree->root(leaf);
+    // when trying to find its root
+    _BinaryTreeNode * root = BinaryTree->root(tree);
 
     // then it should be the right one
     cr_assert_eq(
-        tree,
+        first,
         root,
         "Expected to get the top-most node"
     );
@@ -414,11 +457,12 @@ Test(binary_tree, finds_root_from_any_node)
 Test(binary_tree, detached_node_is_not_in_tree_anymore)
 {
     // given a tree with 2 values
-    _BinaryTree * tree = BinaryTree->constructor("root", STRING_NODE_COMPARISON_CALLBACK);
-    _BinaryTree * son = BinaryTree->add(tree, "son");
+    _BinaryTree * tree = BinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BinaryTree->add(tree, "root");
+    _BinaryTreeNode * son = BinaryTree->add(tree, "son");
 
     // when detaching a non-root node from the tree
-    BinaryTree->detach(son);
+    BinaryTree->detach(tree, son);
 
     // then the detached node is not in the tree anymore
     cr_assert_null(
@@ -428,20 +472,31 @@ Test(binary_tree, detached_node_is_not_in_tree_anymore)
 }
 
 
-Test(binary_tree, detached_node_has_no_parent_anymore)
+Test(binary_tree, detached_node_becomes_root_of_a_new_tree)
 {
     // given a tree with 2 values
-    _BinaryTree * tree = BinaryTree->constructor("root", STRING_NODE_COMPARISON_CALLBACK);
-    _BinaryTree * son = BinaryTree->add(tree, "son");
+    _BinaryTree * tree = BinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BinaryTree->add(tree, "root");
+    _BinaryTreeNode * son = BinaryTree->add(tree, "son");
 
     // when detaching a non-root node from the tree
-    BinaryTree->detach(son);
+    _BinaryTree * branch = BinaryTree->detach(tree, son);
 
     // then the detached node should be the root of a new tree
     cr_assert_eq(
         son,
-        BinaryTree->root(son),
-        "Detached node shouldn't have parent anymore"
+        BinaryTree->root(branch),
+        "Detached node should be the root of the new tree"
+    );
+    cr_assert_eq(
+        1,
+        BinaryTree->size(branch),
+        "Detached branch should only count its own nodes"
+    );
+    cr_assert_eq(
+        1,
+        BinaryTree->size(tree),
+        "Tree shouldn't count detached nodes anymore"
     );
 }
 
@@ -460,9 +515,10 @@ Test(binary_tree, null_tree_cant_be_popped)
 Test(binary_tree, popping_node_with_only_left_son_removes_it_from_the_tree)
 {
     // given a tree containing a node with no right son
-    _BinaryTree * tree = BinaryTree->constructor("root", STRING_NODE_COMPARISON_CALLBACK);
-    _BinaryTree * node = BinaryTree->add(tree, "node with only left son");
-    _BinaryTree * leaf = BinaryTree->add(tree, "leaf");
+    _BinaryTree * tree = BinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BinaryTree->add(tree, "root");
+    _BinaryTreeNode * node = BinaryTree->add(tree, "node with only left son");
+    _BinaryTreeNode * leaf = BinaryTree->add(tree, "leaf");
 
     // when popping that node
     BinaryTree->pop(tree, "node with only left son");
@@ -476,40 +532,44 @@ Test(binary_tree, popping_node_with_only_left_son_removes_it_from_the_tree)
 }
 
 
-Test(binary_tree, popping_node_with_only_left_son_becomes_a_root)
+Test(binary_tree, popping_node_with_only_left_son_returns_its_value)
 {
     // given a tree containing a node with no right son
-    _BinaryTree * tree = BinaryTree->constructor("root", STRING_NODE_COMPARISON_CALLBACK);
-    _BinaryTree * node = BinaryTree->add(tree, "node with only left son");
-    _BinaryTree * leaf = BinaryTree->add(tree, "leaf");
+    _BinaryTree * tree = BinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BinaryTree->add(tree, "root");
+    _BinaryTreeNode * node = BinaryTree->add(tree, "node with only left son");
+    _BinaryTreeNode * leaf = BinaryTree->add(tree, "leaf");
+
+    void const * value = BinaryTree->value(node);
 
     // when popping that node
-    BinaryTree->pop(tree, "node with only left son");
+    void const * popped = BinaryTree->pop(tree, "node with only left son");
 
-    // then it should be its own root afterwards
+    // then the stored value should be returned
     cr_assert_eq(
-        node,
-        BinaryTree->root(node),
-        "Popped node should be its own root"
+        value,
+        popped,
+        "Popping should return the stored value"
     );
 }
 
 
-Test(binary_tree, popping_node_with_only_left_son_makes_a_single_node_tree)
+Test(binary_tree, popping_node_with_only_left_son_decrements_size)
 {
     // given a tree containing a node with no right son
-    _BinaryTree * tree = BinaryTree->constructor("root", STRING_NODE_COMPARISON_CALLBACK);
-    _BinaryTree * node = BinaryTree->add(tree, "node with only left son");
-    _BinaryTree * leaf = BinaryTree->add(tree, "leaf");
+    _BinaryTree * tree = BinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BinaryTree->add(tree, "root");
+    _BinaryTreeNode * node = BinaryTree->add(tree, "node with only left son");
+    _BinaryTreeNode * leaf = BinaryTree->add(tree, "leaf");
 
     // when popping that node
     BinaryTree->pop(tree, "node with only left son");
 
-    // the the node should become a tree of height 1
+    // then the tree should have 1 node less
     cr_assert_eq(
-        1,
-        BinaryTree->height(node),
-        "Popped node should become a tree of height 1"
+        2,
+        BinaryTree->size(tree),
+        "Popping should decrement the size of the tree"
     );
 }
 
@@ -517,9 +577,10 @@ Test(binary_tree, popping_node_with_only_left_son_makes_a_single_node_tree)
 Test(binary_tree, popping_node_with_only_left_son_lets_sons_in_tree)
 {
     // given a tree containing a node with no right son
-    _BinaryTree * tree = BinaryTree->constructor("root", STRING_NODE_COMPARISON_CALLBACK);
-    _BinaryTree * node = BinaryTree->add(tree, "node with only left son");
-    _BinaryTree * leaf = BinaryTree->add(tree, "leaf");
+    _BinaryTree * tree = BinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BinaryTree->add(tree, "root");
+    _BinaryTreeNode * node = BinaryTree->add(tree, "node with only left son");
+    _BinaryTreeNode * leaf = BinaryTree->add(tree, "leaf");
 
     // when popping that node
     BinaryTree->pop(tree, "node with only left son");
@@ -536,9 +597,10 @@ Test(binary_tree, popping_node_with_only_left_son_lets_sons_in_tree)
 Test(binary_tree, popping_node_with_only_right_son_removes_it_from_the_tree)
 {
     // given a tree containing a node with no left son
-    _BinaryTree * tree = BinaryTree->constructor("n1=root", STRING_NODE_COMPARISON_CALLBACK);
-    _BinaryTree * node = BinaryTree->add(tree, "n2=node with only right son");
-    _BinaryTree * leaf = BinaryTree->add(tree, "n3=leaf");
+    _BinaryTree * tree = BinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BinaryTree->add(tree, "n1=root");
+    _BinaryTreeNode * node = BinaryTree->add(tree, "n2=node with only right son");
+    _BinaryTreeNode * leaf = BinaryTree->add(tree, "n3=leaf");
 
     // when popping that node
     BinaryTree->pop(tree, "n2=node with only right son");
@@ -552,40 +614,44 @@ Test(binary_tree, popping_node_with_only_right_son_removes_it_from_the_tree)
 }
 
 
-Test(binary_tree, popping_node_with_only_right_son_becomes_a_root)
+Test(binary_tree, popping_node_with_only_right_son_returns_its_value)
 {
     // given a tree containing a node with no left son
-    _BinaryTree * tree = BinaryTree->constructor("n1=root", STRING_NODE_COMPARISON_CALLBACK);
-    _BinaryTree * node = BinaryTree->add(tree, "n2=node with only right son");
-    _BinaryTree * leaf = BinaryTree->add(tree, "n3=leaf");
+    _BinaryTree * tree = BinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BinaryTree->add(tree, "n1=root");
+    _BinaryTreeNode * node = BinaryTree->add(tree, "n2=node with only right son");
+    _BinaryTreeNode * leaf = BinaryTree->add(tree, "n3=leaf");
+
+    void const * value = BinaryTree->value(node);
 
     // when popping that node
-    BinaryTree->pop(tree, "n2=node with only right son");
+    void const * popped = BinaryTree->pop(tree, "n2=node with only right son");
 
-    // then it should be its own root afterwards
+    // then the stored value should be returned
     cr_assert_eq(
-        node,
-        BinaryTree->root(node),
-        "Popped node should be its own root"
+        value,
+        popped,
+        "Popping should return the stored value"
     );
 }
 
 
-Test(binary_tree, popping_node_with_only_right_son_makes_a_single_node_tree)
+Test(binary_tree, popping_node_with_only_right_son_decrements_size)
 {
     // given a tree containing a node with no left son
-    _BinaryTree * tree = BinaryTree->constructor("n1=root", STRING_NODE_COMPARISON_CALLBACK);
-    _BinaryTree * node = BinaryTree->add(tree, "n2=node with only right son");
-    _BinaryTree * leaf = BinaryTree->add(tree, "n3=leaf");
+    _BinaryTree * tree = BinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BinaryTree->add(tree, "n1=root");
+    _BinaryTreeNode * node = BinaryTree->add(tree, "n2=node with only right son");
+    _BinaryTreeNode * leaf = BinaryTree->add(tree, "n3=leaf");
 
     // when popping that node
     BinaryTree->pop(tree, "n2=node with only right son");
 
-    // the the node should become a tree of height 1
+    // then the tree should have 1 node less
     cr_assert_eq(
-        1,
-        BinaryTree->height(node),
-        "Popped node should become a tree of height 1"
+        2,
+        BinaryTree->size(tree),
+        "Popping should decrement the size of the tree"
     );
 }
 
@@ -593,9 +659,10 @@ Test(binary_tree, popping_node_with_only_right_son_makes_a_single_node_tree)
 Test(binary_tree, popping_node_with_only_right_son_lets_sons_in_tree)
 {
     // given a tree containing a node with no left son
-    _BinaryTree * tree = BinaryTree->constructor("n1=root", STRING_NODE_COMPARISON_CALLBACK);
-    _BinaryTree * node = BinaryTree->add(tree, "n2=node with only right son");
-    _BinaryTree * leaf = BinaryTree->add(tree, "n3=leaf");
+    _BinaryTree * tree = BinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BinaryTree->add(tree, "n1=root");
+    _BinaryTreeNode * node = BinaryTree->add(tree, "n2=node with only right son");
+    _BinaryTreeNode * leaf = BinaryTree->add(tree, "n3=leaf");
 
     // when popping that node
     BinaryTree->pop(tree, "n2=node with only right son");
@@ -612,10 +679,11 @@ Test(binary_tree, popping_node_with_only_right_son_lets_sons_in_tree)
 Test(binary_tree, popping_node_with_2_sons_removes_it_from_the_tree)
 {
     // given a tree containing a node with 2 sons
-    _BinaryTree * tree = BinaryTree->constructor("root", STRING_NODE_COMPARISON_CALLBACK);
-    _BinaryTree * node = BinaryTree->add(tree, "node with 2 sons");
-    _BinaryTree * leftLeaf = BinaryTree->add(tree, "left leaf");
-    _BinaryTree * rightLeaf  = BinaryTree->add(tree, "right leaf");
+    _BinaryTree * tree = BinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BinaryTree->add(tree, "root");
+    _BinaryTreeNode * node = BinaryTree->add(tree, "node with 2 sons");
+    _BinaryTreeNode * leftLeaf = BinaryTree->add(tree, "left leaf");
+    _BinaryTreeNode * rightLeaf  = BinaryTree->add(tree, "right leaf");
 
     // when popping that node
     BinaryTree->pop(tree, "node with 2 sons");
@@ -629,42 +697,46 @@ Test(binary_tree, popping_node_with_2_sons_removes_it_from_the_tree)
 }
 
 
-Test(binary_tree, popping_node_with_2_sons_becomes_a_root)
+Test(binary_tree, popping_node_with_2_sons_returns_its_value)
 {
     // given a tree containing a node with 2 sons
-    _BinaryTree * tree = BinaryTree->constructor("root", STRING_NODE_COMPARISON_CALLBACK);
-    _BinaryTree * node = BinaryTree->add(tree, "node with 2 sons");
-    _BinaryTree * leftLeaf = BinaryTree->add(tree, "left leaf");
-    _BinaryTree * rightLeaf  = BinaryTree->add(tree, "right leaf");
+    _BinaryTree * tree = BinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BinaryTree->add(tree, "root");
+    _BinaryTreeNode * node = BinaryTree->add(tree, "node with 2 sons");
+    _BinaryTreeNode * leftLeaf = BinaryTree->add(tree, "left leaf");
+    _BinaryTreeNode * rightLeaf  = BinaryTree->add(tree, "right leaf");
+
+    void const * value = BinaryTree->value(node);
 
     // when popping that node
-    BinaryTree->pop(tree, "node with 2 sons");
+    void const * popped = BinaryTree->pop(tree, "node with 2 sons");
 
-    // then it should be its own root afterwards
+    // then the stored value should be returned
     cr_assert_eq(
-        node,
-        BinaryTree->root(node),
-        "Popped node should be its own root"
+        value,
+        popped,
+        "Popping should return the stored value"
     );
 }
 
 
-Test(binary_tree, popping_node_with_2_sons_makes_a_single_node_tree)
+Test(binary_tree, popping_node_with_2_sons_decrements_size)
 {
     // given a tree containing a node with 2 sons
-    _BinaryTree * tree = BinaryTree->constructor("root", STRING_NODE_COMPARISON_CALLBACK);
-    _BinaryTree * node = BinaryTree->add(tree, "node with 2 sons");
-    _BinaryTree * leftLeaf = BinaryTree->add(tree, "left leaf");
-    _BinaryTree * rightLeaf  = BinaryTree->add(tree, "right leaf");
+    _BinaryTree * tree = BinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BinaryTree->add(tree, "root");
+    _BinaryTreeNode * node = BinaryTree->add(tree, "node with 2 sons");
+    _BinaryTreeNode * leftLeaf = BinaryTree->add(tree, "left leaf");
+    _BinaryTreeNode * rightLeaf  = BinaryTree->add(tree, "right leaf");
 
     // when popping that node
     BinaryTree->pop(tree, "node with 2 sons");
 
-    // the the node should become a tree of height 1
+    // then the tree should have 1 node less
     cr_assert_eq(
-        1,
-        BinaryTree->height(node),
-        "Popped node should become a tree of height 1"
+        3,
+        BinaryTree->size(tree),
+        "Popping should decrement the size of the tree"
     );
 }
 
@@ -672,10 +744,11 @@ Test(binary_tree, popping_node_with_2_sons_makes_a_single_node_tree)
 Test(binary_tree, popping_node_with_2_sons_lets_sons_in_tree)
 {
     // given a tree containing a node with 2 sons
-    _BinaryTree * tree = BinaryTree->constructor("root", STRING_NODE_COMPARISON_CALLBACK);
-    _BinaryTree * node = BinaryTree->add(tree, "node with 2 sons");
-    _BinaryTree * leftLeaf = BinaryTree->add(tree, "left leaf");
-    _BinaryTree * rightLeaf  = BinaryTree->add(tree, "right leaf");
+    _BinaryTree * tree = BinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BinaryTree->add(tree, "root");
+    _BinaryTreeNode * node = BinaryTree->add(tree, "node with 2 sons");
+    _BinaryTreeNode * leftLeaf = BinaryTree->add(tree, "left leaf");
+    _BinaryTreeNode * rightLeaf  = BinaryTree->add(tree, "right leaf");
 
     // when popping that node
     BinaryTree->pop(tree, "node with 2 sons");
@@ -696,13 +769,14 @@ Test(binary_tree, popping_node_with_2_sons_lets_sons_in_tree)
 
 // Visited nodes order will be written here
 static int visitedNodesBufferIndex;
-static char visitedNodesBuffer[9];
+static char visitedNodesBuffer[16];
 
 
 static void addVisitedNodeCallbackSetup(void)
 {
     extern int visitedNodesBufferIndex;
     visitedNodesBufferIndex = 0;
+    memset(visitedNodesBuffer, 0, sizeof(visitedNodesBuffer));
 }
 
 
@@ -717,7 +791,8 @@ static void addVisitedNodeCallback(void const * const value)
 Test(binary_tree, mapping_with_pre_order_visits_node_with_pre_order, .init=addVisitedNodeCallbackSetup)
 {
     // given a tree with several nodes
-    _BinaryTree * tree = BinaryTree->constructor("F", STRING_NODE_COMPARISON_CALLBACK);
+    _BinaryTree * tree = BinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BinaryTree->add(tree, "F");
     BinaryTree->add(tree, "B");
     BinaryTree->add(tree, "G");
     BinaryTree->add(tree, "A");
@@ -742,7 +817,8 @@ Test(binary_tree, mapping_with_pre_order_visits_node_with_pre_order, .init=addVi
 Test(binary_tree, mapping_with_in_order_visits_node_with_in_order, .init=addVisitedNodeCallbackSetup)
 {
     // given a tree with several nodes
-    _BinaryTree * tree = BinaryTree->constructor("F", STRING_NODE_COMPARISON_CALLBACK);
+    _BinaryTree * tree = BinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BinaryTree->add(tree, "F");
     BinaryTree->add(tree, "B");
     BinaryTree->add(tree, "G");
     BinaryTree->add(tree, "A");
@@ -767,7 +843,8 @@ Test(binary_tree, mapping_with_in_order_visits_node_with_in_order, .init=addVisi
 Test(binary_tree, mapping_with_post_order_visits_node_with_post_order, .init=addVisitedNodeCallbackSetup)
 {
     // given a tree with several nodes
-    _BinaryTree * tree = BinaryTree->constructor("F", STRING_NODE_COMPARISON_CALLBACK);
+    _BinaryTree * tree = BinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BinaryTree->add(tree, "F");
     BinaryTree->add(tree, "B");
     BinaryTree->add(tree, "G");
     BinaryTree->add(tree, "A");
@@ -787,3 +864,1197 @@ Test(binary_tree, mapping_with_post_order_visits_node_with_post_order, .init=add
         "Wrong nodes order, got %s", visitedNodesBuffer
     );
 }
+
+
+Test(binary_tree, size_counts_added_values)
+{
+    // given a tree with 3 values
+    _BinaryTree * tree = BinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BinaryTree->add(tree, "B");
+    BinaryTree->add(tree, "A");
+    BinaryTree->add(tree, "C");
+
+    // when checking its size
+    unsigned int size = BinaryTree->size(tree);
+
+    // then it should be 3
+    cr_assert_eq(
+        3,
+        size,
+        "Size should count every added value"
+    );
+}
+
+
+Test(binary_tree, min_and_max_track_added_values)
+{
+    // given a tree with several values
+    _BinaryTree * tree = BinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BinaryTree->add(tree, "D");
+    _BinaryTreeNode * smallest = BinaryTree->add(tree, "A");
+    BinaryTree->add(tree, "C");
+    _BinaryTreeNode * greatest = BinaryTree->add(tree, "F");
+    BinaryTree->add(tree, "E");
+
+    // then the bounds should be the smallest and greatest values
+    cr_assert_eq(
+        smallest,
+        BinaryTree->min(tree),
+        "Min should be the node having the smallest value"
+    );
+    cr_assert_eq(
+        greatest,
+        BinaryTree->max(tree),
+        "Max should be the node having the greatest value"
+    );
+}
+
+
+Test(binary_tree, popping_bounds_updates_min_and_max)
+{
+    // given a tree with several values
+    _BinaryTree * tree = BinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BinaryTree->add(tree, "D");
+    BinaryTree->add(tree, "A");
+    _BinaryTreeNode * secondSmallest = BinaryTree->add(tree, "C");
+    BinaryTree->add(tree, "F");
+    _BinaryTreeNode * secondGreatest = BinaryTree->add(tree, "E");
+
+    // when popping the smallest and greatest values
+    BinaryTree->pop(tree, "A");
+    BinaryTree->pop(tree, "F");
+
+    // then the bounds should be the next ones
+    cr_assert_eq(
+        secondSmallest,
+        BinaryTree->min(tree),
+        "Min should be updated when popping the smallest value"
+    );
+    cr_assert_eq(
+        secondGreatest,
+        BinaryTree->max(tree),
+        "Max should be updated when popping the greatest value"
+    );
+}
+
+
+Test(binary_tree, popping_root_lets_other_values_in_tree)
+{
+    // given a tree with a root and 2 sons
+    _BinaryTree * tree = BinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BinaryTree->add(tree, "B");
+    BinaryTree->add(tree, "A");
+    BinaryTree->add(tree, "C");
+
+    // when popping the root
+    BinaryTree->pop(tree, "B");
+
+    // then its sons should remain in the tree
+    cr_assert_neq(
+        0,
+        BinaryTree->contains(tree, "A") && BinaryTree->contains(tree, "C"),
+        "Popping the root should let its sons in the tree"
+    );
+    cr_assert_eq(
+        2,
+        BinaryTree->size(tree),
+        "Popping the root should decrement the size of the tree"
+    );
+}
+
+
+Test(binary_tree, popping_last_value_empties_the_tree)
+{
+    // given a tree made of only its root
+    _BinaryTree * tree = BinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BinaryTree->add(tree, "root");
+
+    // when popping its only value
+    BinaryTree->pop(tree, "root");
+
+    // then the tree should be empty
+    cr_assert_null(
+        BinaryTree->root(tree),
+        "Tree should have no root once its last value is popped"
+    );
+    cr_assert_null(
+        BinaryTree->min(tree),
+        "Tree should have no min once its last value is popped"
+    );
+    cr_assert_null(
+        BinaryTree->max(tree),
+        "Tree should have no max once its last value is popped"
+    );
+}
+
+
+Test(binary_tree, arena_tree_finds_added_values)
+{
+    // given an arena-backed tree with several values
+    _BinaryTree * tree = BinaryTree->arenaConstructor(STRING_NODE_COMPARISON_CALLBACK);
+    BinaryTree->add(tree, "B");
+    _BinaryTreeNode * added = BinaryTree->add(tree, "A");
+    BinaryTree->add(tree, "C");
+
+    // when looking for one of them
+    _BinaryTreeNode * found = BinaryTree->find(tree, "A");
+
+    // then it should be the added node
+    cr_assert_eq(
+        added,
+        found,
+        "Arena-backed trees should find added values"
+    );
+}
+
+
+Test(binary_tree, arena_tree_reuses_popped_nodes)
+{
+    // given an arena-backed tree from which a value was popped
+    _BinaryTree * tree = BinaryTree->arenaConstructor(STRING_NODE_COMPARISON_CALLBACK);
+    BinaryTree->add(tree, "A");
+    _BinaryTreeNode * popped = BinaryTree->add(tree, "B");
+    BinaryTree->pop(tree, "B");
+
+    // when adding another value
+    _BinaryTreeNode * added = BinaryTree->add(tree, "C");
+
+    // then the memory of the popped node should be reused
+    cr_assert_eq(
+        popped,
+        added,
+        "Popped nodes should be reused by later additions"
+    );
+}
+
+
+Test(binary_tree, arena_tree_destructor_frees_memory)
+{
+    // given an arena-backed tree with a detached branch
+    _BinaryTree * tree = BinaryTree->arenaConstructor(STRING_NODE_COMPARISON_CALLBACK);
+    BinaryTree->add(tree, "B");
+    _BinaryTreeNode * son = BinaryTree->add(tree, "A");
+    _BinaryTree * branch = BinaryTree->detach(tree, son);
+
+    // when deleting the branch, then the tree
+    BinaryTree->destructor(& branch);
+    BinaryTree->destructor(& tree);
+
+    // then both should be null
+    cr_assert_null(
+        branch,
+        "Destructor should free the branch memory"
+    );
+    cr_assert_null(
+        tree,
+        "Destructor should free the tree memory"
+    );
+}
+
+
+Test(binary_tree, mapping_zigzag_tree_visits_nodes_in_every_order, .init=addVisitedNodeCallbackSetup)
+{
+    // given a tree whose branches alternate between left and right sons
+    _BinaryTree * tree = BinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BinaryTree->add(tree, "A");
+    BinaryTree->add(tree, "E");
+    BinaryTree->add(tree, "B");
+    BinaryTree->add(tree, "D");
+    BinaryTree->add(tree, "C");
+
+    // when applying the callback to each node with every order
+    BinaryTree->map(tree, addVisitedNodeCallback, PreOrder);
+    BinaryTree->map(tree, addVisitedNodeCallback, PostOrder);
+
+    // then nodes should be visited from top to bottom, then from bottom to top
+    cr_assert_str_eq(
+        "AEBDCCDBEA",
+        visitedNodesBuffer,
+        "Wrong nodes order, got %s", visitedNodesBuffer
+    );
+}
+
+
+static int visitedIntegersCount;
+static int visitedIntegersAreSorted;
+
+
+static void countSortedIntegersCallback(void const * const value)
+{
+    if (* ((int const *) value) != visitedIntegersCount)
+        visitedIntegersAreSorted = 0;
+    visitedIntegersCount++;
+}
+
+
+static int integerComparisonCallback(int const * const current, int const * const other)
+{
+    return (* current > * other) - (* current < * other);
+}
+
+
+Test(binary_tree, mapping_degenerate_tree_visits_every_node)
+{
+    // given a tree built from sorted values, which is a chain of right sons
+    static int values[5000];
+    int i;
+    _BinaryTree * tree = BinaryTree->constructor(TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback));
+    for (i = 0; i < 5000; i++)
+    {
+        values[i] = i;
+        BinaryTree->add(tree, & values[i]);
+    }
+
+    // when applying the callback to each node with in-order
+    visitedIntegersCount = 0;
+    visitedIntegersAreSorted = 1;
+    BinaryTree->map(tree, countSortedIntegersCallback, InOrder);
+
+    // then every value should be visited, in order
+    cr_assert_eq(
+        5000,
+        visitedIntegersCount,
+        "Every node should be visited"
+    );
+    cr_assert_eq(
+        1,
+        visitedIntegersAreSorted,
+        "Nodes should be visited in order"
+    );
+}
+
+
+Test(binary_tree, computes_height_of_bushy_tree_deepest_in_its_last_branch)
+{
+    // given a full tree of 1023 values, with a chain of 10 values below its greatest one and 5 below its smallest one
+    static int values[1023];
+    static int chains[15];
+    void const * sortedValues[1023];
+    int i;
+    for (i = 0; i < 1023; i++)
+    {
+        values[i] = i;
+        sortedValues[i] = & values[i];
+    }
+    _BinaryTree * tree = BinaryTree->sortedConstructor(TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback), sortedValues, 1023);
+    for (i = 0; i < 10; i++)
+    {
+        chains[i] = 2000 + i;
+        BinaryTree->add(tree, & chains[i]);
+    }
+    for (i = 10; i < 15; i++)
+    {
+        chains[i] = - i;
+        BinaryTree->add(tree, & chains[i]);
+    }
+
+    // when computing its height, many right sons waiting to be walked on the way
+    unsigned int height = BinaryTree->height(tree);
+
+    // then the deepest node, walked last, should count
+    cr_assert_eq(
+        20,
+        height,
+        "Height should count the deepest node, whichever walk reaches it"
+    );
+}
+
+
+Test(binary_tree, computes_height_of_degenerate_tree)
+{
+    // given a tree built from sorted values, which is a chain of right sons
+    static int values[5000];
+    int i;
+    _BinaryTree * tree = BinaryTree->constructor(TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback));
+    for (i = 0; i < 5000; i++)
+    {
+        values[i] = i;
+        BinaryTree->add(tree, & values[i]);
+    }
+
+    // when checking its height
+    int height = BinaryTree->height(tree);
+
+    // then it should be the number of values
+    cr_assert_eq(
+        5000,
+        height,
+        "Height of a chain should be its length"
+    );
+}
+
+
+Test(binary_tree, computes_height_when_many_branches_are_pending)
+{
+    // given a chain of left sons, each one also having a right son
+    static int values[400];
+    int i;
+    _BinaryTree * tree = BinaryTree->constructor(TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback));
+    for (i = 199; i >= 0; i--)
+    {
+        values[2 * i] = 2 * i;
+        values[2 * i + 1] = 2 * i + 1;
+        BinaryTree->add(tree, & values[2 * i]);
+        BinaryTree->add(tree, & values[2 * i + 1]);
+    }
+
+    // when checking its height
+    int height = BinaryTree->height(tree);
+
+    // then it should be the length of the chain, plus the right son of its deepest node
+    cr_assert_eq(
+        201,
+        height,
+        "Height should account for every branch left aside"
+    );
+}
+
+
+Test(binary_tree, stepping_forward_from_min_visits_values_in_order)
+{
+    // given a tree with shuffled values
+    static int values[] = { 5, 2, 8, 1, 3, 7, 9, 4, 6, 0 };
+    int i;
+    _BinaryTree * tree = BinaryTree->constructor(TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback));
+    for (i = 0; i < 10; i++)
+        BinaryTree->add(tree, & values[i]);
+
+    // when stepping forward from the smallest value
+    _BinaryTreeNode * node = BinaryTree->min(tree);
+    for (i = 0; (node != NULL) && (* (int const *) BinaryTree->value(node) == i); i++)
+        node = BinaryTree->next(node);
+
+    // then every value should be met in order
+    cr_assert_eq(
+        10,
+        i,
+        "Stepping forward should meet values in order"
+    );
+}
+
+
+Test(binary_tree, stepping_backward_from_max_visits_values_in_reverse_order)
+{
+    // given a tree with shuffled values
+    static int values[] = { 5, 2, 8, 1, 3, 7, 9, 4, 6, 0 };
+    int i;
+    _BinaryTree * tree = BinaryTree->constructor(TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback));
+    for (i = 0; i < 10; i++)
+        BinaryTree->add(tree, & values[i]);
+
+    // when stepping backward from the greatest value
+    _BinaryTreeNode * node = BinaryTree->max(tree);
+    for (i = 9; (node != NULL) && (* (int const *) BinaryTree->value(node) == i); i--)
+        node = BinaryTree->previous(node);
+
+    // then every value should be met in reverse order
+    cr_assert_eq(
+        -1,
+        i,
+        "Stepping backward should meet values in reverse order"
+    );
+}
+
+
+Test(binary_tree, stepping_past_bounds_gives_nothing)
+{
+    // given a tree with some values
+    _BinaryTree * tree = BinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BinaryTree->add(tree, "b");
+    BinaryTree->add(tree, "a");
+    BinaryTree->add(tree, "c");
+
+    // when stepping after the greatest value, and before the smallest one
+    _BinaryTreeNode * afterMax = BinaryTree->next(BinaryTree->max(tree));
+    _BinaryTreeNode * beforeMin = BinaryTree->previous(BinaryTree->min(tree));
+
+    // then no node should be found
+    cr_assert_null(
+        afterMax,
+        "Nothing should follow the greatest value"
+    );
+    cr_assert_null(
+        beforeMin,
+        "Nothing should precede the smallest value"
+    );
+    cr_assert_null(
+        BinaryTree->next(NULL),
+        "Nothing should follow a null node"
+    );
+}
+
+
+Test(binary_tree, seeking_stored_value_gives_its_node)
+{
+    // given a tree with some values
+    _BinaryTree * tree = BinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BinaryTree->add(tree, "b");
+    BinaryTree->add(tree, "d");
+    _BinaryTreeNode * node = BinaryTree->add(tree, "f");
+
+    // when seeking a stored value
+    _BinaryTreeNode * found = BinaryTree->seek(tree, "f");
+
+    // then the node holding it should be found
+    cr_assert_eq(
+        node,
+        found,
+        "Seeking a stored value should give its node"
+    );
+}
+
+
+Test(binary_tree, seeking_missing_value_gives_next_greater_one)
+{
+    // given a tree with some values
+    _BinaryTree * tree = BinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BinaryTree->add(tree, "b");
+    _BinaryTreeNode * node = BinaryTree->add(tree, "d");
+    BinaryTree->add(tree, "f");
+
+    // when seeking a value which isn't stored
+    _BinaryTreeNode * found = BinaryTree->seek(tree, "c");
+
+    // then the node holding the next greater value should be found
+    cr_assert_eq(
+        node,
+        found,
+        "Seeking a missing value should give the next greater one"
+    );
+    cr_assert_null(
+        BinaryTree->seek(tree, "g"),
+        "Nothing should be found past the greatest value"
+    );
+}
+
+
+Test(binary_tree, stepping_resumes_after_adding_values)
+{
+    // given a tree walked up to some value
+    _BinaryTree * tree = BinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BinaryTree->add(tree, "a");
+    BinaryTree->add(tree, "c");
+    BinaryTree->add(tree, "e");
+    _BinaryTreeNode * node = BinaryTree->seek(tree, "c");
+
+    // when adding values around it, then stepping again
+    BinaryTree->add(tree, "b");
+    BinaryTree->add(tree, "d");
+    _BinaryTreeNode * following = BinaryTree->next(node);
+
+    // then the walk should meet the newly added value
+    cr_assert_str_eq(
+        BinaryTree->value(following),
+        "d",
+        "Stepping should resume from where it stopped"
+    );
+}
+
+
+Test(binary_tree, upper_bound_gives_first_greater_value)
+{
+    // given a tree with some values
+    _BinaryTree * tree = BinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BinaryTree->add(tree, "b");
+    BinaryTree->add(tree, "d");
+    BinaryTree->add(tree, "f");
+
+    // when looking for the values following a stored one, and a missing one
+    _BinaryTreeNode * afterStored = BinaryTree->upperBound(tree, "d");
+    _BinaryTreeNode * afterMissing = BinaryTree->upperBound(tree, "c");
+
+    // then the next greater values should be found
+    cr_assert_str_eq(
+        BinaryTree->value(afterStored),
+        "f",
+        "Upper bound of a stored value should be the next one"
+    );
+    cr_assert_str_eq(
+        BinaryTree->value(afterMissing),
+        "d",
+        "Upper bound of a missing value should be the next greater one"
+    );
+    cr_assert_null(
+        BinaryTree->upperBound(tree, "f"),
+        "Nothing should be found past the greatest value"
+    );
+}
+
+
+Test(binary_tree, floor_gives_last_value_not_greater)
+{
+    // given a tree with some values
+    _BinaryTree * tree = BinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BinaryTree->add(tree, "b");
+    BinaryTree->add(tree, "d");
+    BinaryTree->add(tree, "f");
+
+    // when looking for the values preceding a stored one, and a missing one
+    _BinaryTreeNode * atStored = BinaryTree->floor(tree, "d");
+    _BinaryTreeNode * beforeMissing = BinaryTree->floor(tree, "e");
+
+    // then the stored value, and the previous lesser value should be found
+    cr_assert_str_eq(
+        BinaryTree->value(atStored),
+        "d",
+        "Floor of a stored value should be itself"
+    );
+    cr_assert_str_eq(
+        BinaryTree->value(beforeMissing),
+        "d",
+        "Floor of a missing value should be the previous lesser one"
+    );
+    cr_assert_null(
+        BinaryTree->floor(tree, "a"),
+        "Nothing should be found before the smallest value"
+    );
+}
+
+
+static int rangeVisitedIntegersCount;
+static int rangeVisitedIntegersSum;
+
+
+static void sumRangeIntegersCallback(void const * const value)
+{
+    rangeVisitedIntegersCount++;
+    rangeVisitedIntegersSum += * (int const *) value;
+}
+
+
+Test(binary_tree, mapping_range_visits_values_between_bounds)
+{
+    // given a tree with 100 values
+    static int values[100];
+    int i;
+    _BinaryTree * tree = BinaryTree->constructor(TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback));
+    for (i = 0; i < 100; i++)
+    {
+        values[i] = (i * 37) % 100;
+        BinaryTree->add(tree, & values[i]);
+    }
+
+    // when applying the callback to values from 20 to 29
+    int lowest = 20, greatest = 29;
+    rangeVisitedIntegersCount = 0;
+    rangeVisitedIntegersSum = 0;
+    BinaryTree->mapRange(tree, & lowest, & greatest, sumRangeIntegersCallback);
+
+    // then only values between the bounds should be visited
+    cr_assert_eq(
+        10,
+        rangeVisitedIntegersCount,
+        "Every value between the bounds should be visited"
+    );
+    cr_assert_eq(
+        245,
+        rangeVisitedIntegersSum,
+        "Only values between the bounds should be visited"
+    );
+}
+
+
+Test(binary_tree, mapping_empty_range_visits_nothing)
+{
+    // given a tree with even values
+    static int values[] = { 0, 2, 4, 6, 8 };
+    int i;
+    _BinaryTree * tree = BinaryTree->constructor(TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback));
+    for (i = 0; i < 5; i++)
+        BinaryTree->add(tree, & values[i]);
+
+    // when applying the callback between two consecutive values
+    int lowest = 3, greatest = 3;
+    rangeVisitedIntegersCount = 0;
+    BinaryTree->mapRange(tree, & lowest, & greatest, sumRangeIntegersCallback);
+
+    // then nothing should be visited
+    cr_assert_eq(
+        0,
+        rangeVisitedIntegersCount,
+        "No value should be visited"
+    );
+}
+
+
+Test(binary_tree, ranking_counts_lesser_values)
+{
+    // given a tree with even values from 0 to 98, shuffled
+    static int values[50];
+    int i;
+    _BinaryTree * tree = BinaryTree->constructor(TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback));
+    for (i = 0; i < 50; i++)
+    {
+        values[i] = ((i * 17) % 50) * 2;
+        BinaryTree->add(tree, & values[i]);
+    }
+
+    // when ranking a stored value, a missing one, and values past the bounds
+    int stored = 40, missing = 41, smallest = -1, greatest = 1000;
+
+    // then the number of lesser values should be given
+    cr_assert_eq(
+        20,
+        BinaryTree->rank(tree, & stored),
+        "Rank of a stored value should count the values before it"
+    );
+    cr_assert_eq(
+        21,
+        BinaryTree->rank(tree, & missing),
+        "Rank of a missing value should count the values before its place"
+    );
+    cr_assert_eq(
+        0,
+        BinaryTree->rank(tree, & smallest),
+        "No value should be lesser than a value below the smallest one"
+    );
+    cr_assert_eq(
+        50,
+        BinaryTree->rank(tree, & greatest),
+        "Every value should be lesser than a value above the greatest one"
+    );
+}
+
+
+Test(binary_tree, selecting_gives_values_by_order)
+{
+    // given a tree with values from 0 to 99, shuffled
+    static int values[100];
+    int i;
+    _BinaryTree * tree = BinaryTree->constructor(TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback));
+    for (i = 0; i < 100; i++)
+    {
+        values[i] = (i * 37) % 100;
+        BinaryTree->add(tree, & values[i]);
+    }
+
+    // when selecting every index
+    for (i = 0; i < 100; i++)
+        if (* (int const *) BinaryTree->value(BinaryTree->select(tree, i)) != i)
+            break;
+
+    // then each value should be found at its place, and nothing past the size
+    cr_assert_eq(
+        100,
+        i,
+        "Selecting an index should give the value having that many lesser values"
+    );
+    cr_assert_null(
+        BinaryTree->select(tree, 100),
+        "Nothing should be selected past the size of the tree"
+    );
+}
+
+
+Test(binary_tree, selecting_after_popping_skips_popped_values)
+{
+    // given a tree with values from 0 to 99, from which even values are popped
+    static int values[100];
+    int i;
+    _BinaryTree * tree = BinaryTree->constructor(TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback));
+    for (i = 0; i < 100; i++)
+    {
+        values[i] = (i * 37) % 100;
+        BinaryTree->add(tree, & values[i]);
+    }
+    for (i = 0; i < 100; i += 2)
+        BinaryTree->pop(tree, & i);
+
+    // when selecting every index, and ranking every odd value
+    for (i = 0; i < 50; i++)
+    {
+        int oddValue = 2 * i + 1;
+        if (* (int const *) BinaryTree->value(BinaryTree->select(tree, i)) != oddValue)
+            break;
+        if (BinaryTree->rank(tree, & oddValue) != (unsigned int) i)
+            break;
+    }
+
+    // then only remaining values should be counted
+    cr_assert_eq(
+        50,
+        i,
+        "Popped values should not be selected nor ranked"
+    );
+}
+
+
+Test(binary_tree, selecting_after_detaching_skips_detached_values)
+{
+    // given a tree with values from 0 to 99, shuffled, from which the branch of the smallest value is detached
+    static int values[100];
+    int i;
+    _BinaryTree * tree = BinaryTree->constructor(TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback));
+    for (i = 0; i < 100; i++)
+    {
+        values[i] = (i * 37) % 100;
+        BinaryTree->add(tree, & values[i]);
+    }
+    _BinaryTree * branch = BinaryTree->detach(tree, BinaryTree->min(tree));
+
+    // when selecting every remaining index, and ranking the selected values
+    unsigned int index;
+    for (index = 0; index < BinaryTree->size(tree); index++)
+    {
+        _BinaryTreeNode * node = BinaryTree->select(tree, index);
+        if ((index > 0) && (BinaryTree->previous(node) != BinaryTree->select(tree, index - 1)))
+            break;
+        if (BinaryTree->rank(tree, BinaryTree->value(node)) != index)
+            break;
+    }
+
+    // then only the values left in the tree should be counted
+    cr_assert_eq(
+        100 - BinaryTree->size(branch),
+        index,
+        "Detached values should not be selected nor ranked"
+    );
+    cr_assert_eq(
+        BinaryTree->min(tree),
+        BinaryTree->select(tree, 0),
+        "The smallest remaining value should be selected first"
+    );
+}
+
+
+Test(binary_tree, sorted_constructor_stores_every_value)
+{
+    // given 100 sorted values
+    static int values[100];
+    static void const * sortedValues[100];
+    int i;
+    for (i = 0; i < 100; i++)
+    {
+        values[i] = i;
+        sortedValues[i] = & values[i];
+    }
+
+    // when building a tree out of them
+    _BinaryTree * tree = BinaryTree->sortedConstructor(TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback), sortedValues, 100);
+
+    // then every value should be found, between the bounds
+    for (i = 0; i < 100; i++)
+        if (BinaryTree->value(BinaryTree->find(tree, & values[i])) != & values[i])
+            break;
+    cr_assert_eq(
+        100,
+        i,
+        "Every value should be found"
+    );
+    cr_assert_eq(
+        100,
+        BinaryTree->size(tree),
+        "Size should be the number of values"
+    );
+    cr_assert_eq(
+        & values[0],
+        BinaryTree->value(BinaryTree->min(tree)),
+        "Min should be the first value"
+    );
+    cr_assert_eq(
+        & values[99],
+        BinaryTree->value(BinaryTree->max(tree)),
+        "Max should be the last value"
+    );
+}
+
+
+Test(binary_tree, sorted_constructor_builds_tree_of_least_height)
+{
+    // given 1000 sorted values
+    static int values[1000];
+    static void const * sortedValues[1000];
+    int i;
+    for (i = 0; i < 1000; i++)
+    {
+        values[i] = i;
+        sortedValues[i] = & values[i];
+    }
+
+    // when building a tree out of them
+    _BinaryTree * tree = BinaryTree->sortedConstructor(TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback), sortedValues, 1000);
+
+    // then its height should be the least one holding them
+    cr_assert_eq(
+        10,
+        BinaryTree->height(tree),
+        "1000 values should fit in 10 levels"
+    );
+}
+
+
+Test(binary_tree, sorted_constructor_without_values_builds_empty_tree)
+{
+    // when building a tree out of no value
+    _BinaryTree * tree = BinaryTree->sortedConstructor(STRING_NODE_COMPARISON_CALLBACK, NULL, 0);
+
+    // then it should be empty
+    cr_assert_not_null(
+        tree,
+        "Tree should be allocated"
+    );
+    cr_assert_null(
+        BinaryTree->root(tree),
+        "Tree should have no root"
+    );
+}
+
+
+Test(binary_tree, sorted_tree_accepts_additions_and_pops)
+{
+    // given a tree built out of sorted values
+    static void const * sortedValues[] = { "b", "d", "f", "h" };
+    _BinaryTree * tree = BinaryTree->sortedConstructor(STRING_NODE_COMPARISON_CALLBACK, sortedValues, 4);
+
+    // when adding and popping values
+    BinaryTree->add(tree, "a");
+    BinaryTree->add(tree, "e");
+    BinaryTree->pop(tree, "d");
+    BinaryTree->pop(tree, "h");
+
+    // then the tree should hold the remaining values
+    cr_assert_eq(
+        4,
+        BinaryTree->size(tree),
+        "Size should follow additions and pops"
+    );
+    cr_assert_str_eq(
+        BinaryTree->value(BinaryTree->next(BinaryTree->seek(tree, "b"))),
+        "e",
+        "Values should stay in order"
+    );
+    cr_assert_str_eq(
+        BinaryTree->value(BinaryTree->max(tree)),
+        "f",
+        "Max should follow pops"
+    );
+}
+
+
+/**
+ * @return - 1 if stepping from the smallest value meets every one of them in order, 0 otherwise
+ */
+static int binary_tree_integersAreInOrder(_BinaryTree * const tree, unsigned int count)
+{
+    _BinaryTreeNode * node = BinaryTree->min(tree);
+    unsigned int met = 0;
+
+    for (; node != NULL; node = BinaryTree->next(node))
+    {
+        if ((BinaryTree->next(node) != NULL) && (* (int const *) BinaryTree->value(node) > * (int const *) BinaryTree->value(BinaryTree->next(node))))
+            return 0;
+        met++;
+    }
+
+    return met == count;
+}
+
+
+Test(binary_tree, adding_many_values_to_empty_tree_stores_them)
+{
+    // given 100 shuffled values
+    static int values[100];
+    static void const * batch[100];
+    int i;
+    for (i = 0; i < 100; i++)
+    {
+        values[i] = (i * 37) % 100;
+        batch[i] = & values[i];
+    }
+    _BinaryTree * tree = BinaryTree->constructor(TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback));
+
+    // when adding them all at once to an empty tree
+    unsigned int added = BinaryTree->addMany(tree, batch, 100);
+
+    // then they should all be stored in order, in a tree of the least height
+    cr_assert_eq(
+        100,
+        added,
+        "Every value should be added"
+    );
+    cr_assert_eq(
+        1,
+        binary_tree_integersAreInOrder(tree, 100),
+        "Values should be stored in order"
+    );
+    cr_assert_eq(
+        7,
+        BinaryTree->height(tree),
+        "Tree should be rebuilt with the least height"
+    );
+    cr_assert_eq(
+        0,
+        * (int const *) BinaryTree->value(BinaryTree->min(tree)),
+        "Min should be the smallest value of the batch"
+    );
+}
+
+
+Test(binary_tree, adding_small_batch_to_large_tree_stores_it)
+{
+    // given a tree with 500 even values, and a batch of 50 odd ones
+    static int values[550];
+    static void const * batch[50];
+    int i;
+    _BinaryTree * tree = BinaryTree->constructor(TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback));
+    for (i = 0; i < 500; i++)
+    {
+        values[i] = 2 * ((i * 379) % 500);
+        BinaryTree->add(tree, & values[i]);
+    }
+    for (i = 0; i < 50; i++)
+    {
+        values[500 + i] = 2 * ((i * 17) % 500) + 1;
+        batch[i] = & values[500 + i];
+    }
+
+    // when adding the batch
+    unsigned int added = BinaryTree->addMany(tree, batch, 50);
+
+    // then every value should be stored in order
+    for (i = 0; i < 550; i++)
+        if (BinaryTree->find(tree, & values[i]) == NULL)
+            break;
+    cr_assert_eq(
+        50,
+        added,
+        "Every value of the batch should be added"
+    );
+    cr_assert_eq(
+        550,
+        i,
+        "Every value should be found"
+    );
+    cr_assert_eq(
+        1,
+        binary_tree_integersAreInOrder(tree, 550),
+        "Values should be stored in order"
+    );
+}
+
+
+Test(binary_tree, adding_many_equal_values_keeps_them_all)
+{
+    // given a tree holding a value, and a batch holding it again
+    static void const * batch[] = { "b", "a", "b" };
+    _BinaryTree * tree = BinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BinaryTree->add(tree, "b");
+
+    // when adding the batch
+    BinaryTree->addMany(tree, batch, 3);
+
+    // then every value should be kept
+    cr_assert_eq(
+        4,
+        BinaryTree->size(tree),
+        "Equal values should all be added"
+    );
+    cr_assert_str_eq(
+        BinaryTree->value(BinaryTree->next(BinaryTree->next(BinaryTree->next(BinaryTree->min(tree))))),
+        "b",
+        "Equal values should follow each other"
+    );
+}
+
+
+Test(binary_tree, adding_no_values_adds_nothing)
+{
+    // given a tree
+    _BinaryTree * tree = BinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BinaryTree->add(tree, "b");
+
+    // when adding an empty batch
+    unsigned int added = BinaryTree->addMany(tree, NULL, 0);
+
+    // then nothing should be added
+    cr_assert_eq(
+        0,
+        added,
+        "Nothing should be added"
+    );
+    cr_assert_eq(
+        1,
+        BinaryTree->size(tree),
+        "Size should not change"
+    );
+}
+
+
+Test(binary_tree, finding_many_values_finds_each_of_them)
+{
+    // given a tree of 100 values, and 200 values to find
+    static int values[200];
+    static void const * queries[200];
+    static _BinaryTreeNode * results[200];
+    int i;
+    _BinaryTree * tree = BinaryTree->constructor(TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback));
+    for (i = 0; i < 200; i++)
+    {
+        values[i] = (i * 37) % 200;
+        queries[i] = & values[i];
+        if (values[i] % 2 == 0)
+            BinaryTree->add(tree, & values[i]);
+    }
+
+    // when finding them all at once
+    unsigned int found = BinaryTree->findMany(tree, queries, 200, results);
+
+    // then each result should be the node found alone
+    for (i = 0; i < 200; i++)
+        if (results[i] != BinaryTree->find(tree, queries[i]))
+            break;
+    cr_assert_eq(
+        200,
+        i,
+        "Each result should be the node holding the value, or NULL"
+    );
+    cr_assert_eq(
+        100,
+        found,
+        "Only values in the tree should be found"
+    );
+}
+
+
+Test(binary_tree, finding_many_values_in_empty_tree_finds_nothing)
+{
+    // given an empty tree
+    static void const * queries[] = { "a", "b" };
+    _BinaryTreeNode * results[] = { (void *) queries, (void *) queries };
+    _BinaryTree * tree = BinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+
+    // when finding values
+    unsigned int found = BinaryTree->findMany(tree, queries, 2, results);
+
+    // then nothing should be found
+    cr_assert_eq(
+        0,
+        found,
+        "Nothing should be found in an empty tree"
+    );
+    cr_assert_null(
+        results[1],
+        "Results should be NULL"
+    );
+}
+
+
+Test(binary_tree, freezing_tree_keeps_every_value)
+{
+    // given a tree of 100 shuffled values
+    static int values[100];
+    int i;
+    _BinaryTree * tree = BinaryTree->constructor(TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback));
+    for (i = 0; i < 100; i++)
+    {
+        values[i] = (i * 37) % 100;
+        BinaryTree->add(tree, & values[i]);
+    }
+
+    // when freezing it, then destroying it
+    _FrozenTree * frozen = BinaryTree->freeze(tree, VanEmdeBoasLayout);
+    BinaryTree->destructor(& tree);
+
+    // then the snapshot should hold every value
+    for (i = 0; i < 100; i++)
+        if (FrozenTree->find(frozen, & values[i]) != & values[i])
+            break;
+    cr_assert_eq(
+        100,
+        i,
+        "Snapshot should hold every value of the tree"
+    );
+    cr_assert_eq(
+        100,
+        FrozenTree->size(frozen),
+        "Snapshot should have the size of the tree"
+    );
+}
+
+
+Test(binary_tree, freezing_empty_tree_gives_empty_snapshot)
+{
+    // given an empty tree
+    _BinaryTree * tree = BinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+
+    // when freezing it
+    _FrozenTree * frozen = BinaryTree->freeze(tree, BreadthFirstLayout);
+
+    // then the snapshot should be empty
+    cr_assert_eq(
+        0,
+        FrozenTree->size(frozen),
+        "Snapshot of an empty tree should be empty"
+    );
+    cr_assert_eq(
+        0,
+        FrozenTree->contains(frozen, "a"),
+        "Snapshot of an empty tree should hold nothing"
+    );
+}
+
+
+Test(binary_tree, insert_or_get_returns_node_of_equal_value)
+{
+    // given a tree holding a value
+    char first[] = "42";
+    char second[] = "42";
+    int inserted = -1;
+    _BinaryTree * tree = BinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    _BinaryTreeNode * node = BinaryTree->add(tree, first);
+
+    // when inserting an equal value
+    _BinaryTreeNode * got = BinaryTree->insertOrGet(tree, second, & inserted);
+
+    // then the node of the value already stored should be returned, and nothing added
+    cr_assert_eq(
+        node,
+        got,
+        "Node of the equal value should be returned"
+    );
+    cr_assert_eq(
+        0,
+        inserted,
+        "Nothing should be inserted"
+    );
+    cr_assert_eq(
+        1,
+        BinaryTree->size(tree),
+        "Size shouldn't change"
+    );
+}
+
+
+Test(binary_tree, insert_or_get_adds_missing_values)
+{
+    // given a tree holding values
+    int inserted = -1;
+    _BinaryTree * tree = BinaryTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    BinaryTree->add(tree, "42");
+    BinaryTree->add(tree, "43");
+
+    // when inserting a missing value
+    _BinaryTreeNode * got = BinaryTree->insertOrGet(tree, "41", & inserted);
+
+    // then it should be added, and become the smallest one
+    cr_assert_str_eq(
+        "41",
+        BinaryTree->value(got),
+        "Node of the added value should be returned"
+    );
+    cr_assert_eq(
+        1,
+        inserted,
+        "Value should be inserted"
+    );
+    cr_assert_eq(
+        got,
+        BinaryTree->min(tree),
+        "Added value should be the smallest one"
+    );
+    cr_assert_eq(
+        3,
+        BinaryTree->size(tree),
+        "Size should grow"
+    );
+}
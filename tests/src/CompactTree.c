@@ -0,0 +1,322 @@
+
+#include <stdio.h>
+#include <string.h>
+#include <criterion/criterion.h>
+#include <criterion/redirect.h>
+
+#include "../../src/CompactTree.h"
+
+#define TREE_NODE_COMPARISON_CALLBACK_TYPE int (*)(void const * const, void const * const)
+#define TO_NODE_COMPARISON_CALLBACK(function) ((TREE_NODE_COMPARISON_CALLBACK_TYPE) function)
+#define STRING_NODE_COMPARISON_CALLBACK TO_NODE_COMPARISON_CALLBACK(strcmp)
+
+
+
+
+static int integerComparisonCallback(int const * const current, int const * const other)
+{
+    return (* current > * other) - (* current < * other);
+}
+
+
+static int previousMappedInteger;
+static int mappedIntegersAreInOrder;
+static unsigned int mappedIntegers;
+
+
+static void checkIntegerOrderCallback(void const * const value)
+{
+    if ((mappedIntegers > 0) && (* (int const *) value < previousMappedInteger))
+        mappedIntegersAreInOrder = 0;
+
+    previousMappedInteger = * (int const *) value;
+    mappedIntegers++;
+}
+
+
+/**
+ * @return - 1 if mapping the tree meets count values in order, 0 otherwise
+ */
+static int integersAreInOrder(_CompactTree const * const tree, unsigned int count)
+{
+    mappedIntegersAreInOrder = 1;
+    mappedIntegers = 0;
+
+    CompactTree->map(tree, checkIntegerOrderCallback);
+
+    return mappedIntegersAreInOrder && (mappedIntegers == count);
+}
+
+
+
+
+Test(compact_tree, constructor_creates_an_empty_tree)
+{
+    // when creating an instance
+    _CompactTree * instance = CompactTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+
+    // then it should have no value
+    cr_assert_not_null(
+        instance,
+        "Constructor should allocate memory"
+    );
+    cr_assert_eq(
+        0,
+        CompactTree->size(instance),
+        "Tree should be empty"
+    );
+    cr_assert_eq(
+        0,
+        CompactTree->min(instance),
+        "Empty tree should have no min"
+    );
+}
+
+
+Test(compact_tree, destructor_sets_to_null)
+{
+    // given a tree holding values
+    _CompactTree * tree = CompactTree->constructor(STRING_NODE_COMPARISON_CALLBACK);
+    CompactTree->add(tree, "a");
+    CompactTree->add(tree, "b");
+
+    // when destroying it
+    CompactTree->destructor(& tree);
+
+    // then it should be set to null
+    cr_assert_null(
+        tree,
+        "Destructor should set the tree to NULL"
+    );
+}
+
+
+Test(compact_tree, finds_values_after_the_array_grew)
+{
+    // given a tree of 10000 shuffled values, its array growing many times
+    static int values[10000];
+    int i;
+    _CompactTree * tree = CompactTree->constructor(TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback));
+    for (i = 0; i < 10000; i++)
+    {
+        values[i] = 2 * ((i * 3793) % 10000);
+        CompactTree->add(tree, & values[i]);
+    }
+
+    // when finding each of them
+    for (i = 0; i < 10000; i++)
+        if (CompactTree->value(tree, CompactTree->find(tree, & values[i])) != & values[i])
+            break;
+
+    // then they should all be found, in order
+    cr_assert_eq(
+        10000,
+        i,
+        "Every added value should be found"
+    );
+    cr_assert_eq(
+        1,
+        integersAreInOrder(tree, 10000),
+        "Values should be mapped in order"
+    );
+}
+
+
+Test(compact_tree, nodes_keep_their_index)
+{
+    // given a node added to a tree
+    static int values[1000];
+    int i;
+    unsigned int node;
+    _CompactTree * tree = CompactTree->constructor(TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback));
+    values[0] = 0;
+    node = CompactTree->add(tree, & values[0]);
+
+    // when adding many more values, moving the array of nodes
+    for (i = 1; i < 1000; i++)
+    {
+        values[i] = i;
+        CompactTree->add(tree, & values[i]);
+    }
+
+    // then the node should still designate its value
+    cr_assert_eq(
+        & values[0],
+        CompactTree->value(tree, node),
+        "Index should still designate the value"
+    );
+}
+
+
+Test(compact_tree, adding_sorted_values_keeps_the_tree_balanced)
+{
+    // given a tree
+    static int values[4096];
+    int i;
+    _CompactTree * tree = CompactTree->constructor(TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback));
+
+    // when adding sorted values, the worst case for an unbalanced tree
+    for (i = 0; i < 4096; i++)
+    {
+        values[i] = i;
+        CompactTree->add(tree, & values[i]);
+    }
+
+    // then its height should stay within twice the logarithm of the size
+    cr_assert_leq(
+        CompactTree->height(tree),
+        24,
+        "Tree should stay balanced"
+    );
+}
+
+
+Test(compact_tree, copy_is_independent)
+{
+    // given a tree and its copy
+    static int values[100];
+    int i, missing = 1000;
+    _CompactTree * tree = CompactTree->constructor(TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback));
+    _CompactTree * copied;
+    for (i = 0; i < 100; i++)
+    {
+        values[i] = i;
+        CompactTree->add(tree, & values[i]);
+    }
+    copied = CompactTree->copy(tree);
+
+    // when changing the tree
+    CompactTree->pop(tree, & values[50]);
+    CompactTree->add(tree, & missing);
+
+    // then the copy should keep the values of the tree when it was copied
+    cr_assert_eq(
+        1,
+        CompactTree->contains(copied, & values[50]),
+        "Copy should keep values popped from the tree"
+    );
+    cr_assert_eq(
+        0,
+        CompactTree->contains(copied, & missing),
+        "Copy shouldn't hold values added to the tree"
+    );
+    cr_assert_eq(
+        1,
+        integersAreInOrder(copied, 100),
+        "Copy should be mapped in order"
+    );
+}
+
+
+Test(compact_tree, pop_removes_values)
+{
+    // given a tree of 1000 shuffled values
+    static int values[1000];
+    int i, popped;
+    _CompactTree * tree = CompactTree->constructor(TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback));
+    for (i = 0; i < 1000; i++)
+    {
+        values[i] = (i * 379) % 1000;
+        CompactTree->add(tree, & values[i]);
+    }
+
+    // when popping every other value, in another order
+    for (i = 0, popped = 0; i < 1000; i++)
+        if ((values[(i * 37) % 1000] % 2 == 0) && (CompactTree->pop(tree, & values[(i * 37) % 1000]) == & values[(i * 37) % 1000]))
+            popped++;
+
+    // then only the other values should be left, in order
+    for (i = 0; i < 1000; i++)
+        if (CompactTree->contains(tree, & values[i]) != (values[i] % 2))
+            break;
+    cr_assert_eq(
+        500,
+        popped,
+        "Every popped value should be returned"
+    );
+    cr_assert_eq(
+        1000,
+        i,
+        "Only values which weren't popped should be left"
+    );
+    cr_assert_eq(
+        1,
+        integersAreInOrder(tree, 500),
+        "Values left should be mapped in order"
+    );
+}
+
+
+Test(compact_tree, popped_nodes_are_reused)
+{
+    // given a tree from which a value was popped
+    static int values[3] = {1, 2, 3};
+    unsigned int popped;
+    _CompactTree * tree = CompactTree->constructor(TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback));
+    CompactTree->add(tree, & values[0]);
+    popped = CompactTree->add(tree, & values[1]);
+    CompactTree->pop(tree, & values[1]);
+
+    // when adding another value
+    unsigned int added = CompactTree->add(tree, & values[2]);
+
+    // then it should take the node of the popped one
+    cr_assert_eq(
+        popped,
+        added,
+        "Popped node should be reused"
+    );
+}
+
+
+Test(compact_tree, next_and_previous_walk_the_values)
+{
+    // given a tree of shuffled values
+    static int values[100];
+    unsigned int node;
+    int i, walked = 0;
+    _CompactTree * tree = CompactTree->constructor(TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback));
+    for (i = 0; i < 100; i++)
+    {
+        values[i] = (i * 37) % 100;
+        CompactTree->add(tree, & values[i]);
+    }
+
+    // when walking from the greatest to the smallest one
+    for (node = CompactTree->max(tree); node != 0; node = CompactTree->previous(tree, node))
+        if (* (int const *) CompactTree->value(tree, node) == 99 - walked)
+            walked++;
+
+    // then every value should be met in order
+    cr_assert_eq(
+        100,
+        walked,
+        "Every value should be met, in reverse order"
+    );
+}
+
+
+Test(compact_tree, next_steps_through_equal_values)
+{
+    // given a tree of 100 values, each one added 10 times, rotations spreading equal values on both sides
+    static int values[1000];
+    unsigned int node, walked = 0;
+    int i;
+    _CompactTree * tree = CompactTree->constructor(TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback));
+    for (i = 0; i < 1000; i++)
+    {
+        values[i] = (i * 37) % 100;
+        CompactTree->add(tree, & values[i]);
+    }
+
+    // when walking from the smallest to the greatest one
+    for (node = CompactTree->min(tree); node != 0; node = CompactTree->next(tree, node))
+        walked++;
+
+    // then every node should be met once
+    cr_assert_eq(
+        1000,
+        walked,
+        "Every node should be met, equal values included"
+    );
+}
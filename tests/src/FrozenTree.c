@@ -0,0 +1,261 @@
+
+#include <stdio.h>
+#include <string.h>
+#include <criterion/criterion.h>
+#include <criterion/redirect.h>
+
+#include "../../src/FrozenTree.h"
+
+#define TREE_NODE_COMPARISON_CALLBACK_TYPE int (*)(void const * const, void const * const)
+#define TO_NODE_COMPARISON_CALLBACK(function) ((TREE_NODE_COMPARISON_CALLBACK_TYPE) function)
+#define STRING_NODE_COMPARISON_CALLBACK TO_NODE_COMPARISON_CALLBACK(strcmp)
+
+
+
+
+static int integerComparisonCallback(int const * const current, int const * const other)
+{
+    return (* current > * other) - (* current < * other);
+}
+
+
+
+
+Test(frozen_tree, constructor_allocates_memory)
+{
+    // when creating an instance out of no value
+    _FrozenTree * instance = FrozenTree->constructor(STRING_NODE_COMPARISON_CALLBACK, NULL, 0, BreadthFirstLayout);
+
+    // then it shouldn't be null
+    cr_assert_not_null(
+        instance,
+        "Constructor should allocate memory"
+    );
+}
+
+
+Test(frozen_tree, destructor_sets_to_null)
+{
+    // given an instance
+    _FrozenTree * instance = FrozenTree->constructor(STRING_NODE_COMPARISON_CALLBACK, NULL, 0, BreadthFirstLayout);
+
+    // when destroying it
+    FrozenTree->destructor(& instance);
+
+    // then it should be set to null
+    cr_assert_null(
+        instance,
+        "Destructor should set the instance to NULL"
+    );
+}
+
+
+Test(frozen_tree, finds_every_value)
+{
+    // given snapshots of up to 100 sorted values
+    static int integers[100];
+    static void const * values[100];
+    int i, count;
+    for (i = 0; i < 100; i++)
+    {
+        integers[i] = 2 * i;
+        values[i] = & integers[i];
+    }
+
+    for (count = 0; count <= 100; count++)
+    {
+        _FrozenTree * tree = FrozenTree->constructor(
+            TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback),
+            values,
+            count,
+            BreadthFirstLayout
+        );
+
+        // when finding each of them
+        for (i = 0; i < count; i++)
+            if (FrozenTree->find(tree, & integers[i]) != & integers[i])
+                break;
+        FrozenTree->destructor(& tree);
+
+        // then they should all be found
+        cr_assert_eq(
+            count,
+            i,
+            "Every value of a snapshot of %d values should be found",
+            count
+        );
+    }
+}
+
+
+Test(frozen_tree, finds_every_value_in_van_emde_boas_layout)
+{
+    // given snapshots of up to 300 sorted values, laid out in van Emde Boas order
+    static int integers[300];
+    static void const * values[300];
+    int i, count;
+    for (i = 0; i < 300; i++)
+    {
+        integers[i] = 2 * i;
+        values[i] = & integers[i];
+    }
+
+    for (count = 0; count <= 300; count++)
+    {
+        _FrozenTree * tree = FrozenTree->constructor(
+            TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback),
+            values,
+            count,
+            VanEmdeBoasLayout
+        );
+
+        // when finding each of them
+        for (i = 0; i < count; i++)
+            if (FrozenTree->find(tree, & integers[i]) != & integers[i])
+                break;
+        FrozenTree->destructor(& tree);
+
+        // then they should all be found
+        cr_assert_eq(
+            count,
+            i,
+            "Every value of a snapshot of %d values should be found",
+            count
+        );
+    }
+}
+
+
+Test(frozen_tree, seeks_the_same_values_in_both_layouts)
+{
+    // given snapshots of the same even values, in both layouts
+    static int integers[200];
+    static void const * values[200];
+    int i, wanted;
+    for (i = 0; i < 200; i++)
+    {
+        integers[i] = 2 * i;
+        values[i] = & integers[i];
+    }
+    _FrozenTree * breadthFirst = FrozenTree->constructor(
+        TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback),
+        values,
+        200,
+        BreadthFirstLayout
+    );
+    _FrozenTree * vanEmdeBoas = FrozenTree->constructor(
+        TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback),
+        values,
+        200,
+        VanEmdeBoasLayout
+    );
+
+    // when seeking every value, present or not
+    for (wanted = -1; wanted <= 400; wanted++)
+        if (FrozenTree->seek(breadthFirst, & wanted) != FrozenTree->seek(vanEmdeBoas, & wanted))
+            break;
+
+    // then both layouts should give the same values
+    cr_assert_eq(
+        401,
+        wanted,
+        "Both layouts should seek the same values"
+    );
+    cr_assert_eq(
+        & integers[0],
+        FrozenTree->seek(vanEmdeBoas, & integers[0]),
+        "Seeking the smallest value should find it"
+    );
+}
+
+
+Test(frozen_tree, doesnt_find_missing_value)
+{
+    // given a snapshot of even values
+    static int integers[50];
+    static void const * values[50];
+    int i, odd = 51;
+    for (i = 0; i < 50; i++)
+    {
+        integers[i] = 2 * i;
+        values[i] = & integers[i];
+    }
+    _FrozenTree * tree = FrozenTree->constructor(TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback), values, 50, BreadthFirstLayout);
+
+    // when finding an odd value
+    int found = FrozenTree->contains(tree, & odd);
+
+    // then it shouldn't be found
+    cr_assert_eq(
+        0,
+        found,
+        "Missing value shouldn't be found"
+    );
+}
+
+
+Test(frozen_tree, finds_first_of_equal_values)
+{
+    // given a snapshot of equal values
+    static char const * const values[] = { "a", "b", "b", "b", "c" };
+    char equal[] = "b";
+    _FrozenTree * tree = FrozenTree->constructor(STRING_NODE_COMPARISON_CALLBACK, (void const * const *) values, 5, BreadthFirstLayout);
+
+    // when finding that value
+    void const * found = FrozenTree->find(tree, equal);
+
+    // then the first one should be found
+    cr_assert_eq(
+        values[1],
+        found,
+        "First of the equal values should be found"
+    );
+}
+
+
+Test(frozen_tree, seeks_first_value_not_lesser)
+{
+    // given a snapshot of even values
+    static int integers[50];
+    static void const * values[50];
+    int i, odd = 51, greatest = 100;
+    for (i = 0; i < 50; i++)
+    {
+        integers[i] = 2 * i;
+        values[i] = & integers[i];
+    }
+    _FrozenTree * tree = FrozenTree->constructor(TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback), values, 50, BreadthFirstLayout);
+
+    // when seeking an odd value, and a value past the greatest one
+    void const * next = FrozenTree->seek(tree, & odd);
+    void const * past = FrozenTree->seek(tree, & greatest);
+
+    // then the next even value should be found, and none past the greatest one
+    cr_assert_eq(
+        & integers[26],
+        next,
+        "Seek should find the first value which isn't lesser"
+    );
+    cr_assert_null(
+        past,
+        "Seek shouldn't find any value past the greatest one"
+    );
+}
+
+
+Test(frozen_tree, size_is_the_number_of_values)
+{
+    // given a snapshot of 3 values
+    static void const * values[] = { "a", "b", "c" };
+    _FrozenTree * tree = FrozenTree->constructor(STRING_NODE_COMPARISON_CALLBACK, values, 3, VanEmdeBoasLayout);
+
+    // when getting its size
+    unsigned int size = FrozenTree->size(tree);
+
+    // then it should be the number of values
+    cr_assert_eq(
+        3,
+        size,
+        "Size should be the number of values"
+    );
+}
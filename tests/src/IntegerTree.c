@@ -0,0 +1,320 @@
+
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <criterion/criterion.h>
+#include <criterion/redirect.h>
+
+#include "../../src/IntegerTree.h"
+
+
+
+
+static int previousMappedKey;
+static int mappedKeysAreInOrder;
+static unsigned int mappedKeys;
+
+
+static void checkKeyOrderCallback(int key, void const * const value)
+{
+    if ((mappedKeys > 0) && (key < previousMappedKey))
+        mappedKeysAreInOrder = 0;
+    if (* (int const *) value != key)
+        mappedKeysAreInOrder = 0;
+
+    previousMappedKey = key;
+    mappedKeys++;
+}
+
+
+/**
+ * @return - 1 if mapping the tree meets count keys in order, along with their values, 0 otherwise
+ */
+static int keysAreInOrder(_IntegerTree const * const tree, unsigned int count)
+{
+    mappedKeysAreInOrder = 1;
+    mappedKeys = 0;
+
+    IntegerTree->map(tree, checkKeyOrderCallback);
+
+    return mappedKeysAreInOrder && (mappedKeys == count);
+}
+
+
+/**
+ * @return - the number of shuffled keys, added with themselves as values, found again in the tree
+ */
+static int findShuffledKeys(int useVectorInstructions)
+{
+    static int values[1000];
+    int i;
+    _IntegerTree * tree;
+
+    IntegerTree->useVectorInstructions(useVectorInstructions);
+    tree = IntegerTree->constructor();
+    for (i = 0; i < 1000; i++)
+    {
+        values[i] = 2 * ((i * 379) % 1000) - 1000;
+        IntegerTree->add(tree, values[i], & values[i]);
+    }
+
+    for (i = 0; i < 1000; i++)
+        if ((IntegerTree->find(tree, values[i]) != & values[i]) || IntegerTree->contains(tree, values[i] + 1))
+            break;
+
+    if (! keysAreInOrder(tree, 1000))
+        i = -1;
+
+    IntegerTree->destructor(& tree);
+    IntegerTree->useVectorInstructions(1);
+
+    return i;
+}
+
+
+
+
+Test(integer_tree, constructor_allocates_memory)
+{
+    // when creating an instance
+    _IntegerTree * instance = IntegerTree->constructor();
+
+    // then it shouldn't be null
+    cr_assert_not_null(
+        instance,
+        "Constructor should allocate memory"
+    );
+}
+
+
+Test(integer_tree, constructor_creates_an_empty_tree)
+{
+    // when creating an instance
+    _IntegerTree * instance = IntegerTree->constructor();
+
+    // then it should have no key
+    cr_assert_eq(
+        0,
+        IntegerTree->size(instance),
+        "Tree should be empty"
+    );
+    cr_assert_eq(
+        0,
+        IntegerTree->height(instance),
+        "Empty tree should have no height"
+    );
+    cr_assert_null(
+        IntegerTree->find(instance, 0),
+        "Empty tree shouldn't find anything"
+    );
+}
+
+
+Test(integer_tree, destructor_sets_to_null)
+{
+    // given a tree holding keys
+    _IntegerTree * tree = IntegerTree->constructor();
+    IntegerTree->add(tree, 1, "a");
+    IntegerTree->add(tree, 2, "b");
+
+    // when destroying it
+    IntegerTree->destructor(& tree);
+
+    // then it should be set to null
+    cr_assert_null(
+        tree,
+        "Destructor should set the tree to NULL"
+    );
+}
+
+
+Test(integer_tree, finds_added_keys_with_vector_instructions)
+{
+    // given a tree of 1000 shuffled keys, compared with vector instructions
+    // when finding each of them
+    int found = findShuffledKeys(1);
+
+    // then they should all be found, in order
+    cr_assert_eq(
+        1000,
+        found,
+        "Every added key should be found, and mapped in order"
+    );
+}
+
+
+Test(integer_tree, finds_added_keys_one_by_one)
+{
+    // given a tree of 1000 shuffled keys, compared one by one
+    // when finding each of them
+    int found = findShuffledKeys(0);
+
+    // then they should all be found, in order
+    cr_assert_eq(
+        1000,
+        found,
+        "Every added key should be found, and mapped in order"
+    );
+}
+
+
+Test(integer_tree, finds_extreme_keys)
+{
+    // given a tree holding the smallest and greatest integers
+    _IntegerTree * tree = IntegerTree->constructor();
+    int i;
+    for (i = -50; i < 50; i++)
+        IntegerTree->add(tree, i, "middle");
+    IntegerTree->add(tree, INT_MIN, "min");
+    IntegerTree->add(tree, INT_MAX, "max");
+
+    // when finding them
+    char const * min = IntegerTree->find(tree, INT_MIN);
+    char const * max = IntegerTree->find(tree, INT_MAX);
+
+    // then they should be found
+    cr_assert_str_eq(
+        "min",
+        min,
+        "Smallest integer should be found"
+    );
+    cr_assert_str_eq(
+        "max",
+        max,
+        "Greatest integer should be found"
+    );
+}
+
+
+Test(integer_tree, keeps_equal_keys)
+{
+    // given a tree
+    _IntegerTree * tree = IntegerTree->constructor();
+    int i;
+
+    // when adding the same key many times
+    for (i = 0; i < 100; i++)
+        IntegerTree->add(tree, 7, "a");
+
+    // then they should all be kept
+    cr_assert_eq(
+        100,
+        IntegerTree->size(tree),
+        "Equal keys should all be added"
+    );
+    cr_assert_str_eq(
+        "a",
+        IntegerTree->find(tree, 7),
+        "Equal keys should be found"
+    );
+}
+
+
+Test(integer_tree, nodes_are_wide)
+{
+    // given a tree
+    static int values[10000];
+    int i;
+    _IntegerTree * tree = IntegerTree->constructor();
+
+    // when adding sorted keys
+    for (i = 0; i < 10000; i++)
+    {
+        values[i] = i;
+        IntegerTree->add(tree, i, & values[i]);
+    }
+
+    // then the tree should be far lower than a binary one, even with half full nodes
+    cr_assert_leq(
+        IntegerTree->height(tree),
+        5,
+        "10000 keys should fit in 5 levels of nodes"
+    );
+}
+
+
+Test(integer_tree, pop_removes_keys)
+{
+    // given a tree of 1000 shuffled keys
+    static int values[1000];
+    int i, popped;
+    _IntegerTree * tree = IntegerTree->constructor();
+    for (i = 0; i < 1000; i++)
+    {
+        values[i] = (i * 379) % 1000;
+        IntegerTree->add(tree, values[i], & values[i]);
+    }
+
+    // when popping every other key, in another order
+    for (i = 0, popped = 0; i < 1000; i++)
+        if ((values[(i * 37) % 1000] % 2 == 0) && (IntegerTree->pop(tree, values[(i * 37) % 1000]) == & values[(i * 37) % 1000]))
+            popped++;
+
+    // then only the other keys should be left, in order
+    for (i = 0; i < 1000; i++)
+        if (IntegerTree->contains(tree, values[i]) != (values[i] % 2))
+            break;
+    cr_assert_eq(
+        500,
+        popped,
+        "Every popped key should return its value"
+    );
+    cr_assert_eq(
+        1000,
+        i,
+        "Only keys which weren't popped should be left"
+    );
+    cr_assert_eq(
+        1,
+        keysAreInOrder(tree, 500),
+        "Keys left should be mapped in order"
+    );
+}
+
+
+Test(integer_tree, popping_every_key_empties_the_tree)
+{
+    // given a tree of 300 keys
+    int i;
+    _IntegerTree * tree = IntegerTree->constructor();
+    for (i = 0; i < 300; i++)
+        IntegerTree->add(tree, i, "a");
+
+    // when popping them all
+    for (i = 0; i < 300; i++)
+        IntegerTree->pop(tree, (i * 7) % 300);
+
+    // then the tree should be empty
+    cr_assert_eq(
+        0,
+        IntegerTree->size(tree),
+        "Tree should be empty"
+    );
+    cr_assert_eq(
+        0,
+        IntegerTree->height(tree),
+        "Empty tree should have no height"
+    );
+}
+
+
+Test(integer_tree, popping_missing_key_returns_null)
+{
+    // given a tree
+    _IntegerTree * tree = IntegerTree->constructor();
+    IntegerTree->add(tree, 1, "a");
+
+    // when popping a key which isn't in it
+    void const * popped = IntegerTree->pop(tree, 2);
+
+    // then nothing should be popped
+    cr_assert_null(
+        popped,
+        "Missing key shouldn't be popped"
+    );
+    cr_assert_eq(
+        1,
+        IntegerTree->size(tree),
+        "Size shouldn't change"
+    );
+}
@@ -0,0 +1,344 @@
+
+#include <stdio.h>
+#include <string.h>
+#include <criterion/criterion.h>
+#include <criterion/redirect.h>
+
+#include "../../src/IntrusiveTree.h"
+
+
+
+
+/**
+ * An entry of a session table, indexed by its identifier through the links it embeds
+ */
+typedef struct
+{
+    int identifier;
+    char name[16];
+    IntrusiveTreeLinks links;
+} Session;
+
+
+static int compareSessions(IntrusiveTreeLinks const * const current, IntrusiveTreeLinks const * const other)
+{
+    int currentIdentifier = INTRUSIVE_TREE_ENTRY(current, Session, links)->identifier;
+    int otherIdentifier = INTRUSIVE_TREE_ENTRY(other, Session, links)->identifier;
+
+    return (currentIdentifier > otherIdentifier) - (currentIdentifier < otherIdentifier);
+}
+
+
+static Session * findSession(_IntrusiveTree const * const tree, int identifier)
+{
+    Session probe;
+    IntrusiveTreeLinks * links;
+
+    probe.identifier = identifier;
+    links = IntrusiveTree->find(tree, & probe.links);
+
+    return (links == NULL) ? NULL : INTRUSIVE_TREE_ENTRY(links, Session, links);
+}
+
+
+/**
+ * @return - the number of black nodes on every path from the node down, or -1 if paths differ or a red node has a red son
+ */
+static int blackHeight(IntrusiveTreeLinks const * const node)
+{
+    int leftHeight, rightHeight;
+
+    if (node == NULL)
+        return 1;
+
+    if (node->isRed && (((node->leftNode != NULL) && node->leftNode->isRed) || ((node->rightNode != NULL) && node->rightNode->isRed)))
+        return -1;
+
+    leftHeight = blackHeight(node->leftNode);
+    rightHeight = blackHeight(node->rightNode);
+    if ((leftHeight < 0) || (leftHeight != rightHeight))
+        return -1;
+
+    return leftHeight + ! node->isRed;
+}
+
+
+/**
+ * @return - the links of the top-most entry, or NULL if tree is empty
+ */
+static IntrusiveTreeLinks const * rootOf(_IntrusiveTree const * const tree)
+{
+    IntrusiveTreeLinks const * links = IntrusiveTree->min(tree);
+
+    while ((links != NULL) && (links->parent != NULL))
+        links = links->parent;
+
+    return links;
+}
+
+
+static int previousMappedIdentifier;
+static int mappedSessionsAreInOrder;
+static unsigned int mappedSessions;
+
+
+static void checkSessionOrderCallback(IntrusiveTreeLinks * const links)
+{
+    int identifier = INTRUSIVE_TREE_ENTRY(links, Session, links)->identifier;
+
+    if ((mappedSessions > 0) && (identifier < previousMappedIdentifier))
+        mappedSessionsAreInOrder = 0;
+
+    previousMappedIdentifier = identifier;
+    mappedSessions++;
+}
+
+
+/**
+ * @return - 1 if mapping the tree meets count sessions in order, 0 otherwise
+ */
+static int sessionsAreInOrder(_IntrusiveTree const * const tree, unsigned int count)
+{
+    mappedSessionsAreInOrder = 1;
+    mappedSessions = 0;
+
+    IntrusiveTree->map(tree, checkSessionOrderCallback);
+
+    return mappedSessionsAreInOrder && (mappedSessions == count);
+}
+
+
+
+
+Test(intrusive_tree, constructor_creates_an_empty_tree)
+{
+    // when creating an instance
+    _IntrusiveTree * instance = IntrusiveTree->constructor(compareSessions);
+
+    // then it should have no entry
+    cr_assert_not_null(
+        instance,
+        "Constructor should allocate memory"
+    );
+    cr_assert_eq(
+        0,
+        IntrusiveTree->size(instance),
+        "Tree should be empty"
+    );
+    cr_assert_null(
+        IntrusiveTree->min(instance),
+        "Empty tree should have no min"
+    );
+}
+
+
+Test(intrusive_tree, destructor_leaves_entries_alone)
+{
+    // given a tree linking a session
+    _IntrusiveTree * tree = IntrusiveTree->constructor(compareSessions);
+    Session session;
+    session.identifier = 1;
+    strcpy(session.name, "alice");
+    IntrusiveTree->add(tree, & session.links);
+
+    // when destroying it
+    IntrusiveTree->destructor(& tree);
+
+    // then it should be set to null, and the session kept
+    cr_assert_null(
+        tree,
+        "Destructor should set the tree to NULL"
+    );
+    cr_assert_str_eq(
+        "alice",
+        session.name,
+        "Entries should be left as they are"
+    );
+}
+
+
+Test(intrusive_tree, finds_the_entries_themselves)
+{
+    // given a tree of 1000 shuffled sessions
+    static Session sessions[1000];
+    int i;
+    _IntrusiveTree * tree = IntrusiveTree->constructor(compareSessions);
+    for (i = 0; i < 1000; i++)
+    {
+        sessions[i].identifier = 2 * ((i * 379) % 1000);
+        IntrusiveTree->add(tree, & sessions[i].links);
+    }
+
+    // when finding each of them, and the odd identifiers between them
+    for (i = 0; i < 1000; i++)
+        if ((findSession(tree, sessions[i].identifier) != & sessions[i]) || (findSession(tree, sessions[i].identifier + 1) != NULL))
+            break;
+
+    // then the very entries should be found, in order
+    cr_assert_eq(
+        1000,
+        i,
+        "Every added entry should be found, and only them"
+    );
+    cr_assert_eq(
+        1,
+        sessionsAreInOrder(tree, 1000),
+        "Entries should be mapped in order"
+    );
+}
+
+
+Test(intrusive_tree, adding_keeps_red_black_invariants)
+{
+    // given a tree
+    static Session sessions[4096];
+    int i;
+    _IntrusiveTree * tree = IntrusiveTree->constructor(compareSessions);
+
+    // when adding sorted sessions, the worst case for an unbalanced tree
+    for (i = 0; i < 4096; i++)
+    {
+        sessions[i].identifier = i;
+        IntrusiveTree->add(tree, & sessions[i].links);
+    }
+
+    // then it should stay balanced
+    cr_assert_gt(
+        blackHeight(rootOf(tree)),
+        -1,
+        "Red-black invariants should hold"
+    );
+    cr_assert_leq(
+        IntrusiveTree->height(tree),
+        24,
+        "Height should stay within twice the logarithm of the size"
+    );
+}
+
+
+Test(intrusive_tree, removing_keeps_red_black_invariants)
+{
+    // given a tree of 1000 shuffled sessions
+    static Session sessions[1000];
+    int i;
+    _IntrusiveTree * tree = IntrusiveTree->constructor(compareSessions);
+    for (i = 0; i < 1000; i++)
+    {
+        sessions[i].identifier = (i * 379) % 1000;
+        IntrusiveTree->add(tree, & sessions[i].links);
+    }
+
+    // when removing every even session, in another order
+    for (i = 0; i < 1000; i++)
+        if (sessions[(i * 37) % 1000].identifier % 2 == 0)
+            IntrusiveTree->remove(tree, & sessions[(i * 37) % 1000].links);
+
+    // then only odd sessions should be left, in order and balanced
+    for (i = 0; i < 1000; i++)
+        if ((findSession(tree, i) != NULL) != (i % 2))
+            break;
+    cr_assert_eq(
+        1000,
+        i,
+        "Only sessions which weren't removed should be left"
+    );
+    cr_assert_eq(
+        1,
+        sessionsAreInOrder(tree, 500),
+        "Sessions left should be mapped in order"
+    );
+    cr_assert_gt(
+        blackHeight(rootOf(tree)),
+        -1,
+        "Red-black invariants should hold"
+    );
+}
+
+
+Test(intrusive_tree, removed_entries_can_be_added_again)
+{
+    // given a session removed from a tree
+    _IntrusiveTree * tree = IntrusiveTree->constructor(compareSessions);
+    _IntrusiveTree * other = IntrusiveTree->constructor(compareSessions);
+    Session session;
+    session.identifier = 7;
+    IntrusiveTree->add(tree, & session.links);
+    IntrusiveTree->remove(tree, & session.links);
+
+    // when adding it to another tree
+    IntrusiveTree->add(other, & session.links);
+
+    // then it should only be found in that one
+    cr_assert_null(
+        findSession(tree, 7),
+        "Removed session shouldn't be found"
+    );
+    cr_assert_eq(
+        & session,
+        findSession(other, 7),
+        "Session should be found in the other tree"
+    );
+}
+
+
+Test(intrusive_tree, pop_unlinks_an_equal_entry)
+{
+    // given a tree of sessions
+    static Session sessions[10];
+    Session probe;
+    IntrusiveTreeLinks * popped;
+    int i;
+    _IntrusiveTree * tree = IntrusiveTree->constructor(compareSessions);
+    for (i = 0; i < 10; i++)
+    {
+        sessions[i].identifier = i;
+        IntrusiveTree->add(tree, & sessions[i].links);
+    }
+
+    // when popping one by a probe
+    probe.identifier = 4;
+    popped = IntrusiveTree->pop(tree, & probe.links);
+
+    // then the session should be returned and unlinked
+    cr_assert_eq(
+        & sessions[4],
+        INTRUSIVE_TREE_ENTRY(popped, Session, links),
+        "Popped session should be returned"
+    );
+    cr_assert_eq(
+        9,
+        IntrusiveTree->size(tree),
+        "Size should decrease"
+    );
+    cr_assert_null(
+        IntrusiveTree->pop(tree, & probe.links),
+        "Missing session shouldn't be popped"
+    );
+}
+
+
+Test(intrusive_tree, next_and_previous_walk_the_entries)
+{
+    // given a tree of shuffled sessions
+    static Session sessions[100];
+    IntrusiveTreeLinks * links;
+    int i, walked = 0;
+    _IntrusiveTree * tree = IntrusiveTree->constructor(compareSessions);
+    for (i = 0; i < 100; i++)
+    {
+        sessions[i].identifier = (i * 37) % 100;
+        IntrusiveTree->add(tree, & sessions[i].links);
+    }
+
+    // when walking from the greatest to the smallest one
+    for (links = IntrusiveTree->max(tree); links != NULL; links = IntrusiveTree->previous(links))
+        if (INTRUSIVE_TREE_ENTRY(links, Session, links)->identifier == 99 - walked)
+            walked++;
+
+    // then every session should be met in order
+    cr_assert_eq(
+        100,
+        walked,
+        "Every session should be met, in reverse order"
+    );
+}
@@ -0,0 +1,250 @@
+#include <stdio.h>
+#include <string.h>
+#include <criterion/criterion.h>
+#include <criterion/redirect.h>
+
+#include "../../src/Pool.h"
+
+
+
+
+Test(pool, constructor_allocates_memory)
+{
+    // when creating an instance
+    _Pool * instance = Pool->constructor(32);
+
+    // then it shouldn't be null
+    cr_assert_not_null(
+        instance,
+        "Constructor should allocate memory"
+    );
+}
+
+
+Test(pool, destructor_doesnt_crash_when_pool_is_null)
+{
+    // given a null pool
+    _Pool * pool = NULL;
+
+    // when deleting it
+    Pool->destructor(& pool);
+
+    // then it shouldn't crash
+}
+
+
+Test(pool, destructor_frees_memory)
+{
+    // given a pool which handed out blocks
+    _Pool * pool = Pool->constructor(32);
+    Pool->allocate(pool);
+    Pool->allocate(pool);
+
+    // when deleting it
+    Pool->destructor(& pool);
+
+    // then it should be null
+    cr_assert_null(
+        pool,
+        "Destructor should free the pool memory"
+    );
+}
+
+
+Test(pool, block_size_is_aligned)
+{
+    // given a pool of odd-sized blocks
+    _Pool * pool = Pool->constructor(13);
+
+    // when checking the size of its blocks
+    unsigned int blockSize = Pool->blockSize(pool);
+
+    // then it should be large enough and aligned for pointers
+    cr_assert_eq(
+        1,
+        (blockSize >= 13) && (blockSize % sizeof(void *) == 0),
+        "Block size should be rounded up to the alignment, got %u", blockSize
+    );
+}
+
+
+Test(pool, allocated_blocks_are_distinct_and_contiguous)
+{
+    // given a pool
+    _Pool * pool = Pool->constructor(32);
+
+    // when allocating 2 blocks
+    char * first = Pool->allocate(pool);
+    char * second = Pool->allocate(pool);
+
+    // then they should be next to each other
+    cr_assert_eq(
+        first + Pool->blockSize(pool),
+        second,
+        "Blocks should be carved one after the other from the same chunk"
+    );
+}
+
+
+Test(pool, released_block_is_reused)
+{
+    // given a pool which handed out a block, then got it back
+    _Pool * pool = Pool->constructor(32);
+    void * block = Pool->allocate(pool);
+    Pool->allocate(pool);
+    Pool->release(pool, block);
+
+    // when allocating another block
+    void * reused = Pool->allocate(pool);
+
+    // then it should be the released one
+    cr_assert_eq(
+        block,
+        reused,
+        "Released blocks should be reused first"
+    );
+    cr_assert_eq(
+        1,
+        Pool->statistics(pool).reuses,
+        "Reusing a block should be counted"
+    );
+}
+
+
+Test(pool, statistics_count_allocations_and_releases)
+{
+    // given a pool
+    _Pool * pool = Pool->constructor(32);
+
+    // when allocating 3 blocks and releasing 1
+    Pool->allocate(pool);
+    Pool->allocate(pool);
+    Pool->release(pool, Pool->allocate(pool));
+
+    // then counters should match
+    PoolStatistics statistics = Pool->statistics(pool);
+    cr_assert_eq(
+        3,
+        statistics.allocations,
+        "Allocations should be counted"
+    );
+    cr_assert_eq(
+        1,
+        statistics.releases,
+        "Releases should be counted"
+    );
+    cr_assert_eq(
+        1,
+        statistics.chunks,
+        "Few blocks should fit in a single chunk"
+    );
+}
+
+
+Test(pool, requests_new_chunks_when_full)
+{
+    // given a pool of large blocks
+    _Pool * pool = Pool->constructor(40000);
+
+    // when allocating more blocks than a chunk can hold
+    Pool->allocate(pool);
+    Pool->allocate(pool);
+
+    // then another chunk should be requested
+    cr_assert_eq(
+        2,
+        Pool->statistics(pool).chunks,
+        "A new chunk should be requested once the current one is full"
+    );
+}
+
+
+Test(pool, null_pool_has_no_statistics)
+{
+    // given a null pool
+    _Pool * pool = NULL;
+
+    // when getting its counters
+    PoolStatistics statistics = Pool->statistics(pool);
+
+    // then they should all be 0
+    cr_assert_eq(
+        0,
+        statistics.allocations + statistics.releases + statistics.reuses + statistics.chunks,
+        "Null pool should have no counters"
+    );
+}
+
+
+Test(pool, reserved_blocks_are_contiguous)
+{
+    // given a pool which started a chunk
+    _Pool * pool = Pool->constructor(32);
+    Pool->allocate(pool);
+
+    // when reserving more blocks than a chunk holds, then allocating them
+    int reserved = Pool->reserve(pool, 10000);
+    char * first = Pool->allocate(pool);
+    char * last = first;
+    int i;
+    for (i = 1; i < 10000; i++)
+        last = Pool->allocate(pool);
+
+    // then they should all come from a single new chunk
+    cr_assert_eq(
+        1,
+        reserved,
+        "Reserving blocks should succeed"
+    );
+    cr_assert_eq(
+        first + 9999 * Pool->blockSize(pool),
+        last,
+        "Reserved blocks should follow each other"
+    );
+    cr_assert_eq(
+        2,
+        Pool->statistics(pool).chunks,
+        "A single chunk should hold the reserved blocks"
+    );
+}
+
+
+Test(pool, reserving_available_blocks_requests_no_chunk)
+{
+    // given a pool which started a chunk
+    _Pool * pool = Pool->constructor(32);
+    Pool->allocate(pool);
+
+    // when reserving fewer blocks than the chunk has left
+    Pool->reserve(pool, 10);
+
+    // then no chunk should be requested
+    cr_assert_eq(
+        1,
+        Pool->statistics(pool).chunks,
+        "The current chunk should be kept when it has enough blocks left"
+    );
+}
+
+
+Test(pool, cache_line_sized_blocks_start_on_cache_lines)
+{
+    // given a pool of blocks as large as two cache lines
+    _Pool * pool = Pool->constructor(128);
+
+    // when handing out blocks
+    char * first = Pool->allocate(pool);
+    char * second = Pool->allocate(pool);
+
+    // then they should start on cache lines
+    cr_assert_eq(
+        0,
+        (unsigned long) first % 64,
+        "First block should start on a cache line"
+    );
+    cr_assert_eq(
+        0,
+        (unsigned long) second % 64,
+        "Second block should start on a cache line"
+    );
+}
@@ -0,0 +1,114 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <criterion/criterion.h>
+#include <criterion/redirect.h>
+
+#include "../../src/Sort.h"
+
+#define TREE_NODE_COMPARISON_CALLBACK_TYPE int (*)(void const * const, void const * const)
+#define TO_NODE_COMPARISON_CALLBACK(function) ((TREE_NODE_COMPARISON_CALLBACK_TYPE) function)
+#define STRING_NODE_COMPARISON_CALLBACK TO_NODE_COMPARISON_CALLBACK(strcmp)
+
+
+
+
+static int integerComparisonCallback(int const * const current, int const * const other)
+{
+    return (* current > * other) - (* current < * other);
+}
+
+
+
+
+Test(sort, sorts_values)
+{
+    // given shuffled values
+    static int integers[1000];
+    static void const * values[1000];
+    int i;
+    for (i = 0; i < 1000; i++)
+    {
+        integers[i] = (i * 379) % 1000;
+        values[i] = & integers[i];
+    }
+
+    // when sorting them
+    int sorted = Sort->values(values, 1000, TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback));
+
+    // then they should be in order
+    for (i = 0; i < 1000; i++)
+        if (* (int const *) values[i] != i)
+            break;
+    cr_assert_eq(
+        1,
+        sorted,
+        "Sorting should succeed"
+    );
+    cr_assert_eq(
+        1000,
+        i,
+        "Values should be in order"
+    );
+}
+
+
+Test(sort, keeps_order_of_equal_values)
+{
+    // given equal values, surrounded by other ones
+    static int integers[] = { 3, 1, 2, 1, 0, 1 };
+    static void const * values[6];
+    int i;
+    for (i = 0; i < 6; i++)
+        values[i] = & integers[i];
+
+    // when sorting them
+    Sort->values(values, 6, TO_NODE_COMPARISON_CALLBACK(integerComparisonCallback));
+
+    // then equal values should stay in their order
+    static int const expectedOrder[] = { 4, 1, 3, 5, 2, 0 };
+    for (i = 0; i < 6; i++)
+        if (values[i] != & integers[expectedOrder[i]])
+            break;
+    cr_assert_eq(
+        6,
+        i,
+        "Equal values should keep their order"
+    );
+}
+
+
+Test(sort, sorts_strings)
+{
+    // given shuffled strings
+    static void const * values[] = { "delta", "alpha", "charlie", "bravo" };
+
+    // when sorting them
+    Sort->values(values, 4, STRING_NODE_COMPARISON_CALLBACK);
+
+    // then they should be in order
+    cr_assert_str_eq(
+        values[0],
+        "alpha",
+        "First string should be the smallest one"
+    );
+    cr_assert_str_eq(
+        values[3],
+        "delta",
+        "Last string should be the greatest one"
+    );
+}
+
+
+Test(sort, sorting_nothing_succeeds)
+{
+    // when sorting no value
+    int sorted = Sort->values(NULL, 0, STRING_NODE_COMPARISON_CALLBACK);
+
+    // then it should succeed
+    cr_assert_eq(
+        1,
+        sorted,
+        "Sorting no value should succeed"
+    );
+}
@@ -0,0 +1,286 @@
+
+#include <stdio.h>
+#include <string.h>
+#include <criterion/criterion.h>
+#include <criterion/redirect.h>
+
+#include "../../src/TypedBinaryTree.h"
+
+DECLARE_BINARY_TREE(IntegerBinaryTree, int);
+DEFINE_BINARY_TREE(IntegerBinaryTree, int, COMPARE_NUMBERS);
+
+DECLARE_BINARY_TREE(StringBinaryTree, char const *);
+DEFINE_BINARY_TREE(StringBinaryTree, char const *, strcmp);
+
+
+
+
+static int previousMappedKey;
+static int mappedKeysAreInOrder;
+static unsigned int mappedKeys;
+
+
+static void checkKeyOrderCallback(int key)
+{
+    if ((mappedKeys > 0) && (key < previousMappedKey))
+        mappedKeysAreInOrder = 0;
+
+    previousMappedKey = key;
+    mappedKeys++;
+}
+
+
+/**
+ * @return - 1 if mapping the tree meets count keys in order, 0 otherwise
+ */
+static int keysAreInOrder(_IntegerBinaryTree const * const tree, unsigned int count)
+{
+    mappedKeysAreInOrder = 1;
+    mappedKeys = 0;
+
+    IntegerBinaryTree->map(tree, checkKeyOrderCallback);
+
+    return mappedKeysAreInOrder && (mappedKeys == count);
+}
+
+
+
+
+Test(typed_binary_tree, constructor_allocates_memory)
+{
+    // when creating an instance
+    _IntegerBinaryTree * instance = IntegerBinaryTree->constructor();
+
+    // then it shouldn't be null
+    cr_assert_not_null(
+        instance,
+        "Constructor should allocate memory"
+    );
+}
+
+
+Test(typed_binary_tree, constructor_creates_an_empty_tree)
+{
+    // when creating an instance
+    _IntegerBinaryTree * instance = IntegerBinaryTree->constructor();
+
+    // then it should have no key
+    cr_assert_eq(
+        0,
+        IntegerBinaryTree->size(instance),
+        "Tree should be empty"
+    );
+    cr_assert_eq(
+        0,
+        IntegerBinaryTree->height(instance),
+        "Empty tree should have no height"
+    );
+    cr_assert_null(
+        IntegerBinaryTree->min(instance),
+        "Empty tree should have no min"
+    );
+}
+
+
+Test(typed_binary_tree, destructor_sets_to_null)
+{
+    // given a tree holding keys
+    _IntegerBinaryTree * tree = IntegerBinaryTree->constructor();
+    IntegerBinaryTree->add(tree, 1);
+    IntegerBinaryTree->add(tree, 2);
+
+    // when destroying it
+    IntegerBinaryTree->destructor(& tree);
+
+    // then it should be set to null
+    cr_assert_null(
+        tree,
+        "Destructor should set the tree to NULL"
+    );
+}
+
+
+Test(typed_binary_tree, finds_added_keys)
+{
+    // given a tree of 1000 shuffled keys
+    int i;
+    _IntegerBinaryTree * tree = IntegerBinaryTree->constructor();
+    for (i = 0; i < 1000; i++)
+        IntegerBinaryTree->add(tree, 2 * ((i * 379) % 1000));
+
+    // when finding each of them, and the odd keys between them
+    for (i = 0; i < 1000; i++)
+        if ((IntegerBinaryTree->key(IntegerBinaryTree->find(tree, 2 * i)) != 2 * i) || IntegerBinaryTree->contains(tree, 2 * i + 1))
+            break;
+
+    // then they should all be found, in order, and the odd ones shouldn't
+    cr_assert_eq(
+        1000,
+        i,
+        "Every added key should be found, and only them"
+    );
+    cr_assert_eq(
+        1,
+        keysAreInOrder(tree, 1000),
+        "Keys should be mapped in order"
+    );
+}
+
+
+Test(typed_binary_tree, compares_keys_with_a_function)
+{
+    // given a tree of strings compared with strcmp
+    _StringBinaryTree * tree = StringBinaryTree->constructor();
+    StringBinaryTree->add(tree, "banana");
+    StringBinaryTree->add(tree, "cherry");
+    StringBinaryTree->add(tree, "apple");
+
+    // when getting its bounds
+    char const * min = StringBinaryTree->key(StringBinaryTree->min(tree));
+    char const * max = StringBinaryTree->key(StringBinaryTree->max(tree));
+
+    // then they should be ordered by the function
+    cr_assert_str_eq(
+        "apple",
+        min,
+        "Min should be the first string"
+    );
+    cr_assert_str_eq(
+        "cherry",
+        max,
+        "Max should be the last string"
+    );
+    cr_assert_eq(
+        1,
+        StringBinaryTree->contains(tree, "banana"),
+        "An equal string should be found"
+    );
+}
+
+
+Test(typed_binary_tree, keeps_equal_keys_in_order_of_addition)
+{
+    // given a tree
+    _IntegerBinaryTree * tree = IntegerBinaryTree->constructor();
+    _IntegerBinaryTreeNode * first, * second;
+
+    // when adding the same key twice
+    first = IntegerBinaryTree->add(tree, 7);
+    second = IntegerBinaryTree->add(tree, 7);
+
+    // then the first one should be found, and followed by the second one
+    cr_assert_eq(
+        first,
+        IntegerBinaryTree->find(tree, 7),
+        "First equal key should be found"
+    );
+    cr_assert_eq(
+        second,
+        IntegerBinaryTree->next(first),
+        "Equal keys should follow the order of addition"
+    );
+}
+
+
+Test(typed_binary_tree, next_and_previous_walk_the_keys)
+{
+    // given a tree of shuffled keys
+    int i, walked = 0;
+    _IntegerBinaryTreeNode * node;
+    _IntegerBinaryTree * tree = IntegerBinaryTree->constructor();
+    for (i = 0; i < 100; i++)
+        IntegerBinaryTree->add(tree, (i * 37) % 100);
+
+    // when walking from the greatest to the smallest one
+    for (node = IntegerBinaryTree->max(tree); node != NULL; node = IntegerBinaryTree->previous(node))
+        if (IntegerBinaryTree->key(node) == 99 - walked)
+            walked++;
+
+    // then every key should be met in order
+    cr_assert_eq(
+        100,
+        walked,
+        "Every key should be met, in reverse order"
+    );
+}
+
+
+Test(typed_binary_tree, height_of_sorted_keys_is_their_count)
+{
+    // given a tree
+    int i;
+    _IntegerBinaryTree * tree = IntegerBinaryTree->constructor();
+
+    // when adding sorted keys, which the tree doesn't balance
+    for (i = 0; i < 100000; i++)
+        IntegerBinaryTree->add(tree, i);
+
+    // then it should be as high as there are keys, and measured without running out of stack
+    cr_assert_eq(
+        100000,
+        IntegerBinaryTree->height(tree),
+        "Sorted keys should make a single branch"
+    );
+    IntegerBinaryTree->destructor(& tree);
+}
+
+
+Test(typed_binary_tree, pop_removes_keys)
+{
+    // given a tree of 1000 shuffled keys
+    int i, key, popped;
+    _IntegerBinaryTree * tree = IntegerBinaryTree->constructor();
+    for (i = 0; i < 1000; i++)
+        IntegerBinaryTree->add(tree, (i * 379) % 1000);
+
+    // when popping every other key, in another order
+    for (i = 0, popped = 0; i < 1000; i++)
+    {
+        key = (i * 37) % 1000;
+        if ((key % 2 == 0) && IntegerBinaryTree->pop(tree, key))
+            popped++;
+    }
+
+    // then only the other keys should be left, in order
+    for (i = 0; i < 1000; i++)
+        if (IntegerBinaryTree->contains(tree, i) != (i % 2))
+            break;
+    cr_assert_eq(
+        500,
+        popped,
+        "Every even key should be popped"
+    );
+    cr_assert_eq(
+        1000,
+        i,
+        "Only keys which weren't popped should be left"
+    );
+    cr_assert_eq(
+        1,
+        keysAreInOrder(tree, 500),
+        "Keys left should be mapped in order"
+    );
+}
+
+
+Test(typed_binary_tree, popping_missing_key_returns_0)
+{
+    // given a tree
+    _IntegerBinaryTree * tree = IntegerBinaryTree->constructor();
+    IntegerBinaryTree->add(tree, 1);
+
+    // when popping a key which isn't in it
+    int popped = IntegerBinaryTree->pop(tree, 2);
+
+    // then nothing should be popped
+    cr_assert_eq(
+        0,
+        popped,
+        "Missing key shouldn't be popped"
+    );
+    cr_assert_eq(
+        1,
+        IntegerBinaryTree->size(tree),
+        "Size shouldn't change"
+    );
+}